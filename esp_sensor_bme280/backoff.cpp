@@ -0,0 +1,27 @@
+#include "backoff.h"
+
+Backoff::Backoff(uint32_t minIntervalMs, uint32_t maxIntervalMs)
+  : m_minIntervalMs(minIntervalMs)
+  , m_maxIntervalMs(maxIntervalMs)
+  , m_intervalMs(minIntervalMs)
+{
+}
+
+bool Backoff::IsDue(uint32_t now) const
+{
+  return m_failures == 0 || now - m_lastAttempt >= m_intervalMs;
+}
+
+void Backoff::OnFailed(uint32_t now)
+{
+  if (m_failures != 0)
+    m_intervalMs = (m_intervalMs < m_maxIntervalMs / 2 ? m_intervalMs * 2 : m_maxIntervalMs);
+  m_lastAttempt = now;
+  ++m_failures;
+}
+
+void Backoff::Reset()
+{
+  m_intervalMs = m_minIntervalMs;
+  m_failures = 0;
+}
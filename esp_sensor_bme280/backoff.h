@@ -0,0 +1,23 @@
+#pragma once
+
+#include <cstdint>
+
+class Backoff
+{
+public:
+  Backoff(uint32_t minIntervalMs, uint32_t maxIntervalMs);
+
+  bool IsDue(uint32_t now) const;
+  void OnFailed(uint32_t now);
+  void Reset();
+
+  uint32_t GetFailures() const { return m_failures; }
+  uint32_t GetIntervalMs() const { return m_intervalMs; }
+
+private:
+  uint32_t m_minIntervalMs;
+  uint32_t m_maxIntervalMs;
+  uint32_t m_intervalMs;
+  uint32_t m_lastAttempt = 0;
+  uint32_t m_failures = 0;
+};
@@ -1,21 +1,78 @@
 #include "pass.h"
+#include "scheduler.h"
+#include "sample_record.h"
+#include "report_policy.h"
+#include "rtc_batch.h"
+#include "sample_queue.h"
+#include "spiffs_storage.h"
+#include "backoff.h"
+#include "wifi_join.h"
 
 #include <BME280I2C.h>
 #include <PubSubClient.h>
 #include <ESP8266WiFi.h>
 
+//https://bblanchon.github.io/ArduinoJson/
+#include <ArduinoJson.h>
+
 const char* MqttServer = "192.168.0.3";
 const uint16_t MqttPort = 1883;
 
-const char* DeviceId7 = "unit1_device1";
+const char* DeviceId = "unit1_device1";
+constexpr uint8_t DeviceNumber = 1;
 const char* ResetTopic = "unit1/device1/reset/action";
 constexpr const char *Sensor1 = "unit1/device1/sensor1/status";
 constexpr const char *Sensor2 = "unit1/device1/sensor2/status";
 constexpr const char *Sensor3 = "unit1/device1/sensor3/status";
 constexpr const char *Error = "unit1/device1/error/status";
 constexpr const char *Hello = "unit1/device1/hello/status";
+constexpr const char *WiFiTime = "unit1/device1/wifi/status";
+constexpr const char *Sample = "unit1/device1/sample";
+//min/mean/max of each sensor over the window since the previous report
+constexpr const char *Stats[] = {"unit1/device1/sensor1/stats", "unit1/device1/sensor2/stats", "unit1/device1/sensor3/stats"};
+
+//Also publish the per-sensor text topics for older displays
+constexpr bool PublishTextTopics = false;
+
+constexpr uint32_t SampleIntervalMs = 250;
+//Deadbands for temperature ('C), humidity (% RH) and pressure (mm Hg)
+constexpr ReportConfig ReportSettings{{0.2, 1.0, 0.3}, 60 * 1000, 1000};
+
+//Duty-cycled battery mode, needs GPIO16 wired to RST
+constexpr bool DeepSleepMode = false;
+constexpr uint32_t SleepIntervalMs = 60 * 1000;
+constexpr uint32_t PublishEveryWakes = 10;
+constexpr uint32_t WiFiConnectTimeoutMs = 10 * 1000;
+constexpr uint32_t FastJoinTimeoutMs = 3000;
+//Added to the conversion time before a sensor that is not ready counts as failed
+constexpr uint32_t SensorReadyMarginMs = 10;
+
+//RTC user memory layout in 4-byte blocks
+constexpr uint32_t RtcBatchOffset = 0;
+constexpr uint32_t RtcWiFiJoinOffset = RtcBatchOffset + (sizeof(RtcState) + 3) / 4;
+static_assert((RtcWiFiJoinOffset * 4 + sizeof(WiFiJoinCache)) <= 512, "RTC user memory overflow");
+
+//Samples are queued while the broker is unreachable and replayed at a limited rate
+constexpr const char* SpillFileName = "/samples.bin";
+constexpr const char* SpillOffsetFileName = "/samples.pos";
+constexpr size_t MaxSpilledSamples = 2048;
+constexpr uint32_t ReplayIntervalMs = 250;
+//Keeps topic and records within the default PubSubClient packet size
+constexpr size_t ReplayBatchSize = 4;
+constexpr uint32_t ReconnectMinIntervalMs = 1000;
+constexpr uint32_t ReconnectMaxIntervalMs = 60 * 1000;
 
 void MqttCallback(char* topic, byte* payload, unsigned int length);
+void Measure();
+void Collect();
+void PublishSample(bool isError);
+void PublishText(bool isError);
+void PublishStats();
+void RunDutyCycle();
+void Replay();
+void PublishWiFiTime();
+void Sleep(SampleBatch& batch);
+uint32_t GetUptimeSec();
 
 WiFiClient espClient;
 PubSubClient mqtt(MqttServer, MqttPort, MqttCallback, espClient);
@@ -25,12 +82,29 @@ float temperature = NAN;
 float humidity = NAN;
 float pressure = NAN;
 uint32_t reconnectCounter = 0;
+uint32_t sampleSequence = 0;
+uint32_t measurementStartUs = 0;
+bool isMeasuring = false;
+
+Scheduler scheduler(millis);
+Task taskMeasure(Measure, SampleIntervalMs, 100);
+Task taskCollect(Collect, 0, 100);
+ReportPolicy reportPolicy(ReportSettings);
+RtcState rtcState;
+SpiffsStorage spillStorage(SpillFileName, SpillOffsetFileName);
+SampleQueue sampleQueue(&spillStorage, MaxSpilledSamples);
+Backoff mqttBackoff(ReconnectMinIntervalMs, ReconnectMaxIntervalMs);
+Task taskReplay(Replay, ReplayIntervalMs, 50);
+WiFiJoin wifiJoin(RtcWiFiJoinOffset, GetUptimeSec);
 
 void setup() 
 {
   Serial.begin(115200);
   while(!Serial) 
   {} // Wait
+  if (DeepSleepMode)
+    RunDutyCycle();
+
   while(!bme.begin(5, 4))
   {
     Serial.println("Could not find BME280 sensor on I2C bus!");
@@ -43,18 +117,24 @@ void setup()
   Serial.print("Connecting to ");
   Serial.println(ssid);
 
-  WiFi.begin(ssid, password);
-
-  while (WiFi.status() != WL_CONNECTED) 
+  while (!wifiJoin.Connect(ssid, password, FastJoinTimeoutMs, WiFiConnectTimeoutMs)) 
   {
-    delay(500);
     Serial.print(".");
   }
 
   Serial.println("");
-  Serial.println("WiFi connected");
+  Serial.print("WiFi connected in ");
+  Serial.print(wifiJoin.GetTimeToConnectMs());
+  Serial.println(wifiJoin.IsFastJoin() ? " ms (fast join)" : " ms");
   Serial.println("IP address: ");
   Serial.println(WiFi.localIP());
+
+  if (!spillStorage.begin())
+    Serial.println("SPIFFS is not available, samples are kept in RAM only");
+  sampleQueue.begin();
+
+  scheduler.Add(taskMeasure);
+  scheduler.Add(taskReplay);
 }
 
 void loop() 
@@ -64,39 +144,246 @@ void loop()
     MqttReconnect();
   }
   mqtt.loop();
+  scheduler.loop();
+}
 
-  bme.read(pressure, temperature, humidity);
-  if (pressure == NAN)
+void Measure()
+{
+  //Conversion runs while the loop serves MQTT, the result is picked up by Collect
+  measurementStartUs = micros();
+  isMeasuring = bme.startMeasurement();
+  if (isMeasuring)
+    scheduler.Add(taskCollect, bme.measurementTime() / 1000 + 1);
+  else
+    scheduler.Add(taskCollect);
+}
+
+void Collect()
+{
+  bool isReady = isMeasuring && bme.isReady();
+  //The status bit clears well within twice the maximum time, as in BME280Manager
+  if (isMeasuring && !isReady && micros() - measurementStartUs <= 2 * bme.measurementTime())
+  {
+    scheduler.Add(taskCollect, 1);
+    return;
+  }
+
+  isMeasuring = false;
+  if (isReady)
+    bme.collect(pressure, temperature, humidity);
+  else
+    pressure = NAN;
+  bool isError = isnan(pressure);
+  if (isError)
   {
     Serial.println("Error reading sensors data!");
+    temperature = humidity = NAN;
+  }
+  else
+  {
+    pressure = pressure / 133.3;
+  }
+
+  float values[ReportPolicy::ChannelsCount] = {temperature, humidity, pressure};
+  uint32_t now = millis();
+  if (!reportPolicy.AddSample(values, now))
+    return;
+
+  PublishSample(isError);
+  PublishStats();
+  if (PublishTextTopics)
+    PublishText(isError);
+  reportPolicy.OnReported(values, now);
+}
+
+void PublishStats()
+{
+  static const int Precision[ReportPolicy::ChannelsCount] = {2, 2, 1};
+  if (!mqtt.connected())
+    return;
+
+  static char msg[48];
+  for (size_t i = 0; i < ReportPolicy::ChannelsCount; ++i)
+  {
+    const ChannelStats& stats = reportPolicy.GetStats(i);
+    if (stats.count == 0)
+      continue;
+    const float values[] = {stats.min, stats.GetMean(), stats.max};
+    size_t length = 0;
+    for (size_t j = 0; j < 3; ++j)
+    {
+      if (j != 0)
+        msg[length++] = '/';
+      formatFloat(values[j], msg + length, sizeof(msg) - length, Precision[i]);
+      length += strlen(msg + length);
+    }
+    mqtt.publish(Stats[i], msg);
+  }
+}
+
+void PublishSample(bool isError)
+{
+  SampleRecord record;
+  record.device = DeviceNumber;
+  record.sequence = ++sampleSequence;
+  record.timestamp = millis();
+  if (isError)
+  {
+    record.flags = SampleRecord::SensorError;
+  }
+  else
+  {
+    record.SetTemperature(temperature);
+    record.SetHumidity(humidity);
+    record.SetPressure(pressure);
+  }
+
+  sampleQueue.Push(record);
+}
+
+void Replay()
+{
+  if (!mqtt.connected())
+    return;
+
+  SampleRecord records[ReplayBatchSize];
+  size_t count = sampleQueue.Peek(records, ReplayBatchSize);
+  if (count == 0)
+    return;
+
+  //Tells the display the batch is not the current value while newer samples wait
+  bool isBacklog = sampleQueue.GetCount() > count;
+  uint8_t buffer[ReplayBatchSize * SampleRecord::Size];
+  size_t length = 0;
+  for (size_t i = 0; i < count; ++i)
+  {
+    if (isBacklog)
+      records[i].flags |= SampleRecord::Backlog;
+    length += EncodeSampleRecord(records[i], buffer + length, sizeof(buffer) - length);
+  }
+  if (mqtt.publish(Sample, buffer, length))
+    sampleQueue.Pop(count);
+}
+
+void PublishText(bool isError)
+{
+  if (!mqtt.connected())
+    return;
+
+  if (isError)
+  {
     mqtt.publish(Error, "1");
+    return;
   }
+
+  mqtt.publish(Error, "0");
+  static char msg[32];
+  
+  formatFloat(temperature, msg, sizeof(msg), 2);
+  mqtt.publish(Sensor1, msg);
+  
+  formatFloat(humidity, msg, sizeof(msg), 2);
+  mqtt.publish(Sensor2, msg);
+  
+  formatFloat(pressure, msg, sizeof(msg), 1);
+  mqtt.publish(Sensor3, msg);
+}
+
+void RunDutyCycle()
+{
+  //Let the sensor convert while the RTC state is restored
+  bool isSensorStarted = bme.begin(5, 4) && bme.startMeasurement();
+
+  SampleBatch batch(rtcState);
+  ESP.rtcUserMemoryRead(RtcBatchOffset, reinterpret_cast<uint32_t*>(&rtcState), sizeof(rtcState));
+  if (batch.Restore())
+    batch.OnWake(SleepIntervalMs);
   else
+    Serial.println("RTC memory is not valid, starting a new batch");
+
+  SampleRecord record;
+  record.device = DeviceNumber;
+  if (isSensorStarted)
   {
-    Serial.print("Temperature: ");
-    Serial.print(temperature);
-    Serial.print("'C");
-    Serial.print("\t\tHumidity: ");
-    Serial.print(humidity);
-    Serial.print("% RH");
-    Serial.print("\t\tPressure: ");
+    uint32_t readyTimeoutMs = bme.measurementTime() / 1000 + SensorReadyMarginMs;
+    uint32_t start = millis();
+    while (!bme.isReady())
+    {
+      if (millis() - start > readyTimeoutMs)
+      {
+        Serial.println("Sensor is not ready, going back to sleep");
+        batch.OnSensorError();
+        Sleep(batch);
+        return;
+      }
+      delay(1);
+    }
+    bme.collect(pressure, temperature, humidity);
     pressure = pressure / 133.3;
-    Serial.print(pressure);
-    Serial.println(" mm Hg");
+  }
+  if (isnan(pressure))
+  {
+    record.flags = SampleRecord::SensorError;
+  }
+  else
+  {
+    record.SetTemperature(temperature);
+    record.SetHumidity(humidity);
+    record.SetPressure(pressure);
+  }
+  batch.Append(record);
 
-    mqtt.publish(Error, "0");
-    static char msg[32];
-    
-    dtostrf(temperature, 4, 2, msg);
-    mqtt.publish(Sensor1, msg);
-    
-    dtostrf(humidity, 4, 2, msg);
-    mqtt.publish(Sensor2, msg);
-    
-    dtostrf(pressure, 4, 1, msg);
-    mqtt.publish(Sensor3, msg);
-  }
-  delay(1000);
+  if (batch.IsPublishDue(PublishEveryWakes))
+  {
+    size_t published = 0;
+    if (wifiJoin.Connect(ssid, password, FastJoinTimeoutMs, WiFiConnectTimeoutMs) && mqtt.connect(DeviceId))
+    {
+      PublishWiFiTime();
+      uint8_t buffer[SampleRecord::Size];
+      for (; published < batch.GetCount(); ++published)
+      {
+        SampleRecord record = batch.Get(published, DeviceNumber);
+        if (published + 1 < batch.GetCount())
+          record.flags |= SampleRecord::Backlog;
+        size_t length = EncodeSampleRecord(record, buffer, sizeof(buffer));
+        if (!mqtt.publish(Sample, buffer, length))
+          break;
+      }
+      mqtt.disconnect();
+    }
+    batch.OnPublished(published);
+    if (batch.GetCount() != 0)
+      batch.OnPublishFailed();
+
+    Serial.print("Published ");
+    Serial.print(published);
+    Serial.print(" samples, wakes: ");
+    Serial.print(batch.GetTotalWakes());
+    Serial.print(", failed publishes: ");
+    Serial.print(batch.GetFailedPublishes());
+    Serial.print(", dropped: ");
+    Serial.print(batch.GetDropped());
+    Serial.print(", sensor errors: ");
+    Serial.println(batch.GetSensorErrors());
+  }
+
+  Sleep(batch);
+}
+
+void Sleep(SampleBatch& batch)
+{
+  //Only bring the radio up on the wake that is going to publish
+  RFMode rfMode = batch.IsPublishDueOnNextWake(PublishEveryWakes) ? WAKE_RF_DEFAULT : WAKE_RF_DISABLED;
+  batch.OnSleep(millis());
+  batch.Seal();
+  ESP.rtcUserMemoryWrite(RtcBatchOffset, reinterpret_cast<uint32_t*>(&rtcState), sizeof(rtcState));
+  ESP.deepSleep(SleepIntervalMs * 1000, rfMode);
+}
+
+//Keeps counting across deep sleep once the batch is restored from RTC memory
+uint32_t GetUptimeSec()
+{
+  return (rtcState.uptimeMs + millis()) / 1000;
 }
 
 void MqttCallback(char* topic, byte* payload, unsigned int length) 
@@ -121,32 +408,41 @@ void MqttCallback(char* topic, byte* payload, unsigned int length)
   }
 }
 
+void PublishWiFiTime()
+{
+  static char msg[16];
+  snprintf(msg, sizeof(msg), "%lu", static_cast<unsigned long>(wifiJoin.GetTimeToConnectMs()));
+  mqtt.publish(WiFiTime, msg);
+}
+
 void MqttReconnect() 
 {
-  // Loop until we're reconnected
-  while (!mqtt.connected()) 
+  uint32_t now = millis();
+  if (!mqttBackoff.IsDue(now))
+    return;
+
+  Serial.print("Attempting MQTT connection...");
+  if (mqtt.connect(DeviceId))
   {
-    Serial.print("Attempting MQTT connection...");
-    // Attempt to connect
-    if (mqtt.connect(DeviceId))
-    {
-      Serial.println("connected");
-      // Once connected, publish an announcement...
-      ++reconnectCounter;
-      static char msg[32];
-      snprintf(msg, 31, "%ld", reconnectCounter);
-      mqtt.publish(Hello, msg);
-      // ... and resubscribe
-      mqtt.subscribe(ResetTopic);
-    } 
-    else 
-    {
-      Serial.print("Failed, result=");
-      Serial.print(mqtt.state());
-      Serial.println(" try again in 5 seconds");
-      // Wait 5 seconds before retrying
-      delay(5000);
-    }
+    Serial.println("connected");
+    mqttBackoff.Reset();
+    // Once connected, publish an announcement...
+    ++reconnectCounter;
+    static char msg[32];
+    snprintf(msg, 31, "%ld", reconnectCounter);
+    mqtt.publish(Hello, msg);
+    PublishWiFiTime();
+    // ... and resubscribe
+    mqtt.subscribe(ResetTopic);
+  } 
+  else 
+  {
+    mqttBackoff.OnFailed(now);
+    Serial.print("Failed, result=");
+    Serial.print(mqtt.state());
+    Serial.print(" try again in ");
+    Serial.print(mqttBackoff.GetIntervalMs() / 1000);
+    Serial.print(" seconds, queued samples: ");
+    Serial.println(sampleQueue.GetCount());
   }
 }
-
@@ -0,0 +1,63 @@
+#include "report_policy.h"
+
+#include <cmath>
+
+float ChannelStats::GetMean() const
+{
+  return count != 0 ? sum / count : NAN;
+}
+
+ReportPolicy::ReportPolicy(const ReportConfig& config)
+  : m_config(config)
+{
+}
+
+bool ReportPolicy::AddSample(const float* values, uint32_t now)
+{
+  if (m_stats[0].count == 0 && m_stats[1].count == 0 && m_stats[2].count == 0)
+    m_windowStart = now;
+
+  for (size_t i = 0; i < ChannelsCount; ++i)
+  {
+    if (std::isnan(values[i]))
+      continue;
+    ChannelStats& stats = m_stats[i];
+    if (stats.count == 0 || values[i] < stats.min)
+      stats.min = values[i];
+    if (stats.count == 0 || values[i] > stats.max)
+      stats.max = values[i];
+    stats.sum += values[i];
+    ++stats.count;
+  }
+
+  if (!m_hasReported)
+    return true;
+  uint32_t sinceReport = now - m_lastReport;
+  if (sinceReport >= m_config.heartbeatMs)
+    return true;
+  return sinceReport >= m_config.minIntervalMs && IsException(values);
+}
+
+void ReportPolicy::OnReported(const float* values, uint32_t now)
+{
+  for (size_t i = 0; i < ChannelsCount; ++i)
+  {
+    m_reported[i] = values[i];
+    m_stats[i] = ChannelStats();
+  }
+  m_hasReported = true;
+  m_lastReport = now;
+  m_windowStart = now;
+}
+
+bool ReportPolicy::IsException(const float* values) const
+{
+  for (size_t i = 0; i < ChannelsCount; ++i)
+  {
+    if (std::isnan(values[i]) != std::isnan(m_reported[i]))
+      return true;
+    if (!std::isnan(values[i]) && fabsf(values[i] - m_reported[i]) >= m_config.deadband[i])
+      return true;
+  }
+  return false;
+}
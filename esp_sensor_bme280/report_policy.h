@@ -0,0 +1,51 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+struct ChannelStats
+{
+  float min = 0;
+  float max = 0;
+  float sum = 0;
+  uint32_t count = 0;
+
+  float GetMean() const;
+};
+
+struct ReportConfig
+{
+  static constexpr size_t ChannelsCount = 3;
+
+  //Report when any channel moves at least this far from the last reported value
+  float deadband[ChannelsCount];
+  //Report at least this often even if nothing changed
+  uint32_t heartbeatMs;
+  //Do not report exceptions more often than this
+  uint32_t minIntervalMs;
+};
+
+class ReportPolicy
+{
+public:
+  static constexpr size_t ChannelsCount = ReportConfig::ChannelsCount;
+
+  explicit ReportPolicy(const ReportConfig& config);
+
+  bool AddSample(const float* values, uint32_t now);
+  void OnReported(const float* values, uint32_t now);
+
+  const ChannelStats& GetStats(size_t channel) const { return m_stats[channel]; }
+  uint32_t GetWindowMs(uint32_t now) const { return now - m_windowStart; }
+
+private:
+  bool IsException(const float* values) const;
+
+private:
+  ReportConfig m_config;
+  ChannelStats m_stats[ChannelsCount];
+  float m_reported[ChannelsCount]{};
+  bool m_hasReported = false;
+  uint32_t m_lastReport = 0;
+  uint32_t m_windowStart = 0;
+};
@@ -0,0 +1,117 @@
+#include "rtc_batch.h"
+#include "crc32.h"
+
+#include <cstring>
+
+constexpr uint32_t RtcMagic = 0x42544348;
+
+SampleBatch::SampleBatch(RtcState& state)
+  : m_state(state)
+{
+}
+
+bool SampleBatch::Restore()
+{
+  if (m_state.magic == RtcMagic && m_state.crc == CalcCrc() && m_state.count <= RtcState::Capacity &&
+      m_state.head < RtcState::Capacity)
+    return true;
+
+  memset(&m_state, 0, sizeof(m_state));
+  m_state.magic = RtcMagic;
+  return false;
+}
+
+void SampleBatch::Seal()
+{
+  m_state.crc = CalcCrc();
+}
+
+void SampleBatch::OnWake(uint32_t sleptMs)
+{
+  ++m_state.totalWakes;
+  ++m_state.wakesSincePublish;
+  m_state.uptimeMs += sleptMs + m_state.awakeMs;
+  m_state.awakeMs = 0;
+}
+
+void SampleBatch::OnSleep(uint32_t awakeMs)
+{
+  m_state.awakeMs = awakeMs;
+}
+
+void SampleBatch::Append(SampleRecord& record)
+{
+  record.sequence = ++m_state.sequence;
+  record.timestamp = m_state.uptimeMs;
+
+  size_t tail = (m_state.head + m_state.count) % RtcState::Capacity;
+  if (m_state.count == RtcState::Capacity)
+  {
+    m_state.head = (m_state.head + 1) % RtcState::Capacity;
+    ++m_state.dropped;
+  }
+  else
+  {
+    ++m_state.count;
+  }
+
+  BatchEntry& entry = m_state.entries[tail];
+  entry.timestamp = record.timestamp;
+  entry.temperature = record.temperature;
+  entry.humidity = record.humidity;
+  entry.pressure = record.pressure;
+  entry.flags = record.flags;
+  entry.reserved = 0;
+}
+
+bool SampleBatch::IsPublishDue(uint32_t publishEveryWakes) const
+{
+  return m_state.wakesSincePublish >= publishEveryWakes || m_state.count == RtcState::Capacity;
+}
+
+bool SampleBatch::IsPublishDueOnNextWake(uint32_t publishEveryWakes) const
+{
+  return m_state.wakesSincePublish + 1 >= publishEveryWakes || m_state.count + 1u >= RtcState::Capacity;
+}
+
+void SampleBatch::OnPublished(size_t count)
+{
+  if (count > m_state.count)
+    count = m_state.count;
+  m_state.head = (m_state.head + count) % RtcState::Capacity;
+  m_state.count -= count;
+  if (m_state.count == 0)
+    m_state.wakesSincePublish = 0;
+}
+
+void SampleBatch::OnPublishFailed()
+{
+  ++m_state.failedPublishes;
+}
+
+void SampleBatch::OnSensorError()
+{
+  if (m_state.sensorErrors != UINT16_MAX)
+    ++m_state.sensorErrors;
+}
+
+SampleRecord SampleBatch::Get(size_t index, uint8_t device) const
+{
+  const BatchEntry& entry = m_state.entries[(m_state.head + index) % RtcState::Capacity];
+  SampleRecord record;
+  record.device = device;
+  record.sequence = m_state.sequence - m_state.count + 1 + index;
+  record.timestamp = entry.timestamp;
+  record.temperature = entry.temperature;
+  record.humidity = entry.humidity;
+  record.pressure = entry.pressure;
+  record.flags = entry.flags;
+  return record;
+}
+
+uint32_t SampleBatch::CalcCrc() const
+{
+  const uint8_t* data = reinterpret_cast<const uint8_t*>(&m_state);
+  size_t offset = offsetof(RtcState, crc) + sizeof(m_state.crc);
+  return Crc32(data + offset, sizeof(m_state) - offset);
+}
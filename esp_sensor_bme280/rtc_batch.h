@@ -0,0 +1,74 @@
+#pragma once
+
+#include "sample_record.h"
+
+#include <cstddef>
+#include <cstdint>
+
+//Sample kept in RTC memory between deep sleep wakes, same units as SampleRecord
+struct BatchEntry
+{
+  uint32_t timestamp;
+  int16_t temperature;
+  uint16_t humidity;
+  uint16_t pressure;
+  uint8_t flags;
+  uint8_t reserved;
+};
+
+//Image of the RTC user memory, must stay a multiple of 4 bytes and fit into 512 bytes
+struct RtcState
+{
+  static constexpr size_t Capacity = 32;
+
+  uint32_t magic;
+  uint32_t crc;
+  uint32_t totalWakes;
+  uint32_t wakesSincePublish;
+  uint32_t uptimeMs;
+  uint32_t awakeMs;
+  uint32_t sequence;
+  uint32_t failedPublishes;
+  uint32_t dropped;
+  uint8_t head;
+  uint8_t count;
+  uint16_t sensorErrors;
+  BatchEntry entries[Capacity];
+};
+
+static_assert(sizeof(BatchEntry) == 12, "BatchEntry layout changed");
+static_assert(sizeof(RtcState) % 4 == 0 && sizeof(RtcState) <= 512, "RtcState does not fit into RTC user memory");
+
+class SampleBatch
+{
+public:
+  explicit SampleBatch(RtcState& state);
+
+  bool Restore();
+  void Seal();
+
+  void OnWake(uint32_t sleptMs);
+  void OnSleep(uint32_t awakeMs);
+
+  void Append(SampleRecord& record);
+  bool IsPublishDue(uint32_t publishEveryWakes) const;
+  bool IsPublishDueOnNextWake(uint32_t publishEveryWakes) const;
+  void OnPublished(size_t count);
+  void OnPublishFailed();
+  void OnSensorError();
+
+  size_t GetCount() const { return m_state.count; }
+  SampleRecord Get(size_t index, uint8_t device) const;
+
+  uint32_t GetUptimeMs() const { return m_state.uptimeMs; }
+  uint32_t GetTotalWakes() const { return m_state.totalWakes; }
+  uint32_t GetFailedPublishes() const { return m_state.failedPublishes; }
+  uint32_t GetDropped() const { return m_state.dropped; }
+  uint32_t GetSensorErrors() const { return m_state.sensorErrors; }
+
+private:
+  uint32_t CalcCrc() const;
+
+private:
+  RtcState& m_state;
+};
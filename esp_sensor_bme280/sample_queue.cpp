@@ -0,0 +1,134 @@
+#include "sample_queue.h"
+
+SampleQueue::SampleQueue(SpillStorage* storage, size_t maxSpilled)
+  : m_storage(storage)
+  , m_maxSpilled(maxSpilled)
+{
+}
+
+void SampleQueue::begin()
+{
+  m_readOffset = 0;
+  m_persistedOffset = 0;
+  m_spilledCount = 0;
+  if (!m_storage)
+    return;
+
+  //A reset in the middle of an append leaves a partial record, and every
+  //record appended after it would be misaligned
+  size_t size = m_storage->GetSize();
+  size_t alignedSize = size - size % SampleRecord::Size;
+  if (alignedSize != size)
+  {
+    ++m_dropped;
+    if (!m_storage->Truncate(alignedSize))
+    {
+      m_storage->Clear();
+      return;
+    }
+  }
+
+  //Samples spilled before a reset and not yet acknowledged are replayed
+  size_t readOffset = m_storage->GetReadOffset();
+  if (readOffset > alignedSize || readOffset % SampleRecord::Size != 0)
+    readOffset = 0;
+  m_readOffset = readOffset;
+  m_persistedOffset = readOffset;
+  m_spilledCount = (alignedSize - readOffset) / SampleRecord::Size;
+  if (m_spilledCount == 0 && alignedSize != 0)
+    m_storage->Clear();
+}
+
+bool SampleQueue::Push(const SampleRecord& record)
+{
+  if (m_spilledCount == 0 && m_ramCount < RamCapacity)
+  {
+    m_ram[(m_ramHead + m_ramCount) % RamCapacity] = record;
+    ++m_ramCount;
+    return true;
+  }
+
+  uint8_t buffer[SampleRecord::Size];
+  if (m_storage && m_spilledCount < m_maxSpilled &&
+      m_storage->Append(buffer, EncodeSampleRecord(record, buffer, sizeof(buffer))))
+  {
+    ++m_spilledCount;
+    return true;
+  }
+
+  ++m_dropped;
+  return false;
+}
+
+size_t SampleQueue::Peek(SampleRecord* records, size_t maxCount)
+{
+  size_t count = 0;
+  if (m_ramCount != 0)
+  {
+    for (; count < maxCount && count < m_ramCount; ++count)
+      records[count] = m_ram[(m_ramHead + count) % RamCapacity];
+    return count;
+  }
+
+  if (maxCount > MaxPeek)
+    maxCount = MaxPeek;
+  uint8_t buffer[MaxPeek * SampleRecord::Size];
+  while (count == 0 && m_spilledCount != 0)
+  {
+    size_t readCount = (maxCount < m_spilledCount ? maxCount : m_spilledCount);
+    if (readCount == 0 || !m_storage->Read(m_readOffset, buffer, readCount * SampleRecord::Size))
+      return 0;
+
+    size_t skipped = 0;
+    for (size_t i = 0; i < readCount; ++i)
+    {
+      if (DecodeSampleRecord(buffer + i * SampleRecord::Size, SampleRecord::Size, records[count]))
+        ++count;
+      else if (count == 0)
+        ++skipped;
+      else
+        break;
+    }
+    if (skipped != 0)
+    {
+      m_dropped += skipped;
+      Discard(skipped);
+    }
+  }
+  return count;
+}
+
+void SampleQueue::Pop(size_t count)
+{
+  if (m_ramCount != 0)
+  {
+    if (count > m_ramCount)
+      count = m_ramCount;
+    m_ramHead = (m_ramHead + count) % RamCapacity;
+    m_ramCount -= count;
+    return;
+  }
+
+  Discard(count);
+}
+
+void SampleQueue::Discard(size_t count)
+{
+  if (count > m_spilledCount)
+    count = m_spilledCount;
+  if (count == 0)
+    return;
+  m_spilledCount -= count;
+  m_readOffset += count * SampleRecord::Size;
+  if (m_spilledCount == 0)
+  {
+    m_storage->Clear();
+    m_readOffset = 0;
+    m_persistedOffset = 0;
+  }
+  else if (m_readOffset - m_persistedOffset >= PersistEveryRecords * SampleRecord::Size &&
+           m_storage->SetReadOffset(m_readOffset))
+  {
+    m_persistedOffset = m_readOffset;
+  }
+}
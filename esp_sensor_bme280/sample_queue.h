@@ -0,0 +1,64 @@
+#pragma once
+
+#include "sample_record.h"
+
+#include <cstddef>
+#include <cstdint>
+
+class SpillStorage
+{
+public:
+  virtual ~SpillStorage() = default;
+
+  virtual bool Append(const uint8_t* data, size_t length) = 0;
+  virtual bool Read(size_t offset, uint8_t* data, size_t length) = 0;
+  virtual size_t GetSize() = 0;
+  virtual bool Truncate(size_t size) = 0;
+  virtual void Clear() = 0;
+
+  //Offset of the first record not yet acknowledged by the broker, survives resets
+  virtual size_t GetReadOffset() = 0;
+  virtual bool SetReadOffset(size_t offset) = 0;
+};
+
+//FIFO of samples waiting for the broker. Keeps the oldest samples in RAM and
+//appends to the spill storage once RAM is full, until the storage drains again.
+//The spill storage keeps the read offset, so a reset replays only the records
+//that were not popped yet. The offset is written every PersistEveryRecords
+//records to spare the flash, a reset may replay up to that many records again.
+//Records that do not decode are skipped and counted as dropped.
+class SampleQueue
+{
+public:
+  static constexpr size_t RamCapacity = 32;
+  static constexpr size_t MaxPeek = 8;
+  static constexpr size_t PersistEveryRecords = 16;
+
+  SampleQueue(SpillStorage* storage, size_t maxSpilled);
+
+  void begin();
+
+  bool Push(const SampleRecord& record);
+  size_t Peek(SampleRecord* records, size_t maxCount);
+  void Pop(size_t count);
+
+  size_t GetCount() const { return m_ramCount + m_spilledCount; }
+  size_t GetSpilledCount() const { return m_spilledCount; }
+  uint32_t GetDropped() const { return m_dropped; }
+
+private:
+  void Discard(size_t count);
+
+private:
+  SpillStorage* m_storage;
+  size_t m_maxSpilled;
+
+  SampleRecord m_ram[RamCapacity];
+  size_t m_ramHead = 0;
+  size_t m_ramCount = 0;
+
+  size_t m_spilledCount = 0;
+  size_t m_readOffset = 0;
+  size_t m_persistedOffset = 0;
+  uint32_t m_dropped = 0;
+};
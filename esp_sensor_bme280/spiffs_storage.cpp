@@ -0,0 +1,99 @@
+#include "spiffs_storage.h"
+
+#include <FS.h>
+
+SpiffsStorage::SpiffsStorage(const char* path, const char* readOffsetPath)
+  : m_path(path)
+  , m_readOffsetPath(readOffsetPath)
+{
+}
+
+bool SpiffsStorage::begin()
+{
+  m_isMounted = SPIFFS.begin();
+  return m_isMounted;
+}
+
+bool SpiffsStorage::Append(const uint8_t* data, size_t length)
+{
+  if (!m_isMounted)
+    return false;
+  File file = SPIFFS.open(m_path, "a");
+  if (!file)
+    return false;
+  bool ok = file.write(data, length) == length;
+  file.close();
+  return ok;
+}
+
+bool SpiffsStorage::Read(size_t offset, uint8_t* data, size_t length)
+{
+  if (!m_isMounted)
+    return false;
+  File file = SPIFFS.open(m_path, "r");
+  if (!file)
+    return false;
+  bool ok = file.seek(offset, SeekSet) && file.read(data, length) == length;
+  file.close();
+  return ok;
+}
+
+size_t SpiffsStorage::GetSize()
+{
+  if (!m_isMounted || !SPIFFS.exists(m_path))
+    return 0;
+  File file = SPIFFS.open(m_path, "r");
+  if (!file)
+    return 0;
+  size_t size = file.size();
+  file.close();
+  return size;
+}
+
+bool SpiffsStorage::Truncate(size_t size)
+{
+  if (!m_isMounted)
+    return false;
+  File file = SPIFFS.open(m_path, "r+");
+  if (!file)
+    return false;
+  bool ok = file.truncate(size);
+  file.close();
+  return ok;
+}
+
+void SpiffsStorage::Clear()
+{
+  if (!m_isMounted)
+    return;
+  //The offset goes first, a reset in between replays the records instead of losing them
+  SPIFFS.remove(m_readOffsetPath);
+  SPIFFS.remove(m_path);
+}
+
+size_t SpiffsStorage::GetReadOffset()
+{
+  if (!m_isMounted || !SPIFFS.exists(m_readOffsetPath))
+    return 0;
+  File file = SPIFFS.open(m_readOffsetPath, "r");
+  if (!file)
+    return 0;
+  uint32_t offset = 0;
+  if (file.read(reinterpret_cast<uint8_t*>(&offset), sizeof(offset)) != sizeof(offset))
+    offset = 0;
+  file.close();
+  return offset;
+}
+
+bool SpiffsStorage::SetReadOffset(size_t offset)
+{
+  if (!m_isMounted)
+    return false;
+  File file = SPIFFS.open(m_readOffsetPath, "w");
+  if (!file)
+    return false;
+  uint32_t value = offset;
+  bool ok = file.write(reinterpret_cast<const uint8_t*>(&value), sizeof(value)) == sizeof(value);
+  file.close();
+  return ok;
+}
@@ -0,0 +1,25 @@
+#pragma once
+
+#include "sample_queue.h"
+
+class SpiffsStorage: public SpillStorage
+{
+public:
+  SpiffsStorage(const char* path, const char* readOffsetPath);
+
+  bool begin();
+
+  bool Append(const uint8_t* data, size_t length) override;
+  bool Read(size_t offset, uint8_t* data, size_t length) override;
+  size_t GetSize() override;
+  bool Truncate(size_t size) override;
+  void Clear() override;
+
+  size_t GetReadOffset() override;
+  bool SetReadOffset(size_t offset) override;
+
+private:
+  const char* m_path;
+  const char* m_readOffsetPath;
+  bool m_isMounted = false;
+};
@@ -0,0 +1,133 @@
+#include "wifi_join.h"
+#include "crc32.h"
+
+#include <ESP8266WiFi.h>
+#include <lwip/dhcp.h>
+#include <lwip/netif.h>
+#include <cstring>
+
+constexpr uint32_t JoinCacheMagic = 0x4A4F494E;
+
+WiFiJoin::WiFiJoin(uint32_t rtcOffset, WiFiJoinClock clock)
+  : m_rtcOffset(rtcOffset)
+  , m_clock(clock)
+{
+}
+
+bool WiFiJoin::Connect(const char* ssid, const char* password, uint32_t fastTimeoutMs, uint32_t timeoutMs)
+{
+  uint32_t start = millis();
+  m_isFastJoin = false;
+  m_timeToConnectMs = 0;
+  WiFi.mode(WIFI_STA);
+
+  bool isStaticIp = false;
+  if (LoadCache(ssid))
+  {
+    isStaticIp = IsLeaseValid();
+    if (isStaticIp)
+      WiFi.config(IPAddress(m_cache.ip), IPAddress(m_cache.gateway), IPAddress(m_cache.subnet), IPAddress(m_cache.dns));
+    WiFi.begin(ssid, password, m_cache.channel, m_cache.bssid);
+    m_isFastJoin = WaitConnected(start, fastTimeoutMs);
+    if (!m_isFastJoin)
+    {
+      Invalidate();
+      WiFi.disconnect();
+      if (isStaticIp)
+        WiFi.config(0u, 0u, 0u);
+      isStaticIp = false;
+    }
+  }
+
+  if (!m_isFastJoin)
+  {
+    //The fallback gets its own full timeout
+    WiFi.begin(ssid, password);
+    if (!WaitConnected(millis(), timeoutMs))
+      return false;
+  }
+
+  m_timeToConnectMs = millis() - start;
+  if (!isStaticIp)
+    SaveCache(ssid);
+  return true;
+}
+
+void WiFiJoin::Invalidate()
+{
+  memset(&m_cache, 0, sizeof(m_cache));
+  ESP.rtcUserMemoryWrite(m_rtcOffset, reinterpret_cast<uint32_t*>(&m_cache), sizeof(m_cache));
+}
+
+bool WiFiJoin::LoadCache(const char* ssid)
+{
+  if (!ESP.rtcUserMemoryRead(m_rtcOffset, reinterpret_cast<uint32_t*>(&m_cache), sizeof(m_cache)))
+    return false;
+  return m_cache.magic == JoinCacheMagic && m_cache.crc == CalcJoinCacheCrc(m_cache) &&
+         m_cache.ssidHash == HashSsid(ssid) && m_cache.channel != 0 && m_cache.ip != 0;
+}
+
+//lwIP keeps the lease of the default interface, which is the station once connected
+uint32_t GetLeaseSec()
+{
+  if (netif_default == nullptr)
+    return 0;
+  const struct dhcp* dhcp = netif_dhcp_data(netif_default);
+  return (dhcp != nullptr ? dhcp->offered_t0_lease : 0);
+}
+
+void WiFiJoin::SaveCache(const char* ssid)
+{
+  m_cache.magic = JoinCacheMagic;
+  m_cache.ssidHash = HashSsid(ssid);
+  memcpy(m_cache.bssid, WiFi.BSSID(), sizeof(m_cache.bssid));
+  m_cache.channel = WiFi.channel();
+  m_cache.reserved = 0;
+  m_cache.ip = WiFi.localIP();
+  m_cache.gateway = WiFi.gatewayIP();
+  m_cache.subnet = WiFi.subnetMask();
+  m_cache.dns = WiFi.dnsIP();
+  m_cache.leaseObtainedSec = m_clock();
+  m_cache.leaseSec = GetLeaseSec();
+  m_cache.crc = CalcJoinCacheCrc(m_cache);
+  ESP.rtcUserMemoryWrite(m_rtcOffset, reinterpret_cast<uint32_t*>(&m_cache), sizeof(m_cache));
+  m_hasSavedCache = true;
+}
+
+bool WiFiJoin::IsLeaseValid() const
+{
+  //Other resets restart the clock, so only a lease saved in this boot or before
+  //a deep sleep can be aged
+  bool isSameClock = m_hasSavedCache || ESP.getResetInfoPtr()->reason == REASON_DEEP_SLEEP_AWAKE;
+  return isSameClock && ::IsLeaseValid(m_cache, m_clock());
+}
+
+bool WiFiJoin::WaitConnected(uint32_t start, uint32_t timeoutMs)
+{
+  while (WiFi.status() != WL_CONNECTED)
+  {
+    if (millis() - start >= timeoutMs)
+      return false;
+    delay(10);
+  }
+  return true;
+}
+
+uint32_t CalcJoinCacheCrc(const WiFiJoinCache& cache)
+{
+  const uint8_t* data = reinterpret_cast<const uint8_t*>(&cache);
+  size_t offset = offsetof(WiFiJoinCache, crc) + sizeof(cache.crc);
+  return Crc32(data + offset, sizeof(cache) - offset);
+}
+
+//Reuses the address until T1, when a DHCP client would start renewing it.
+//A clock that went backwards has been restarted, so the age is unknown.
+bool IsLeaseValid(const WiFiJoinCache& cache, uint32_t nowSec)
+{
+  return cache.leaseSec != 0 && nowSec >= cache.leaseObtainedSec && nowSec - cache.leaseObtainedSec < cache.leaseSec / 2;
+}
+
+uint32_t HashSsid(const char* ssid)
+{
+  return Crc32(reinterpret_cast<const uint8_t*>(ssid), strlen(ssid));
+}
@@ -0,0 +1,62 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+//Association and lease data from the last successful join, kept in RTC user memory
+struct WiFiJoinCache
+{
+  uint32_t magic;
+  uint32_t crc;
+  uint32_t ssidHash;
+  uint8_t bssid[6];
+  uint8_t channel;
+  uint8_t reserved;
+  uint32_t ip;
+  uint32_t gateway;
+  uint32_t subnet;
+  uint32_t dns;
+  //DHCP lease, in seconds of the WiFiJoin clock
+  uint32_t leaseObtainedSec;
+  uint32_t leaseSec;
+};
+
+static_assert(sizeof(WiFiJoinCache) % 4 == 0, "WiFiJoinCache must be a multiple of 4 bytes");
+
+//Seconds on a clock that keeps counting across deep sleep, if the device uses it
+using WiFiJoinClock = uint32_t (*)();
+
+//Joins the access point directly on the cached BSSID and channel with the cached
+//lease, falls back to a full scan and DHCP if that does not work. The cached
+//lease is only reused until its renewal time, after that the fast join asks
+//DHCP again.
+class WiFiJoin
+{
+public:
+  //rtcOffset is in 4-byte blocks
+  WiFiJoin(uint32_t rtcOffset, WiFiJoinClock clock);
+
+  bool Connect(const char* ssid, const char* password, uint32_t fastTimeoutMs, uint32_t timeoutMs);
+  void Invalidate();
+
+  uint32_t GetTimeToConnectMs() const { return m_timeToConnectMs; }
+  bool IsFastJoin() const { return m_isFastJoin; }
+
+private:
+  bool LoadCache(const char* ssid);
+  void SaveCache(const char* ssid);
+  bool IsLeaseValid() const;
+  bool WaitConnected(uint32_t start, uint32_t timeoutMs);
+
+private:
+  uint32_t m_rtcOffset;
+  WiFiJoinClock m_clock;
+  WiFiJoinCache m_cache{};
+  uint32_t m_timeToConnectMs = 0;
+  bool m_isFastJoin = false;
+  bool m_hasSavedCache = false;
+};
+
+uint32_t CalcJoinCacheCrc(const WiFiJoinCache& cache);
+bool IsLeaseValid(const WiFiJoinCache& cache, uint32_t nowSec);
+uint32_t HashSsid(const char* ssid);
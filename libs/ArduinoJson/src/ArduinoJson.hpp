@@ -6,7 +6,11 @@
 
 #include "ArduinoJson/DynamicJsonBuffer.hpp"
 #include "ArduinoJson/JsonArray.hpp"
+#include "ArduinoJson/JsonEventHandler.hpp"
 #include "ArduinoJson/JsonObject.hpp"
+#include "ArduinoJson/JsonStructReader.hpp"
+#include "ArduinoJson/JsonTape.hpp"
+#include "ArduinoJson/Serialization/formatFloat.hpp"
 #include "ArduinoJson/StaticJsonBuffer.hpp"
 
 #include "ArduinoJson/Deserialization/JsonParserImpl.hpp"
@@ -112,6 +112,28 @@
 
 #endif  // ARDUINO
 
+// Size of the block buffer used to parse from an Arduino Stream.
+// 0 (the default) reads the stream one byte at a time and leaves whatever
+// follows the document in the stream. A block buffer is faster but may
+// consume the bytes that are already received after the end of the
+// document, so only enable it when nothing else is read from the stream.
+// It must be at least 2 because the parser looks one char ahead.
+#ifndef ARDUINOJSON_STREAM_BUFFER_SIZE
+#define ARDUINOJSON_STREAM_BUFFER_SIZE 0
+#endif
+
+// Longest path, terminator included, that a JsonStructReader can match,
+// like "list[39].main.temp".
+#ifndef ARDUINOJSON_STRUCT_PATH_SIZE
+#define ARDUINOJSON_STRUCT_PATH_SIZE 32
+#endif
+
+// Deepest nesting level that a JsonStructReader can match.
+// Deeper values are skipped.
+#ifndef ARDUINOJSON_STRUCT_MAX_DEPTH
+#define ARDUINOJSON_STRUCT_MAX_DEPTH 4
+#endif
+
 #ifndef ARDUINOJSON_ENABLE_PROGMEM
 #ifdef PROGMEM
 #define ARDUINOJSON_ENABLE_PROGMEM 1
@@ -146,6 +168,13 @@
 #define ARDUINOJSON_NEGATIVE_EXPONENTIATION_THRESHOLD 1e-5
 #endif
 
+// Print floats with all the digits needed to read the same value back (up to
+// 17 for a double, 9 for a float), instead of 9 or 6 decimals at most.
+// Integer arithmetic only, but slower than the default where there is an FPU.
+#ifndef ARDUINOJSON_ROUND_TRIP_FLOATS
+#define ARDUINOJSON_ROUND_TRIP_FLOATS 0
+#endif
+
 #if ARDUINOJSON_USE_LONG_LONG && ARDUINOJSON_USE_INT64
 #error ARDUINOJSON_USE_LONG_LONG and ARDUINOJSON_USE_INT64 cannot be set together
 #endif
@@ -0,0 +1,111 @@
+// ArduinoJson - arduinojson.org
+// Copyright Benoit Blanchon 2014-2018
+// MIT License
+
+#pragma once
+
+#include <stddef.h>  // for size_t
+#include <stdint.h>  // for uint32_t
+#include <string.h>  // for strcmp
+
+namespace ArduinoJson {
+namespace Internals {
+
+// An open addressing hash set of strings stored in a JsonBuffer.
+// The parser looks up every key it copies, and gives the copy back to the
+// buffer when an equal string is already there.
+class InternTableBase {
+ public:
+  // Also intern the values that are not longer than the specified length.
+  // The default is 0: only keys are interned.
+  void setMaxValueLength(size_t length) {
+    _maxValueLength = length;
+  }
+
+  // Returns the number of distinct strings in the table.
+  size_t size() const {
+    return _count;
+  }
+
+  // Returns the number of bytes that didn't have to be allocated.
+  size_t savedBytes() const {
+    return _savedBytes;
+  }
+
+  // Forgets all strings.
+  // Called by JsonBuffer::clear() because the strings are freed.
+  void clear() {
+    for (size_t i = 0; i < _capacity; i++) _slots[i] = NULL;
+    _count = 0;
+  }
+
+  // Returns the string equal to str if there is one, or adds str and
+  // returns it.
+  const char *intern(const char *str, size_t length, bool isKey) {
+    if (!isKey && length > _maxValueLength) return str;
+
+    size_t slot = hash(str) % _capacity;
+    for (size_t probe = 0; probe < _capacity; probe++) {
+      const char *candidate = _slots[slot];
+      if (!candidate) {
+        // keep a free slot so that the probing stops on a miss
+        if (_count + 1 < _capacity) {
+          _slots[slot] = str;
+          _count++;
+        }
+        return str;
+      }
+      if (strcmp(candidate, str) == 0) {
+        _savedBytes += length + 1;
+        return candidate;
+      }
+      slot = (slot + 1) % _capacity;
+    }
+    return str;
+  }
+
+ protected:
+  InternTableBase(const char **slots, size_t capacity)
+      : _slots(slots),
+        _capacity(capacity),
+        _count(0),
+        _savedBytes(0),
+        _maxValueLength(0) {
+    clear();
+  }
+
+ private:
+  // FNV-1a
+  static uint32_t hash(const char *str) {
+    uint32_t h = 2166136261u;
+    while (*str) {
+      h ^= static_cast<uint8_t>(*str++);
+      h *= 16777619u;
+    }
+    return h;
+  }
+
+  const char **_slots;
+  size_t _capacity;
+  size_t _count;
+  size_t _savedBytes;
+  size_t _maxValueLength;
+};
+}
+
+// A table of the strings shared by a JsonBuffer.
+// The template parameter CAPACITY is the number of slots, one more than the
+// number of distinct strings that can be interned.
+//
+// Usage:
+//   JsonInternTable<64> keys;
+//   jsonBuffer.setInternTable(&keys);
+template <size_t CAPACITY>
+class JsonInternTable : public Internals::InternTableBase {
+ public:
+  JsonInternTable() : Internals::InternTableBase(_slots, CAPACITY) {}
+
+ private:
+  const char *_slots[CAPACITY];
+};
+}
@@ -0,0 +1,52 @@
+// ArduinoJson - arduinojson.org
+// Copyright Benoit Blanchon 2014-2018
+// MIT License
+
+#pragma once
+
+#include <stdint.h>  // for uint32_t
+
+namespace ArduinoJson {
+namespace Internals {
+
+enum JsonTapeType {
+  JSON_TAPE_OBJECT = 1,  // extent = index of the token after the object
+  JSON_TAPE_ARRAY,       // extent = index of the token after the array
+  JSON_TAPE_STRING,      // extent = length in the input, escapes included
+  JSON_TAPE_DECODED,     // extent = length of the unescaped string
+  JSON_TAPE_LITERAL      // extent = length of the number, true, false, null
+};
+
+// One value, or one key, of a document parsed by JsonTape.
+// Eight bytes: the offset in the input shares a word with the type.
+class JsonTapeToken {
+ public:
+  static const uint32_t MAX_OFFSET = 0x1FFFFFFF;
+
+  void set(JsonTapeType type, uint32_t offset, uint32_t extent) {
+    _offsetAndType = (offset << 3) | uint32_t(type);
+    _extent = extent;
+  }
+
+  JsonTapeType type() const {
+    return JsonTapeType(_offsetAndType & 7);
+  }
+
+  uint32_t offset() const {
+    return _offsetAndType >> 3;
+  }
+
+  uint32_t extent() const {
+    return _extent;
+  }
+
+  bool isContainer() const {
+    return type() == JSON_TAPE_OBJECT || type() == JSON_TAPE_ARRAY;
+  }
+
+ private:
+  uint32_t _offsetAndType;
+  uint32_t _extent;
+};
+}
+}
@@ -14,6 +14,8 @@ namespace Internals {
 // A singly linked list of T.
 // The linked list is composed of ListNode<T>.
 // It is derived by JsonArray and JsonObject
+//
+// The list keeps its tail and its length, so add() and size() are O(1).
 template <typename T>
 class List {
  public:
@@ -27,7 +29,11 @@ class List {
   // When buffer is NULL, the List is not able to grow and success() returns
   // false. This is used to identify bad memory allocations and parsing
   // failures.
-  explicit List(JsonBuffer *buffer) : _buffer(buffer), _firstNode(NULL) {}
+  explicit List(JsonBuffer *buffer)
+      : _buffer(buffer),
+        _firstNode(NULL),
+        _lastNode(NULL),
+        _nodeCount(0) {}
 
   // Returns true if the object is valid
   // Would return false in the following situation:
@@ -40,25 +46,33 @@ class List {
   // Returns the numbers of elements in the list.
   // For a JsonObject, it would return the number of key-value pairs
   size_t size() const {
-    size_t nodeCount = 0;
-    for (node_type *node = _firstNode; node; node = node->next) nodeCount++;
-    return nodeCount;
+    return _nodeCount;
   }
 
   iterator add() {
     node_type *newNode = new (_buffer) node_type();
+    if (!newNode) return iterator(NULL);
 
-    if (_firstNode) {
-      node_type *lastNode = _firstNode;
-      while (lastNode->next) lastNode = lastNode->next;
-      lastNode->next = newNode;
+    if (_lastNode) {
+      _lastNode->next = newNode;
     } else {
       _firstNode = newNode;
     }
+    _lastNode = newNode;
+    _nodeCount++;
 
     return iterator(newNode);
   }
 
+  // Returns an iterator to the element at the specified index,
+  // or end() if the index is out of range.
+  iterator at(size_t index) {
+    return iterator(nodeAt(index, NULL, 0));
+  }
+  const_iterator at(size_t index) const {
+    return const_iterator(nodeAt(index, NULL, 0));
+  }
+
   iterator begin() {
     return iterator(_firstNode);
   }
@@ -76,19 +90,48 @@ class List {
   void remove(iterator it) {
     node_type *nodeToRemove = it._node;
     if (!nodeToRemove) return;
-    if (nodeToRemove == _firstNode) {
-      _firstNode = nodeToRemove->next;
+
+    node_type *previousNode = NULL;
+    node_type *node = _firstNode;
+    while (node && node != nodeToRemove) {
+      previousNode = node;
+      node = node->next;
+    }
+    if (!node) return;
+
+    if (previousNode) {
+      previousNode->next = nodeToRemove->next;
     } else {
-      for (node_type *node = _firstNode; node; node = node->next)
-        if (node->next == nodeToRemove) node->next = nodeToRemove->next;
+      _firstNode = nodeToRemove->next;
     }
+    if (nodeToRemove == _lastNode) _lastNode = previousNode;
+    _nodeCount--;
   }
 
  protected:
+  // Returns the node at the specified index, or NULL if the index is out of
+  // range. Walks from the head, or from a known node at an index that is
+  // not past the specified one.
+  node_type *nodeAt(size_t index, node_type *from, size_t fromIndex) const {
+    if (index >= _nodeCount) return NULL;
+    if (index == _nodeCount - 1) return _lastNode;
+
+    node_type *node = _firstNode;
+    size_t nodeIndex = 0;
+    if (from && fromIndex <= index) {
+      node = from;
+      nodeIndex = fromIndex;
+    }
+    for (; nodeIndex < index; nodeIndex++) node = node->next;
+    return node;
+  }
+
   JsonBuffer *_buffer;
 
  private:
   node_type *_firstNode;
+  node_type *_lastNode;
+  size_t _nodeCount;
 };
 }
 }
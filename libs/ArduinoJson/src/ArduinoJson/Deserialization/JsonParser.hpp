@@ -6,6 +6,8 @@
 
 #include "../JsonBuffer.hpp"
 #include "../JsonVariant.hpp"
+#include "../Polyfills/ctype.hpp"
+#include "../StringTraits/StringTraits.hpp"
 #include "../TypeTraits/IsConst.hpp"
 #include "StringWriter.hpp"
 
@@ -34,6 +36,12 @@ class JsonParser {
     return result;
   }
 
+  // Reports the document to the handler (see JsonEventHandler) instead of
+  // building a tree. Each string is given back to the writer after its
+  // event, so only the longest string and the nesting level use memory.
+  template <typename THandler>
+  bool parseEvents(THandler &handler);
+
  private:
   JsonParser &operator=(const JsonParser &);  // non-copiable
 
@@ -42,13 +50,27 @@ class JsonParser {
     return eat(_reader, charToSkip);
   }
 
-  const char *parseString();
+  const char *parseString(bool isKey = false);
+  template <typename TString>
+  void readString(TString &str);
   bool parseAnythingTo(JsonVariant *destination);
   FORCE_INLINE bool parseAnythingToUnsafe(JsonVariant *destination);
 
   inline bool parseArrayTo(JsonVariant *destination);
   inline bool parseObjectTo(JsonVariant *destination);
   inline bool parseStringTo(JsonVariant *destination);
+  static inline bool parseScalarTo(const char *s, JsonVariant *destination);
+
+  template <typename THandler>
+  bool parseAnyEvents(THandler &handler);
+  template <typename THandler>
+  bool parseNestedEvents(THandler &handler);
+  template <typename THandler>
+  inline bool parseArrayEvents(THandler &handler);
+  template <typename THandler>
+  inline bool parseObjectEvents(THandler &handler);
+  template <typename THandler>
+  inline bool parseValueEvent(THandler &handler);
 
   static inline bool isBetween(char c, char min, char max) {
     return min <= c && c <= max;
@@ -69,6 +91,17 @@ class JsonParser {
   uint8_t _nestingLimit;
 };
 
+// Appends the chars of a quoted string until the next stop char, backslash
+// or terminator. Only the in place parsing of a char* can do better than
+// readString(), which copies one char at a time.
+template <typename TReader, typename TString>
+inline void copyPlainChars(TReader &, TString &, char) {}
+
+inline void copyPlainChars(CharPointerTraits<char>::Reader &reader,
+                           StringWriter<char>::String &str, char stopChar) {
+  reader.move(str.appendPlainChars(reader.ptr(), reader.end(), stopChar));
+}
+
 template <typename TJsonBuffer, typename TString, typename Enable = void>
 struct JsonParserBuilder {
   typedef typename StringTraits<TString>::Reader InputReader;
@@ -101,7 +101,7 @@ ArduinoJson::Internals::JsonParser<TReader, TWriter>::parseObject() {
   // Read each key value pair
   for (;;) {
     // 1 - Parse key
-    const char *key = parseString();
+    const char *key = parseString(true);
     if (!key) goto ERROR_INVALID_KEY;
     if (!eat(':')) goto ERROR_MISSING_COLON;
 
@@ -140,9 +140,17 @@ inline bool ArduinoJson::Internals::JsonParser<TReader, TWriter>::parseObjectTo(
 
 template <typename TReader, typename TWriter>
 inline const char *
-ArduinoJson::Internals::JsonParser<TReader, TWriter>::parseString() {
+ArduinoJson::Internals::JsonParser<TReader, TWriter>::parseString(
+    bool isKey) {
   typename RemoveReference<TWriter>::type::String str = _writer.startString();
+  readString(str);
+  return str.intern(_buffer->internTable(), isKey);
+}
 
+template <typename TReader, typename TWriter>
+template <typename TString>
+inline void ArduinoJson::Internals::JsonParser<TReader, TWriter>::readString(
+    TString &str) {
   skipSpacesAndComments(_reader);
   char c = _reader.current();
 
@@ -150,6 +158,7 @@ ArduinoJson::Internals::JsonParser<TReader, TWriter>::parseString() {
     _reader.move();
     char stopChar = c;
     for (;;) {
+      copyPlainChars(_reader, str, stopChar);
       c = _reader.current();
       if (c == '\0') break;
       _reader.move();
@@ -173,20 +182,207 @@ ArduinoJson::Internals::JsonParser<TReader, TWriter>::parseString() {
       c = _reader.current();
     }
   }
-
-  return str.c_str();
 }
 
 template <typename TReader, typename TWriter>
 inline bool ArduinoJson::Internals::JsonParser<TReader, TWriter>::parseStringTo(
     JsonVariant *destination) {
   bool hasQuotes = isQuote(_reader.current());
-  const char *value = parseString();
-  if (value == NULL) return false;
   if (hasQuotes) {
+    const char *value = parseString();
+    if (value == NULL) return false;
     *destination = value;
+    return true;
+  }
+
+  typename RemoveReference<TWriter>::type::String str = _writer.startString();
+  readString(str);
+  const char *value = str.c_str();
+  if (value == NULL) return false;
+  if (parseScalarTo(value, destination)) {
+    // the value is in the variant, the text is not needed anymore
+    str.discard();
   } else {
     *destination = RawJson(value);
   }
   return true;
 }
+
+// Stores booleans and integers in the variant itself.
+// Returns false for the other literals (null, floats, integers that
+// overflow...) that stay unparsed. Floats keep their text so that they print
+// back exactly as they were written.
+template <typename TReader, typename TWriter>
+inline bool ArduinoJson::Internals::JsonParser<TReader, TWriter>::parseScalarTo(
+    const char *s, JsonVariant *destination) {
+  if (!strcmp(s, "true")) {
+    *destination = true;
+    return true;
+  }
+  if (!strcmp(s, "false")) {
+    *destination = false;
+    return true;
+  }
+  const char *digits = issign(*s) ? s + 1 : s;
+  if (!isdigit(*digits)) return false;
+
+  const JsonUInt maxUInt = JsonUInt(~JsonUInt(0));
+  JsonUInt value = 0;
+  while (isdigit(*digits)) {
+    JsonUInt digit = JsonUInt(*digits++ - '0');
+    if (value > (maxUInt - digit) / 10) return false;
+    value = JsonUInt(value * 10 + digit);
+  }
+  if (*digits != '\0') return false;
+
+  if (*s != '-') {
+    *destination = value;
+    return true;
+  }
+  const JsonUInt maxInteger = JsonUInt(maxUInt >> 1);
+  if (value > maxInteger + 1) return false;
+  *destination = value > maxInteger ? JsonInteger(-JsonInteger(maxInteger) - 1)
+                                    : JsonInteger(-JsonInteger(value));
+  return true;
+}
+
+template <typename TReader, typename TWriter>
+template <typename THandler>
+inline bool ArduinoJson::Internals::JsonParser<TReader, TWriter>::parseEvents(
+    THandler &handler) {
+  // An empty document is not a value, even though arrays and objects accept
+  // empty non-quoted values, like parseArray() and parseObject() do.
+  skipSpacesAndComments(_reader);
+  char c = _reader.current();
+  if (c != '[' && c != '{' && !isQuote(c) && !canBeInNonQuotedString(c))
+    return false;
+  return parseAnyEvents(handler);
+}
+
+template <typename TReader, typename TWriter>
+template <typename THandler>
+inline bool
+ArduinoJson::Internals::JsonParser<TReader, TWriter>::parseAnyEvents(
+    THandler &handler) {
+  skipSpacesAndComments(_reader);
+
+  switch (_reader.current()) {
+    case '[':
+      return parseArrayEvents(handler);
+
+    case '{':
+      return parseObjectEvents(handler);
+
+    default:
+      return parseValueEvent(handler);
+  }
+}
+
+template <typename TReader, typename TWriter>
+template <typename THandler>
+inline bool
+ArduinoJson::Internals::JsonParser<TReader, TWriter>::parseNestedEvents(
+    THandler &handler) {
+  if (_nestingLimit == 0) return false;
+  _nestingLimit--;
+  bool success = parseAnyEvents(handler);
+  _nestingLimit++;
+  return success;
+}
+
+template <typename TReader, typename TWriter>
+template <typename THandler>
+inline bool
+ArduinoJson::Internals::JsonParser<TReader, TWriter>::parseArrayEvents(
+    THandler &handler) {
+  // Check opening braket
+  if (!eat('[')) goto ERROR_MISSING_BRACKET;
+  if (!handler.startArray()) goto STOPPED_BY_HANDLER;
+  if (eat(']')) goto SUCCESS;
+
+  // Read each value
+  for (;;) {
+    // 1 - Parse value
+    if (!parseNestedEvents(handler)) goto ERROR_INVALID_VALUE;
+
+    // 2 - More values?
+    if (eat(']')) goto SUCCESS;
+    if (!eat(',')) goto ERROR_MISSING_COMMA;
+  }
+
+SUCCESS:
+  return handler.endArray();
+
+ERROR_INVALID_VALUE:
+ERROR_MISSING_BRACKET:
+ERROR_MISSING_COMMA:
+STOPPED_BY_HANDLER:
+  return false;
+}
+
+template <typename TReader, typename TWriter>
+template <typename THandler>
+inline bool
+ArduinoJson::Internals::JsonParser<TReader, TWriter>::parseObjectEvents(
+    THandler &handler) {
+  // Check opening brace
+  if (!eat('{')) goto ERROR_MISSING_BRACE;
+  if (!handler.startObject()) goto STOPPED_BY_HANDLER;
+  if (eat('}')) goto SUCCESS;
+
+  // Read each key value pair
+  for (;;) {
+    // 1 - Parse key
+    {
+      typename RemoveReference<TWriter>::type::String str =
+          _writer.startString();
+      readString(str);
+      const char *key = str.c_str();
+      if (!key) goto ERROR_INVALID_KEY;
+      bool accepted = handler.key(key);
+      str.discard();
+      if (!accepted) goto STOPPED_BY_HANDLER;
+    }
+    if (!eat(':')) goto ERROR_MISSING_COLON;
+
+    // 2 - Parse value
+    if (!parseNestedEvents(handler)) goto ERROR_INVALID_VALUE;
+
+    // 3 - More keys/values?
+    if (eat('}')) goto SUCCESS;
+    if (!eat(',')) goto ERROR_MISSING_COMMA;
+  }
+
+SUCCESS:
+  return handler.endObject();
+
+ERROR_INVALID_KEY:
+ERROR_INVALID_VALUE:
+ERROR_MISSING_BRACE:
+ERROR_MISSING_COLON:
+ERROR_MISSING_COMMA:
+STOPPED_BY_HANDLER:
+  return false;
+}
+
+template <typename TReader, typename TWriter>
+template <typename THandler>
+inline bool
+ArduinoJson::Internals::JsonParser<TReader, TWriter>::parseValueEvent(
+    THandler &handler) {
+  bool hasQuotes = isQuote(_reader.current());
+  typename RemoveReference<TWriter>::type::String str = _writer.startString();
+  readString(str);
+  const char *value = str.c_str();
+  if (value == NULL) return false;
+
+  JsonVariant variant;
+  if (hasQuotes) {
+    variant = value;
+  } else if (!parseScalarTo(value, &variant)) {
+    variant = RawJson(value);
+  }
+  bool accepted = handler.value(variant);
+  str.discard();
+  return accepted;
+}
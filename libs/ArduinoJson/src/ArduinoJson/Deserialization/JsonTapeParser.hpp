@@ -0,0 +1,168 @@
+// ArduinoJson - arduinojson.org
+// Copyright Benoit Blanchon 2014-2018
+// MIT License
+
+#pragma once
+
+#include "../Data/JsonTapeToken.hpp"
+#include "Comments.hpp"
+
+namespace ArduinoJson {
+namespace Internals {
+
+// Makes the structural pass of JsonTape: records where each value starts and
+// ends, but neither converts numbers nor unescapes strings.
+// This internal class is not indended to be used directly.
+class JsonTapeParser {
+ public:
+  JsonTapeParser(const char *json, JsonTapeToken *tokens, size_t capacity,
+                 uint8_t nestingLimit)
+      : _json(json),
+        _reader(json),
+        _tokens(tokens),
+        _capacity(capacity),
+        _size(0),
+        _nestingLimit(nestingLimit) {}
+
+  // Returns the number of tokens, or 0 if the input is invalid or if the
+  // tape is too small
+  size_t parse() {
+    return parseValue() ? _size : 0;
+  }
+
+ private:
+  class Reader {
+   public:
+    Reader(const char *ptr) : _ptr(ptr) {}
+
+    void move() {
+      ++_ptr;
+    }
+
+    char current() const {
+      return _ptr[0];
+    }
+
+    char next() const {
+      return _ptr[1];
+    }
+
+    const char *ptr() const {
+      return _ptr;
+    }
+
+   private:
+    const char *_ptr;
+  };
+
+  bool eat(char charToSkip) {
+    skipSpacesAndComments(_reader);
+    if (_reader.current() != charToSkip) return false;
+    _reader.move();
+    return true;
+  }
+
+  JsonTapeToken *addToken() {
+    if (_size >= _capacity) return NULL;
+    return &_tokens[_size++];
+  }
+
+  uint32_t offset() const {
+    return uint32_t(_reader.ptr() - _json);
+  }
+
+  bool parseValue() {
+    skipSpacesAndComments(_reader);
+    switch (_reader.current()) {
+      case '[':
+        return parseContainer(JSON_TAPE_ARRAY, ']');
+      case '{':
+        return parseContainer(JSON_TAPE_OBJECT, '}');
+      default:
+        return parseString();
+    }
+  }
+
+  bool parseNestedValue() {
+    if (_nestingLimit == 0) return false;
+    _nestingLimit--;
+    bool success = parseValue();
+    _nestingLimit++;
+    return success;
+  }
+
+  bool parseContainer(JsonTapeType type, char closing) {
+    JsonTapeToken *token = addToken();
+    if (!token) return false;
+    uint32_t start = offset();
+    _reader.move();
+
+    if (!eat(closing)) {
+      for (;;) {
+        if (type == JSON_TAPE_OBJECT) {
+          skipSpacesAndComments(_reader);
+          if (!parseString()) return false;
+          if (!eat(':')) return false;
+        }
+        if (!parseNestedValue()) return false;
+        if (eat(closing)) break;
+        if (!eat(',')) return false;
+      }
+    }
+
+    token->set(type, start, uint32_t(_size));
+    return true;
+  }
+
+  bool parseString() {
+    char c = _reader.current();
+    if (c == '\"' || c == '\'') {
+      char stopChar = c;
+      _reader.move();
+      uint32_t start = offset();
+      for (;;) {
+        c = _reader.current();
+        if (c == '\0') return false;
+        if (c == stopChar) break;
+        if (c == '\\') {
+          _reader.move();
+          if (_reader.current() == '\0') return false;
+        }
+        _reader.move();
+      }
+      return addToken(JSON_TAPE_STRING, start, offset() - start, true);
+    }
+
+    uint32_t start = offset();
+    while (canBeInNonQuotedString(_reader.current())) _reader.move();
+    if (offset() == start) return false;
+    return addToken(JSON_TAPE_LITERAL, start, offset() - start, false);
+  }
+
+  bool addToken(JsonTapeType type, uint32_t start, uint32_t length,
+                bool skipQuote) {
+    JsonTapeToken *token = addToken();
+    if (!token || start > JsonTapeToken::MAX_OFFSET) return false;
+    token->set(type, start, length);
+    if (skipQuote) _reader.move();
+    return true;
+  }
+
+  static inline bool isBetween(char c, char min, char max) {
+    return min <= c && c <= max;
+  }
+
+  static inline bool canBeInNonQuotedString(char c) {
+    return isBetween(c, '0', '9') || isBetween(c, '_', 'z') ||
+           isBetween(c, 'A', 'Z') || c == '+' || c == '-' || c == '.';
+  }
+
+  const char *_json;
+  Reader _reader;
+  JsonTapeToken *_tokens;
+  size_t _capacity;
+  size_t _size;
+  uint8_t _nestingLimit;
+};
+}
+}
@@ -4,6 +4,9 @@
 
 #pragma once
 
+#include "../Data/InternTable.hpp"
+#include "../Polyfills/swar.hpp"
+
 namespace ArduinoJson {
 namespace Internals {
 
@@ -18,11 +21,30 @@ class StringWriter {
       *(*_writePtr)++ = TChar(c);
     }
 
+    // Copies the chars of the input until the next stop char, backslash or
+    // terminator, and returns their number. end is the terminator of the
+    // input, or NULL if it's not known yet (see swarCopyPlainChars()).
+    // The input is the same buffer, further on, so copying forward is safe.
+    size_t appendPlainChars(const char* s, const char*& end, char stopChar) {
+      size_t count = swarCopyPlainChars(reinterpret_cast<char*>(*_writePtr), s,
+                                        end, stopChar, '\\');
+      *_writePtr += count;
+      return count;
+    }
+
     const char* c_str() const {
       *(*_writePtr)++ = 0;
       return reinterpret_cast<const char*>(_startPtr);
     }
 
+    // The string is written in place, there is nothing to give back.
+    void discard() const {}
+
+    // The string is written in place, so sharing it would save nothing.
+    const char* intern(InternTableBase*, bool) const {
+      return c_str();
+    }
+
    private:
     TChar** _writePtr;
     TChar* _startPtr;
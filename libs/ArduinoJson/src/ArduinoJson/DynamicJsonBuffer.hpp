@@ -77,6 +77,7 @@ class DynamicJsonBufferBase
       currentBlock = nextBlock;
     }
     _head = 0;
+    if (this->_internTable) this->_internTable->clear();
   }
 
   class String {
@@ -104,6 +105,21 @@ class DynamicJsonBufferBase
       return _start;
     }
 
+    // Gives the string back to the buffer, after c_str().
+    void discard() {
+      if (_start) _parent->_head->size -= _length;
+    }
+
+    // Same as c_str(), but returns the interned copy of the string, if any,
+    // and then gives this one back to the buffer.
+    const char* intern(InternTableBase* table, bool isKey) {
+      const char* str = c_str();
+      if (!str || !table) return str;
+      const char* interned = table->intern(str, _length - 1, isKey);
+      if (interned != str) _parent->_head->size -= _length;
+      return interned;
+    }
+
    private:
     DynamicJsonBufferBase* _parent;
     char* _start;
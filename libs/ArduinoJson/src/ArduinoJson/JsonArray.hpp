@@ -46,7 +46,9 @@ class JsonArray : public Internals::JsonPrintable<JsonArray>,
   // You should not call this constructor directly.
   // Instead, use JsonBuffer::createArray() or JsonBuffer::parseArray().
   explicit JsonArray(JsonBuffer *buffer) throw()
-      : Internals::List<JsonVariant>(buffer) {}
+      : Internals::List<JsonVariant>(buffer),
+        _cursorNode(NULL),
+        _cursorIndex(0) {}
 
   // Gets the value at the specified index
   const Internals::JsonArraySubscript operator[](size_t index) const;
@@ -107,14 +109,14 @@ class JsonArray : public Internals::JsonPrintable<JsonArray>,
   // Gets the value at the specified index.
   template <typename T>
   typename Internals::JsonVariantAs<T>::type get(size_t index) const {
-    const_iterator it = begin() += index;
+    const_iterator it = at(index);
     return it != end() ? it->as<T>() : Internals::JsonVariantDefault<T>::get();
   }
 
   // Check the type of the value at specified index.
   template <typename T>
   bool is(size_t index) const {
-    const_iterator it = begin() += index;
+    const_iterator it = at(index);
     return it != end() ? it->is<T>() : false;
   }
 
@@ -126,11 +128,27 @@ class JsonArray : public Internals::JsonPrintable<JsonArray>,
   // It's a shortcut for JsonBuffer::createObject() and JsonArray::add()
   JsonObject &createNestedObject();
 
+  // Returns an iterator to the element at the specified index,
+  // or end() if the index is out of range.
+  // The array remembers the last node reached by index, so that a loop over
+  // increasing indexes, or repeated accesses to the same index, don't walk
+  // from the head every time.
+  iterator at(size_t index) {
+    return iterator(cursorAt(index));
+  }
+  const_iterator at(size_t index) const {
+    return const_iterator(cursorAt(index));
+  }
+
   // Removes element at specified index.
   void remove(size_t index) {
-    remove(begin() += index);
+    remove(at(index));
+  }
+  void remove(iterator it) {
+    Internals::List<JsonVariant>::remove(it);
+    _cursorNode = NULL;
+    _cursorIndex = 0;
   }
-  using Internals::List<JsonVariant>::remove;
 
   // Returns a reference an invalid JsonArray.
   // This object is meant to replace a NULL pointer.
@@ -201,9 +219,18 @@ class JsonArray : public Internals::JsonPrintable<JsonArray>,
 #endif
 
  private:
+  node_type *cursorAt(size_t index) const {
+    node_type *node = nodeAt(index, _cursorNode, _cursorIndex);
+    if (node) {
+      _cursorNode = node;
+      _cursorIndex = index;
+    }
+    return node;
+  }
+
   template <typename TValueRef>
   bool set_impl(size_t index, TValueRef value) {
-    iterator it = begin() += index;
+    iterator it = at(index);
     if (it == end()) return false;
     return Internals::ValueSaver<TValueRef>::save(_buffer, *it, value);
   }
@@ -214,6 +241,9 @@ class JsonArray : public Internals::JsonPrintable<JsonArray>,
     if (it == end()) return false;
     return Internals::ValueSaver<TValueRef>::save(_buffer, *it, value);
   }
+
+  mutable node_type *_cursorNode;
+  mutable size_t _cursorIndex;
 };
 
 namespace Internals {
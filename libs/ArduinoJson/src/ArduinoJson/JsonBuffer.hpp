@@ -8,11 +8,22 @@
 #include <stdint.h>  // for uint8_t
 #include <string.h>
 
+#include "Data/InternTable.hpp"
 #include "Data/NonCopyable.hpp"
 #include "JsonVariant.hpp"
 #include "TypeTraits/EnableIf.hpp"
 #include "TypeTraits/IsArray.hpp"
 
+// Returns the size (in bytes) of a string of n characters copied in a
+// JsonBuffer, including the terminator and the padding of the next node.
+// Numbers and booleans are stored in the nodes, they need no string.
+#if ARDUINOJSON_ENABLE_ALIGNMENT
+#define JSON_STRING_SIZE(LENGTH) \
+  (((LENGTH) + sizeof(void *)) & ~(sizeof(void *) - 1))
+#else
+#define JSON_STRING_SIZE(LENGTH) ((LENGTH) + 1)
+#endif
+
 namespace ArduinoJson {
 class JsonArray;
 class JsonObject;
@@ -59,7 +70,21 @@ class JsonBuffer : Internals::NonCopyable {
   // Return a pointer to the allocated memory or NULL if allocation fails.
   virtual void *alloc(size_t size) = 0;
 
+  // Makes the parser share one copy of the keys that repeat, and of the
+  // short values if the table allows it.
+  // The table must live as long as the JsonBuffer, or until
+  // setInternTable(NULL) is called.
+  void setInternTable(Internals::InternTableBase *table) {
+    _internTable = table;
+  }
+
+  Internals::InternTableBase *internTable() const {
+    return _internTable;
+  }
+
  protected:
+  JsonBuffer() : _internTable(NULL) {}
+
   // CAUTION: NO VIRTUAL DESTRUCTOR!
   // If we add a virtual constructor the Arduino compiler will add malloc()
   // and free() to the binary, adding 706 useless bytes.
@@ -74,5 +99,7 @@ class JsonBuffer : Internals::NonCopyable {
     return bytes;
 #endif
   }
+
+  Internals::InternTableBase *_internTable;
 };
 }
@@ -115,6 +115,44 @@ class JsonBufferBase : public JsonBuffer {
     return Internals::makeParser(that(), json, nestingLimit).parseVariant();
   }
 
+  // Parses a JSON string without building a tree: the handler receives an
+  // event for each array, object, key and value (see JsonEventHandler).
+  //
+  // Strings are copied in the buffer only for the time of their event, so a
+  // small StaticJsonBuffer is enough for documents of any size. The memory
+  // used is the longest string plus the recursion of the nesting levels.
+  //
+  // Returns false if the JSON is invalid, if a string doesn't fit in the
+  // buffer, or if the handler stopped the parsing.
+  //
+  // bool parseEvents(TString, THandler&);
+  // TString = const std::string&, const String&
+  template <typename TString, typename THandler>
+  typename Internals::EnableIf<!Internals::IsArray<TString>::value, bool>::type
+  parseEvents(const TString &json, THandler &handler,
+              uint8_t nestingLimit = ARDUINOJSON_DEFAULT_NESTING_LIMIT) {
+    return Internals::makeParser(that(), json, nestingLimit)
+        .parseEvents(handler);
+  }
+  //
+  // bool parseEvents(TString, THandler&);
+  // TString = const char*, const char[N], const FlashStringHelper*
+  template <typename TString, typename THandler>
+  bool parseEvents(TString *json, THandler &handler,
+                   uint8_t nestingLimit = ARDUINOJSON_DEFAULT_NESTING_LIMIT) {
+    return Internals::makeParser(that(), json, nestingLimit)
+        .parseEvents(handler);
+  }
+  //
+  // bool parseEvents(TString, THandler&);
+  // TString = std::istream&, Stream&
+  template <typename TString, typename THandler>
+  bool parseEvents(TString &json, THandler &handler,
+                   uint8_t nestingLimit = ARDUINOJSON_DEFAULT_NESTING_LIMIT) {
+    return Internals::makeParser(that(), json, nestingLimit)
+        .parseEvents(handler);
+  }
+
  protected:
   ~JsonBufferBase() {}
 
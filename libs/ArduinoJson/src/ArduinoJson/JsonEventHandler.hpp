@@ -0,0 +1,45 @@
+// ArduinoJson - arduinojson.org
+// Copyright Benoit Blanchon 2014-2018
+// MIT License
+
+#pragma once
+
+#include "JsonVariant.hpp"
+
+namespace ArduinoJson {
+
+// Receives the events of JsonBuffer::parseEvents().
+//
+// Derive from this class and hide the functions you need; the handler is a
+// template argument, so there is no virtual call. Return false from any
+// function to stop the parsing.
+//
+// The strings passed to key() and value() are only valid during the call.
+// Integers and booleans are parsed, floats and null come as RawJson text
+// that as<float>() and friends convert.
+struct JsonEventHandler {
+  bool startObject() {
+    return true;
+  }
+
+  bool endObject() {
+    return true;
+  }
+
+  bool startArray() {
+    return true;
+  }
+
+  bool endArray() {
+    return true;
+  }
+
+  bool key(const char *) {
+    return true;
+  }
+
+  bool value(const JsonVariant &) {
+    return true;
+  }
+};
+}
@@ -0,0 +1,258 @@
+// ArduinoJson - arduinojson.org
+// Copyright Benoit Blanchon 2014-2018
+// MIT License
+
+#pragma once
+
+#include <stddef.h>  // for size_t, offsetof
+#include <stdint.h>  // for uint8_t
+#include <string.h>
+
+#include "Configuration.hpp"
+#include "JsonEventHandler.hpp"
+#include "JsonVariant.hpp"
+
+namespace ArduinoJson {
+
+// Describes a member of a struct and where to find its value in a document.
+// Use JSON_FIELD() to fill it.
+struct JsonField {
+  const char *path;
+  size_t offset;
+  uint8_t type;
+  size_t size;
+};
+
+namespace Internals {
+enum JsonFieldType {
+  JSON_FIELD_BOOL = 1,
+  JSON_FIELD_INT,
+  JSON_FIELD_UINT,
+  JSON_FIELD_LONG,
+  JSON_FIELD_ULONG,
+  JSON_FIELD_FLOAT,
+  JSON_FIELD_DOUBLE,
+  JSON_FIELD_STRING
+};
+
+// Only used in sizeof(), to turn the type of a member into a JsonFieldType
+template <int TYPE>
+struct JsonFieldTag {
+  char value[TYPE];
+};
+JsonFieldTag<JSON_FIELD_BOOL> &jsonFieldTag(bool &);
+JsonFieldTag<JSON_FIELD_INT> &jsonFieldTag(int &);
+JsonFieldTag<JSON_FIELD_UINT> &jsonFieldTag(unsigned int &);
+JsonFieldTag<JSON_FIELD_LONG> &jsonFieldTag(long &);
+JsonFieldTag<JSON_FIELD_ULONG> &jsonFieldTag(unsigned long &);
+JsonFieldTag<JSON_FIELD_FLOAT> &jsonFieldTag(float &);
+JsonFieldTag<JSON_FIELD_DOUBLE> &jsonFieldTag(double &);
+template <size_t N>
+JsonFieldTag<JSON_FIELD_STRING> &jsonFieldTag(char (&)[N]);
+}  // namespace Internals
+}  // namespace ArduinoJson
+
+// Describes the member MEMBER of the struct TYPE, found at PATH.
+// A path is a list of keys separated by dots, with [i] for array elements:
+// "main.temp" or "list[4].wind.deg".
+// Supported members: bool, int, unsigned, long, unsigned long, float, double
+// and char arrays. TYPE must be a plain struct (offsetof() is used).
+#define JSON_FIELD(TYPE, MEMBER, PATH)                                    \
+  {                                                                       \
+    PATH, offsetof(TYPE, MEMBER),                                         \
+        sizeof(ArduinoJson::Internals::jsonFieldTag(                      \
+            static_cast<TYPE *>(0)->MEMBER)),                             \
+        sizeof(static_cast<TYPE *>(0)->MEMBER)                            \
+  }
+
+namespace ArduinoJson {
+
+// Decodes a document straight into a struct, without building the tree.
+//
+//   struct Weather { long dt; float temp; char name[16]; };
+//   const JsonField weatherFields[] = {
+//       JSON_FIELD(Weather, dt, "dt"),
+//       JSON_FIELD(Weather, temp, "main.temp"),
+//       JSON_FIELD(Weather, name, "name")};
+//
+//   Weather weather = {};
+//   JsonStructReader reader(&weather, weatherFields);
+//   bool ok = jsonBuffer.parseEvents(json, reader);
+//
+// Values that match no field are skipped, members that are not in the
+// document keep the value they had. Strings are truncated to fit.
+class JsonStructReader : public JsonEventHandler {
+ public:
+  template <typename TStruct, size_t N>
+  JsonStructReader(TStruct *destination, const JsonField (&fields)[N])
+      : _destination(destination), _fields(fields), _fieldsCount(N) {
+    reset();
+  }
+
+  // Number of values that were stored in the struct
+  size_t count() const {
+    return _count;
+  }
+
+  void reset() {
+    _count = 0;
+    _depth = 0;
+    _pathLength = 0;
+    _path[0] = '\0';
+  }
+
+  bool startObject() {
+    enter(false);
+    return true;
+  }
+
+  bool startArray() {
+    enter(true);
+    return true;
+  }
+
+  bool endObject() {
+    _depth--;
+    return true;
+  }
+
+  bool endArray() {
+    _depth--;
+    return true;
+  }
+
+  bool key(const char *key) {
+    if (!moveToParent()) return true;
+    if (_pathLength > 0) append(".");
+    append(key);
+    return true;
+  }
+
+  bool value(const JsonVariant &value) {
+    if (_depth > ARDUINOJSON_STRUCT_MAX_DEPTH) return true;
+    beginElement();
+    if (_pathLength == INVALID_PATH) return true;
+    for (size_t i = 0; i < _fieldsCount; i++) {
+      if (strcmp(_fields[i].path, _path)) continue;
+      store(_fields[i], value);
+      _count++;
+      break;
+    }
+    return true;
+  }
+
+ private:
+  static const uint8_t INVALID_PATH = 0xFF;
+
+  struct Level {
+    uint8_t pathLength;
+    bool isArray;
+    uint16_t index;
+  };
+
+  void enter(bool isArray) {
+    beginElement();
+    if (_depth < ARDUINOJSON_STRUCT_MAX_DEPTH) {
+      Level &level = _levels[_depth];
+      level.pathLength = _pathLength;
+      level.isArray = isArray;
+      level.index = 0;
+    }
+    _depth++;
+  }
+
+  // Restores the path of the current container.
+  // Returns false if it cannot be matched.
+  bool moveToParent() {
+    if (_depth == 0 || _depth > ARDUINOJSON_STRUCT_MAX_DEPTH) {
+      _pathLength = INVALID_PATH;
+      return false;
+    }
+    _pathLength = _levels[_depth - 1].pathLength;
+    if (_pathLength == INVALID_PATH) return false;
+    _path[_pathLength] = '\0';
+    return true;
+  }
+
+  // Appends [i] to the path of an array element
+  void beginElement() {
+    if (_depth == 0 || _depth > ARDUINOJSON_STRUCT_MAX_DEPTH) return;
+    Level &level = _levels[_depth - 1];
+    if (!level.isArray) return;
+    uint16_t index = level.index++;
+    if (!moveToParent()) return;
+
+    char digits[8];
+    char *p = digits + sizeof(digits);
+    *--p = '\0';
+    *--p = ']';
+    do {
+      *--p = char('0' + index % 10);
+      index = uint16_t(index / 10);
+    } while (index);
+    *--p = '[';
+    append(p);
+  }
+
+  void append(const char *s) {
+    if (_pathLength == INVALID_PATH) return;
+    size_t length = strlen(s);
+    if (_pathLength + length >= ARDUINOJSON_STRUCT_PATH_SIZE) {
+      _pathLength = INVALID_PATH;
+      return;
+    }
+    memcpy(_path + _pathLength, s, length + 1);
+    _pathLength = uint8_t(_pathLength + length);
+  }
+
+  template <typename T>
+  static void store(void *member, T value) {
+    memcpy(member, &value, sizeof(T));
+  }
+
+  void store(const JsonField &field, const JsonVariant &value) {
+    void *member = static_cast<char *>(_destination) + field.offset;
+    switch (field.type) {
+      case Internals::JSON_FIELD_BOOL:
+        store(member, value.as<bool>());
+        break;
+      case Internals::JSON_FIELD_INT:
+        store(member, value.as<int>());
+        break;
+      case Internals::JSON_FIELD_UINT:
+        store(member, value.as<unsigned int>());
+        break;
+      case Internals::JSON_FIELD_LONG:
+        store(member, value.as<long>());
+        break;
+      case Internals::JSON_FIELD_ULONG:
+        store(member, value.as<unsigned long>());
+        break;
+      case Internals::JSON_FIELD_FLOAT:
+        store(member, value.as<float>());
+        break;
+      case Internals::JSON_FIELD_DOUBLE:
+        store(member, value.as<double>());
+        break;
+      case Internals::JSON_FIELD_STRING: {
+        const char *s = value.as<const char *>();
+        char *dest = static_cast<char *>(member);
+        size_t length = s ? strlen(s) : 0;
+        if (length >= field.size) length = field.size - 1;
+        if (length) memcpy(dest, s, length);
+        dest[length] = '\0';
+        break;
+      }
+    }
+  }
+
+  void *_destination;
+  const JsonField *_fields;
+  size_t _fieldsCount;
+  size_t _count;
+  size_t _depth;
+  uint8_t _pathLength;
+  char _path[ARDUINOJSON_STRUCT_PATH_SIZE];
+  Level _levels[ARDUINOJSON_STRUCT_MAX_DEPTH];
+};
+}
@@ -0,0 +1,207 @@
+// ArduinoJson - arduinojson.org
+// Copyright Benoit Blanchon 2014-2018
+// MIT License
+
+#pragma once
+
+#include <stddef.h>  // for size_t
+#include <string.h>
+
+#include "Configuration.hpp"
+#include "Data/Encoding.hpp"
+#include "Data/JsonTapeToken.hpp"
+#include "Data/JsonVariantAs.hpp"
+#include "Deserialization/JsonTapeParser.hpp"
+#include "JsonVariant.hpp"
+
+namespace ArduinoJson {
+
+class JsonTape;
+
+// A value of a document parsed by JsonTape.
+//
+// It's only an index in the tape: numbers are converted and strings are
+// unescaped when as<T>() is called, subscripts skip the values they don't
+// need without looking at them.
+class JsonTapeValue {
+ public:
+  JsonTapeValue() : _tape(NULL), _index(0) {}
+  JsonTapeValue(JsonTape *tape, size_t index) : _tape(tape), _index(index) {}
+
+  bool success() const {
+    return _tape != NULL;
+  }
+
+  bool isObject() const {
+    return success() && token().type() == Internals::JSON_TAPE_OBJECT;
+  }
+
+  bool isArray() const {
+    return success() && token().type() == Internals::JSON_TAPE_ARRAY;
+  }
+
+  // Returns the number of elements of an array or an object, 0 otherwise
+  size_t size() const;
+
+  // Returns the element at the specified index of an array
+  JsonTapeValue operator[](size_t index) const;
+  JsonTapeValue operator[](int index) const {
+    return operator[](size_t(index));
+  }
+
+  // Returns the value associated with the specified key of an object
+  JsonTapeValue operator[](const char *key) const;
+
+  // Decodes the value.
+  // Strings are const char*, numbers, true, false and null are RawJson that
+  // JsonVariant converts on demand. Arrays and objects give an undefined
+  // variant: use the subscripts.
+  JsonVariant variant() const;
+
+  template <typename T>
+  typename Internals::JsonVariantAs<T>::type as() const {
+    return variant().as<T>();
+  }
+
+  template <typename T>
+  bool is() const {
+    return variant().is<T>();
+  }
+
+  template <typename T>
+  operator T() const {
+    return as<T>();
+  }
+
+ private:
+  const Internals::JsonTapeToken &token() const;
+
+  // Returns the index of the value after this one, skipping the nested ones
+  size_t next(size_t index) const;
+
+  JsonTape *_tape;
+  size_t _index;
+};
+
+// Parses a document in place, with one structural pass that records where
+// each value is. Faster than a JsonBuffer when only a few values of a big
+// document are read.
+//
+// The input must be writable and must stay alive as long as the values are
+// used: the strings are unescaped in place when they are read.
+class JsonTape {
+ public:
+  JsonTape(Internals::JsonTapeToken *tokens, size_t capacity)
+      : _json(NULL), _tokens(tokens), _capacity(capacity), _size(0) {}
+
+  // Returns the root of the document, or a value whose success() is false if
+  // the input is invalid or if the tape is too small.
+  JsonTapeValue parse(char *json,
+                      uint8_t nestingLimit = ARDUINOJSON_DEFAULT_NESTING_LIMIT) {
+    _json = json;
+    _size = json ? Internals::JsonTapeParser(json, _tokens, _capacity,
+                                             nestingLimit)
+                       .parse()
+                 : 0;
+    return _size ? JsonTapeValue(this, 0) : JsonTapeValue();
+  }
+
+  // Gets the number of tokens used by the last document
+  size_t size() const {
+    return _size;
+  }
+
+  size_t capacity() const {
+    return _capacity;
+  }
+
+ private:
+  friend class JsonTapeValue;
+
+  // Terminates the string and unescapes it the first time.
+  const char *decode(size_t index) {
+    Internals::JsonTapeToken &token = _tokens[index];
+    char *text = _json + token.offset();
+    if (token.type() == Internals::JSON_TAPE_STRING) {
+      const char *src = text;
+      const char *end = text + token.extent();
+      char *dst = text;
+      while (src < end) {
+        char c = *src++;
+        if (c == '\\') c = Internals::Encoding::unescapeChar(*src++);
+        *dst++ = c;
+      }
+      token.set(Internals::JSON_TAPE_DECODED, token.offset(),
+                uint32_t(dst - text));
+    }
+    text[token.extent()] = '\0';
+    return text;
+  }
+
+  char *_json;
+  Internals::JsonTapeToken *_tokens;
+  size_t _capacity;
+  size_t _size;
+};
+
+// A JsonTape with room for CAPACITY values and keys.
+template <size_t CAPACITY>
+class StaticJsonTape : public JsonTape {
+ public:
+  StaticJsonTape() : JsonTape(_tokens, CAPACITY) {}
+
+ private:
+  Internals::JsonTapeToken _tokens[CAPACITY];
+};
+
+inline const Internals::JsonTapeToken &JsonTapeValue::token() const {
+  return _tape->_tokens[_index];
+}
+
+inline size_t JsonTapeValue::next(size_t index) const {
+  const Internals::JsonTapeToken &t = _tape->_tokens[index];
+  return t.isContainer() ? t.extent() : index + 1;
+}
+
+inline size_t JsonTapeValue::size() const {
+  if (!isObject() && !isArray()) return 0;
+  size_t count = 0;
+  size_t end = token().extent();
+  for (size_t i = _index + 1; i < end; i = next(i)) {
+    if (isObject()) i++;  // skip the key
+    count++;
+  }
+  return count;
+}
+
+inline JsonTapeValue JsonTapeValue::operator[](size_t index) const {
+  if (!isArray()) return JsonTapeValue();
+  size_t end = token().extent();
+  for (size_t i = _index + 1; i < end; i = next(i)) {
+    if (index-- == 0) return JsonTapeValue(_tape, i);
+  }
+  return JsonTapeValue();
+}
+
+inline JsonTapeValue JsonTapeValue::operator[](const char *key) const {
+  if (!isObject() || !key) return JsonTapeValue();
+  size_t end = token().extent();
+  for (size_t i = _index + 1; i < end; i = next(i + 1)) {
+    if (!strcmp(_tape->decode(i), key)) return JsonTapeValue(_tape, i + 1);
+  }
+  return JsonTapeValue();
+}
+
+inline JsonVariant JsonTapeValue::variant() const {
+  if (!success()) return JsonVariant();
+  switch (token().type()) {
+    case Internals::JSON_TAPE_STRING:
+    case Internals::JSON_TAPE_DECODED:
+      return JsonVariant(_tape->decode(_index));
+    case Internals::JSON_TAPE_LITERAL:
+      return JsonVariant(RawJson(_tape->decode(_index)));
+    default:
+      return JsonVariant();
+  }
+}
+}
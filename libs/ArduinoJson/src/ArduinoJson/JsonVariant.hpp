@@ -90,7 +90,8 @@ class JsonVariant : public Internals::JsonVariantBase<JsonVariant> {
       _content.asInteger = static_cast<JsonUInt>(value);
     } else {
       _type = JSON_NEGATIVE_INTEGER;
-      _content.asInteger = static_cast<JsonUInt>(-value);
+      // negate in unsigned, -value overflows for the smallest integer
+      _content.asInteger = JsonUInt(JsonUInt(0) - static_cast<JsonUInt>(value));
     }
   }
   // JsonVariant(unsigned short)
@@ -0,0 +1,86 @@
+// ArduinoJson - arduinojson.org
+// Copyright Benoit Blanchon 2014-2018
+// MIT License
+
+#pragma once
+
+#include <stddef.h>  // for size_t
+#include <string.h>  // for memcpy, strlen
+
+#include "attributes.hpp"
+
+namespace ArduinoJson {
+namespace Internals {
+
+// "SIMD within a register": tests the 4 or 8 chars of a machine word at once.
+// Plain C++, the word is as wide as a pointer.
+typedef size_t swar_word;
+
+// Returns a word where every byte is c
+inline swar_word swarRepeat(unsigned char c) {
+  return swar_word(swar_word(-1) / 255 * c);
+}
+
+// Returns a word with the high bit set in each zero byte of x, and only there
+inline swar_word swarZeroBytes(swar_word x) {
+  const swar_word low7 = swarRepeat(0x7F);
+  return swar_word(~(((x & low7) + low7) | x | low7));
+}
+
+// Returns a word with the high bit set in each byte of x equal to c
+inline swar_word swarEqualBytes(swar_word x, char c) {
+  return swarZeroBytes(x ^ swarRepeat(static_cast<unsigned char>(c)));
+}
+
+// Reads a word. The caller makes sure the whole word is before the end of the
+// input: a word that straddles the terminator would read past the buffer.
+inline swar_word swarLoad(const char *p) {
+  swar_word word;
+  memcpy(&word, p, sizeof(word));
+  return word;
+}
+
+inline bool swarIsAligned(const char *p) {
+  return (reinterpret_cast<size_t>(p) & (sizeof(swar_word) - 1)) == 0;
+}
+
+// Most keys, values and indentations are short: the first chars are tested one
+// by one, the words are only worth it for the long runs.
+const size_t SWAR_MIN_RUN = 2 * sizeof(swar_word);
+
+inline bool isPlainChar(char c, char stop1, char stop2) {
+  return c != stop1 && c != stop2 && c != '\0';
+}
+
+// Copies the chars before the first stop1, stop2 or terminator, and returns
+// their number. dst may overlap src, as long as it's not after src.
+// end points to the terminator of src. It may be NULL, then it's only looked
+// for, and stored, when a string is long enough to be copied by words.
+// Inlined in readString(), the short strings would pay for a call otherwise.
+inline FORCE_INLINE size_t swarCopyPlainChars(char *dst, const char *src,
+                                              const char *&end, char stop1,
+                                              char stop2) {
+  const char *p = src;
+  for (size_t i = 0; i < SWAR_MIN_RUN; i++) {
+    if (!isPlainChar(*p, stop1, stop2)) return size_t(p - src);
+    *dst++ = *p++;
+  }
+  while (!swarIsAligned(p)) {
+    if (!isPlainChar(*p, stop1, stop2)) return size_t(p - src);
+    *dst++ = *p++;
+  }
+  if (!end) end = p + strlen(p);
+  while (size_t(end - p) >= sizeof(swar_word)) {
+    swar_word word = swarLoad(p);
+    if (swarZeroBytes(word) | swarEqualBytes(word, stop1) |
+        swarEqualBytes(word, stop2))
+      break;
+    memcpy(dst, &word, sizeof(word));
+    dst += sizeof(word);
+    p += sizeof(word);
+  }
+  while (isPlainChar(*p, stop1, stop2)) *dst++ = *p++;
+  return size_t(p - src);
+}
+}
+}
@@ -0,0 +1,65 @@
+// ArduinoJson - arduinojson.org
+// Copyright Benoit Blanchon 2014-2018
+// MIT License
+
+#pragma once
+
+#include <stddef.h>  // for size_t
+#include <stdint.h>  // for uint8_t
+
+namespace ArduinoJson {
+namespace Internals {
+
+// A Print implementation that fills a block provided by the caller and sends
+// it to the destination with one write(const uint8_t*, size_t) per block,
+// instead of one write per char. Used in JsonPrintable::printTo(destination,
+// block) for files and sockets.
+template <typename TDestination>
+class BufferedPrint {
+ public:
+  BufferedPrint(TDestination &destination, char *block, size_t blockSize)
+      : _destination(destination),
+        _block(block),
+        _blockSize(blockSize),
+        _length(0),
+        _ok(true) {}
+
+  ~BufferedPrint() {
+    flush();
+  }
+
+  size_t print(char c) {
+    if (_length == _blockSize) flush();
+    _block[_length++] = c;
+    return 1;
+  }
+
+  size_t print(const char *s) {
+    size_t n = 0;
+    while (s[n]) print(s[n++]);
+    return n;
+  }
+
+  // Sends the pending chars to the destination.
+  // Returns false if a write came back short, now or before.
+  bool flush() {
+    if (_length > 0) {
+      const uint8_t *bytes = reinterpret_cast<const uint8_t *>(_block);
+      if (_destination.write(bytes, _length) != _length) _ok = false;
+      _length = 0;
+    }
+    return _ok;
+  }
+
+ private:
+  // cannot be assigned
+  BufferedPrint &operator=(const BufferedPrint &);
+
+  TDestination &_destination;
+  char *_block;
+  size_t _blockSize;
+  size_t _length;
+  bool _ok;
+};
+}
+}
@@ -0,0 +1,402 @@
+// ArduinoJson - arduinojson.org
+// Copyright Benoit Blanchon 2014-2018
+// MIT License
+
+#pragma once
+
+#include <stdint.h>
+#include "../TypeTraits/FloatTraits.hpp"
+
+namespace ArduinoJson {
+namespace Internals {
+
+// Passed to JsonWriter::writeFloat() instead of a number of decimals, to get
+// the shortest digits that read back as the same value
+const int8_t FLOAT_SHORTEST = -1;
+
+// A 64-bit mantissa and a binary exponent: value = f * 2^e
+struct DiyFp {
+  uint64_t f;
+  int e;
+
+  DiyFp(uint64_t mantissa, int exponent) : f(mantissa), e(exponent) {}
+
+  // Returns the 64 high bits of the 128-bit product, rounded.
+  // Built from 32-bit products, that's all the ESP8266 has.
+  static DiyFp multiply(const DiyFp &x, const DiyFp &y) {
+    const uint64_t mask = 0xFFFFFFFF;
+    uint64_t xHi = x.f >> 32, xLo = x.f & mask;
+    uint64_t yHi = y.f >> 32, yLo = y.f & mask;
+    uint64_t hiHi = xHi * yHi, hiLo = xHi * yLo;
+    uint64_t loHi = xLo * yHi, loLo = xLo * yLo;
+    uint64_t middle = (loLo >> 32) + (hiLo & mask) + (loHi & mask) +
+                      (uint64_t(1) << 31);
+    return DiyFp(hiHi + (hiLo >> 32) + (loHi >> 32) + (middle >> 32),
+                 x.e + y.e + 64);
+  }
+
+  // Shifts the mantissa until its high bit is set, by halves
+  DiyFp normalized() const {
+    DiyFp x = *this;
+    for (int shift = 32; shift > 0; shift >>= 1) {
+      if (!(x.f >> (64 - shift))) {
+        x.f <<= shift;
+        x.e -= shift;
+      }
+    }
+    return x;
+  }
+};
+
+// 10^k as a normalized DiyFp, for k = -300, -292, ... 324
+struct CachedPower {
+  uint32_t fHi, fLo;  // no 64-bit literals in C++98
+  int16_t e;
+  int16_t k;
+};
+
+template <typename TFloat, size_t = sizeof(TFloat)>
+struct CachedPowers {};
+
+template <typename TFloat>
+struct CachedPowers<TFloat, 8> {
+  static const CachedPower &get(int index) {
+    static const CachedPower powers[] = {
+        {0xAB70FE17, 0xC79AC6CA, -1060, -300},
+        {0xFF77B1FC, 0xBEBCDC4F, -1034, -292},
+        {0xBE5691EF, 0x416BD60C, -1007, -284},
+        {0x8DD01FAD, 0x907FFC3C, -980, -276},
+        {0xD3515C28, 0x31559A83, -954, -268},
+        {0x9D71AC8F, 0xADA6C9B5, -927, -260},
+        {0xEA9C2277, 0x23EE8BCB, -901, -252},
+        {0xAECC4991, 0x4078536D, -874, -244},
+        {0x823C1279, 0x5DB6CE57, -847, -236},
+        {0xC2109436, 0x4DFB5637, -821, -228},
+        {0x9096EA6F, 0x3848984F, -794, -220},
+        {0xD77485CB, 0x25823AC7, -768, -212},
+        {0xA086CFCD, 0x97BF97F4, -741, -204},
+        {0xEF340A98, 0x172AACE5, -715, -196},
+        {0xB23867FB, 0x2A35B28E, -688, -188},
+        {0x84C8D4DF, 0xD2C63F3B, -661, -180},
+        {0xC5DD4427, 0x1AD3CDBA, -635, -172},
+        {0x936B9FCE, 0xBB25C996, -608, -164},
+        {0xDBAC6C24, 0x7D62A584, -582, -156},
+        {0xA3AB6658, 0x0D5FDAF6, -555, -148},
+        {0xF3E2F893, 0xDEC3F126, -529, -140},
+        {0xB5B5ADA8, 0xAAFF80B8, -502, -132},
+        {0x87625F05, 0x6C7C4A8B, -475, -124},
+        {0xC9BCFF60, 0x34C13053, -449, -116},
+        {0x964E858C, 0x91BA2655, -422, -108},
+        {0xDFF97724, 0x70297EBD, -396, -100},
+        {0xA6DFBD9F, 0xB8E5B88F, -369, -92},
+        {0xF8A95FCF, 0x88747D94, -343, -84},
+        {0xB9447093, 0x8FA89BCF, -316, -76},
+        {0x8A08F0F8, 0xBF0F156B, -289, -68},
+        {0xCDB02555, 0x653131B6, -263, -60},
+        {0x993FE2C6, 0xD07B7FAC, -236, -52},
+        {0xE45C10C4, 0x2A2B3B06, -210, -44},
+        {0xAA242499, 0x697392D3, -183, -36},
+        {0xFD87B5F2, 0x8300CA0E, -157, -28},
+        {0xBCE50864, 0x92111AEB, -130, -20},
+        {0x8CBCCC09, 0x6F5088CC, -103, -12},
+        {0xD1B71758, 0xE219652C, -77, -4},
+        {0x9C400000, 0x00000000, -50, 4},
+        {0xE8D4A510, 0x00000000, -24, 12},
+        {0xAD78EBC5, 0xAC620000, 3, 20},
+        {0x813F3978, 0xF8940984, 30, 28},
+        {0xC097CE7B, 0xC90715B3, 56, 36},
+        {0x8F7E32CE, 0x7BEA5C70, 83, 44},
+        {0xD5D238A4, 0xABE98068, 109, 52},
+        {0x9F4F2726, 0x179A2245, 136, 60},
+        {0xED63A231, 0xD4C4FB27, 162, 68},
+        {0xB0DE6538, 0x8CC8ADA8, 189, 76},
+        {0x83C7088E, 0x1AAB65DB, 216, 84},
+        {0xC45D1DF9, 0x42711D9A, 242, 92},
+        {0x924D692C, 0xA61BE758, 269, 100},
+        {0xDA01EE64, 0x1A708DEA, 295, 108},
+        {0xA26DA399, 0x9AEF774A, 322, 116},
+        {0xF209787B, 0xB47D6B85, 348, 124},
+        {0xB454E4A1, 0x79DD1877, 375, 132},
+        {0x865B8692, 0x5B9BC5C2, 402, 140},
+        {0xC83553C5, 0xC8965D3D, 428, 148},
+        {0x952AB45C, 0xFA97A0B3, 455, 156},
+        {0xDE469FBD, 0x99A05FE3, 481, 164},
+        {0xA59BC234, 0xDB398C25, 508, 172},
+        {0xF6C69A72, 0xA3989F5C, 534, 180},
+        {0xB7DCBF53, 0x54E9BECE, 561, 188},
+        {0x88FCF317, 0xF22241E2, 588, 196},
+        {0xCC20CE9B, 0xD35C78A5, 614, 204},
+        {0x98165AF3, 0x7B2153DF, 641, 212},
+        {0xE2A0B5DC, 0x971F303A, 667, 220},
+        {0xA8D9D153, 0x5CE3B396, 694, 228},
+        {0xFB9B7CD9, 0xA4A7443C, 720, 236},
+        {0xBB764C4C, 0xA7A44410, 747, 244},
+        {0x8BAB8EEF, 0xB6409C1A, 774, 252},
+        {0xD01FEF10, 0xA657842C, 800, 260},
+        {0x9B10A4E5, 0xE9913129, 827, 268},
+        {0xE7109BFB, 0xA19C0C9D, 853, 276},
+        {0xAC2820D9, 0x623BF429, 880, 284},
+        {0x80444B5E, 0x7AA7CF85, 907, 292},
+        {0xBF21E440, 0x03ACDD2D, 933, 300},
+        {0x8E679C2F, 0x5E44FF8F, 960, 308},
+        {0xD433179D, 0x9C8CB841, 986, 316},
+        {0x9E19DB92, 0xB4E31BA9, 1013, 324}};
+    return powers[index];
+  }
+};
+
+// A float only needs 10^-36 to 10^52
+template <typename TFloat>
+struct CachedPowers<TFloat, 4> {
+  static const CachedPower &get(int index) {
+    static const CachedPower powers[] = {
+        {0xAA242499, 0x697392D3, -183, -36},
+        {0xFD87B5F2, 0x8300CA0E, -157, -28},
+        {0xBCE50864, 0x92111AEB, -130, -20},
+        {0x8CBCCC09, 0x6F5088CC, -103, -12},
+        {0xD1B71758, 0xE219652C, -77, -4},
+        {0x9C400000, 0x00000000, -50, 4},
+        {0xE8D4A510, 0x00000000, -24, 12},
+        {0xAD78EBC5, 0xAC620000, 3, 20},
+        {0x813F3978, 0xF8940984, 30, 28},
+        {0xC097CE7B, 0xC90715B3, 56, 36},
+        {0x8F7E32CE, 0x7BEA5C70, 83, 44},
+        {0xD5D238A4, 0xABE98068, 109, 52}};
+    return powers[index - 33];
+  }
+};
+
+// An unsigned integer of up to 672 bits, enough for the mantissa of a double
+// times 5^255, the most decimals FloatDigits takes
+class BigInteger {
+  uint32_t _words[21];  // least significant first
+  uint8_t _size;
+
+ public:
+  explicit BigInteger(uint64_t value) : _size(2) {
+    _words[0] = uint32_t(value);
+    _words[1] = uint32_t(value >> 32);
+  }
+
+  void multiply(uint32_t factor) {
+    uint64_t carry = 0;
+    for (uint8_t i = 0; i < _size; i++) {
+      carry += uint64_t(_words[i]) * factor;
+      _words[i] = uint32_t(carry);
+      carry >>= 32;
+    }
+    if (carry) _words[_size++] = uint32_t(carry);
+  }
+
+  // Returns the 64 bits from the given position
+  uint64_t bitsFrom(size_t position) const {
+    size_t index = position / 32;
+    unsigned offset = unsigned(position % 32);
+    uint64_t low = word(index) | (uint64_t(word(index + 1)) << 32);
+    uint64_t high = word(index + 2);
+    return offset ? (low >> offset) | (high << (64 - offset)) : low;
+  }
+
+  bool bit(size_t position) const {
+    return (word(position / 32) >> (position % 32)) & 1;
+  }
+
+ private:
+  uint32_t word(size_t index) const {
+    return index < _size ? _words[index] : 0;
+  }
+};
+
+// The shortest decimal digits of a positive float, computed with Grisu2 (see
+// Loitsch, "Printing Floating-Point Numbers Quickly and Accurately with
+// Integers"). Reading them back gives the same float. Only integer
+// arithmetic, no float division or multiplication.
+//   value = digits[0].digits[1]digits[2]... * 10^exponent
+template <typename TFloat>
+struct FloatDigits {
+  char digits[18];  // not terminated
+  int8_t length;    // 0 if the value is 0
+  int16_t exponent;
+
+  explicit FloatDigits(TFloat value) : length(0), exponent(0) {
+    if (value == 0) return;
+    shortest(value);
+  }
+
+  // The digits rounded half up to the given number of decimals. They come
+  // from the exact value: rounding the shortest digits would round twice,
+  // 1.0049999999999999 would give 1.01.
+  // Past the 17th significant digit, the shortest digits are kept.
+  FloatDigits(TFloat value, uint8_t decimals) : length(0), exponent(0) {
+    if (value == 0) return;
+    shortest(value);
+
+    // The count is exponent + 1 + decimals, kept unsigned: comparing a signed
+    // sum trips -Wstrict-overflow once inlined.
+    size_t count;
+    if (exponent >= 0) {
+      count = size_t(exponent) + 1 + decimals;
+    } else {
+      size_t zeros = size_t(-1 - exponent);  // between the dot and digits[0]
+      if (zeros > decimals) {
+        length = 0;
+        exponent = 0;
+        return;
+      }
+      count = decimals - zeros;
+    }
+    if (count < sizeof(digits)) fixed(value, decimals);
+  }
+
+  // Returns the digit at the given position, with zeros after
+  char operator[](size_t index) const {
+    return index < size_t(length) ? digits[index] : '0';
+  }
+
+ private:
+  typedef FloatTraits<TFloat> traits;
+
+  // The products are scaled to a binary exponent in [alpha, alpha + 28], so
+  // that their integral part fits in 32 bits
+  static const int alpha = -60;
+
+  static const int minExponent =
+      1 - traits::exponent_bias - traits::mantissa_bits;
+
+  // The exact value, as an integer mantissa and a binary exponent
+  static DiyFp decompose(TFloat value) {
+    typename traits::bits_type bits = traits::bits(value);
+    typename traits::bits_type hiddenBit =
+        typename traits::bits_type(1) << traits::mantissa_bits;
+    int biasedExponent = int(bits >> traits::mantissa_bits);
+    DiyFp v(bits & (hiddenBit - 1), minExponent);
+    if (biasedExponent) {
+      v.f += hiddenBit;
+      v.e += biasedExponent - 1;
+    }
+    return v;
+  }
+
+  void shortest(TFloat value) {
+    int decimalExponent;
+    grisu2(value, decimalExponent);
+    exponent = int16_t(decimalExponent + length - 1);
+    while (digits[length - 1] == '0') length--;
+  }
+
+  // Replaces the digits with value * 10^decimals rounded half up, an integer
+  // below 10^17. With value = f * 2^e, that's f * 5^decimals * 2^(e +
+  // decimals), so the division by 2^-(e + decimals) is a shift.
+  void fixed(TFloat value, uint8_t decimals) {
+    static const uint32_t powersOf5[] = {
+        1,      5,       25,       125,       625,       3125,      15625,
+        78125,  390625,  1953125,  9765625,   48828125,  244140625, 1220703125};
+    DiyFp v = decompose(value);
+    BigInteger scaled(v.f);
+    uint8_t remaining = decimals;
+    for (; remaining >= 13; remaining -= 13) scaled.multiply(powersOf5[13]);
+    scaled.multiply(powersOf5[remaining]);
+
+    uint64_t integral;
+    int shift = -v.e - decimals;
+    if (shift > 0) {
+      integral = scaled.bitsFrom(size_t(shift));
+      if (scaled.bit(size_t(shift - 1))) integral++;
+    } else {
+      integral = scaled.bitsFrom(0) << -shift;
+    }
+
+    char reversed[sizeof(digits)];
+    int8_t n = 0;
+    for (; integral; integral /= 10) reversed[n++] = char('0' + integral % 10);
+    length = 0;
+    exponent = int16_t(n - 1 - decimals);
+    while (n > 0) digits[length++] = reversed[--n];
+    while (length > 0 && digits[length - 1] == '0') length--;
+    if (length == 0) exponent = 0;
+  }
+
+  void grisu2(TFloat value, int &decimalExponent) {
+    typename traits::bits_type hiddenBit =
+        typename traits::bits_type(1) << traits::mantissa_bits;
+
+    // the value and the middles with its neighbours
+    DiyFp v = decompose(value);
+    DiyFp upper = DiyFp((v.f << 1) + 1, v.e - 1).normalized();
+    DiyFp lower = (v.f == hiddenBit && v.e > minExponent)
+                      ? DiyFp((v.f << 2) - 1, v.e - 2)
+                      : DiyFp((v.f << 1) - 1, v.e - 1);
+    lower.f <<= lower.e - upper.e;
+    lower.e = upper.e;
+
+    // the cached 10^-k that brings upper.e in range
+    int f = alpha - upper.e - 1;
+    int k = (f * 78913) / (1 << 18) + (f > 0);
+    const CachedPower &power = CachedPowers<TFloat>::get((300 + k + 7) / 8);
+    DiyFp c((uint64_t(power.fHi) << 32) | power.fLo, power.e);
+
+    DiyFp w = DiyFp::multiply(v.normalized(), c);
+    DiyFp wLower = DiyFp::multiply(lower, c);
+    DiyFp wUpper = DiyFp::multiply(upper, c);
+    wLower.f++;
+    wUpper.f--;
+
+    decimalExponent = -power.k;
+    generateDigits(wLower, w, wUpper, decimalExponent);
+  }
+
+  void generateDigits(DiyFp low, DiyFp w, DiyFp high, int &decimalExponent) {
+    uint64_t delta = high.f - low.f;
+    uint64_t distance = high.f - w.f;
+    int shift = -high.e;
+    uint64_t one = uint64_t(1) << shift;
+
+    uint32_t integral = uint32_t(high.f >> shift);
+    uint64_t fractional = high.f & (one - 1);
+
+    // the digits of the integral part, in reverse order: dividing by a
+    // constant is a multiplication, by a variable it's a real division
+    static const uint32_t powersOf10[] = {1,      10,      100,      1000,
+                                          10000,  100000,  1000000,  10000000,
+                                          100000000, 1000000000};
+    char integralDigits[10];
+    int n = 0;
+    for (uint32_t tmp = integral; tmp; tmp /= 10)
+      integralDigits[n++] = char(tmp % 10);
+
+    while (n > 0) {
+      n--;
+      digits[length++] = char('0' + integralDigits[n]);
+      integral -= uint32_t(integralDigits[n]) * powersOf10[n];
+      uint64_t rest = (uint64_t(integral) << shift) + fractional;
+      if (rest <= delta) {
+        decimalExponent += n;
+        roundWeed(distance, delta, rest, uint64_t(powersOf10[n]) << shift);
+        return;
+      }
+    }
+
+    for (;;) {
+      fractional *= 10;
+      digits[length++] = char('0' + (fractional >> shift));
+      fractional &= one - 1;
+      decimalExponent--;
+      delta *= 10;
+      distance *= 10;
+      if (fractional <= delta) break;
+    }
+    roundWeed(distance, delta, fractional, one);
+  }
+
+  // Moves the last digit towards the exact value while it stays in range
+  void roundWeed(uint64_t distance, uint64_t delta, uint64_t rest,
+                 uint64_t tenK) {
+    while (rest < distance && delta - rest >= tenK &&
+           (rest + tenK < distance || distance - rest > rest + tenK - distance)) {
+      digits[length - 1]--;
+      rest += tenK;
+    }
+  }
+};
+}
+}
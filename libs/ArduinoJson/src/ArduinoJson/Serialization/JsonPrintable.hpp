@@ -6,6 +6,7 @@
 
 #include "../Configuration.hpp"
 #include "../TypeTraits/EnableIf.hpp"
+#include "BufferedPrint.hpp"
 #include "DummyPrint.hpp"
 #include "DynamicStringBuilder.hpp"
 #include "IndentedPrint.hpp"
@@ -61,6 +62,22 @@ class JsonPrintable {
     return printTo(sb);
   }
 
+  // Prints to a file or a socket through a block of the caller, that is
+  // written in one call when it's full. Use measureLength() first to send
+  // a Content-Length.
+  template <typename TDestination>
+  size_t printTo(TDestination &destination, char *block,
+                 size_t blockSize) const {
+    BufferedPrint<TDestination> print(destination, block, blockSize);
+    size_t length = printTo(print);
+    return print.flush() ? length : 0;
+  }
+
+  template <typename TDestination, size_t N>
+  size_t printTo(TDestination &destination, char (&block)[N]) const {
+    return printTo(destination, block, N);
+  }
+
   template <typename Print>
   size_t prettyPrintTo(IndentedPrint<Print> &print) const {
     Prettyfier<Print> p(print);
@@ -91,6 +108,19 @@ class JsonPrintable {
     return prettyPrintTo(sb);
   }
 
+  template <typename TDestination>
+  size_t prettyPrintTo(TDestination &destination, char *block,
+                       size_t blockSize) const {
+    BufferedPrint<TDestination> print(destination, block, blockSize);
+    size_t length = prettyPrintTo(print);
+    return print.flush() ? length : 0;
+  }
+
+  template <typename TDestination, size_t N>
+  size_t prettyPrintTo(TDestination &destination, char (&block)[N]) const {
+    return prettyPrintTo(destination, block, N);
+  }
+
   size_t measureLength() const {
     DummyPrint dp;
     return printTo(dp);
@@ -8,6 +8,7 @@
 #include "../Data/Encoding.hpp"
 #include "../Data/JsonInteger.hpp"
 #include "../Polyfills/attributes.hpp"
+#include "../Serialization/FloatDigits.hpp"
 #include "../Serialization/FloatParts.hpp"
 
 namespace ArduinoJson {
@@ -79,6 +80,9 @@ class JsonWriter {
 
   template <typename TFloat>
   void writeFloat(TFloat value) {
+#if ARDUINOJSON_ROUND_TRIP_FLOATS
+    writeFloat(value, FLOAT_SHORTEST);
+#else
     if (isNaN(value)) return writeRaw("NaN");
 
     if (value < 0.0) {
@@ -102,6 +106,95 @@ class JsonWriter {
       writeRaw('e');
       writeInteger(parts.exponent);
     }
+#endif
+  }
+
+  // Writes the shortest digits that read back as the same value
+  // (FLOAT_SHORTEST), or exactly the given number of decimals.
+  // Uses FloatDigits, which has no float arithmetic but is slower than
+  // writeFloat(value) where there is an FPU.
+  template <typename TFloat>
+  void writeFloat(TFloat value, int8_t decimals) {
+    if (isNaN(value)) return writeRaw("NaN");
+
+    if (value < 0.0) {
+      writeRaw('-');
+      value = -value;
+    }
+
+    if (isInfinity(value)) return writeRaw("Infinity");
+
+    if (decimals >= 0)
+      return writeFixed(FloatDigits<TFloat>(value, uint8_t(decimals)),
+                        uint8_t(decimals));
+
+    FloatDigits<TFloat> digits(value);
+
+    if (value >= ARDUINOJSON_POSITIVE_EXPONENTIATION_THRESHOLD ||
+        (value > 0 && value <= ARDUINOJSON_NEGATIVE_EXPONENTIATION_THRESHOLD))
+      return writeScientific(digits);
+
+    writeFixed(digits, 0);
+  }
+
+  // The positions and lengths are unsigned: the comparisons of signed
+  // differences trip -Wstrict-overflow once inlined.
+  template <typename TFloat>
+  void writeFixed(const FloatDigits<TFloat> &digits, uint8_t decimals) {
+    size_t integralLength = 0;
+    size_t zeros = 0;  // between the dot and digits[0]
+    if (digits.exponent >= 0) {
+      integralLength = size_t(digits.exponent) + 1;
+      writeDigits(digits, 0, integralLength);
+    } else {
+      writeRaw('0');
+      zeros = size_t(-1 - digits.exponent);
+    }
+
+    size_t length = size_t(digits.length);
+    size_t decimalLength =
+        length > integralLength ? zeros + length - integralLength : 0;
+    if (decimalLength < decimals) decimalLength = decimals;
+    if (!decimalLength) return;
+
+    writeRaw('.');
+    if (zeros > decimalLength) zeros = decimalLength;
+    for (size_t i = 0; i < zeros; i++) writeRaw('0');
+    writeDigits(digits, integralLength,
+                integralLength + decimalLength - zeros);
+  }
+
+  template <typename TFloat>
+  void writeScientific(const FloatDigits<TFloat> &digits) {
+    writeRaw(digits[0]);
+    if (digits.length > 1) {
+      writeRaw('.');
+      writeDigits(digits, 1, size_t(digits.length));
+    }
+
+    if (digits.exponent < 0) {
+      writeRaw("e-");
+      writeInteger(uint16_t(-digits.exponent));
+    }
+
+    if (digits.exponent > 0) {
+      writeRaw('e');
+      writeInteger(uint16_t(digits.exponent));
+    }
+  }
+
+  // Writes the digits from first to last (excluded), by blocks
+  template <typename TFloat>
+  void writeDigits(const FloatDigits<TFloat> &digits, size_t first,
+                   size_t last) {
+    char buffer[16];
+    while (first < last) {
+      char *ptr = buffer;
+      while (first < last && ptr < buffer + sizeof(buffer) - 1)
+        *ptr++ = digits[first++];
+      *ptr = 0;
+      writeRaw(buffer);
+    }
   }
 
   template <typename UInt>
@@ -0,0 +1,26 @@
+// ArduinoJson - arduinojson.org
+// Copyright Benoit Blanchon 2014-2018
+// MIT License
+
+#pragma once
+
+#include "JsonWriter.hpp"
+#include "StaticStringBuilder.hpp"
+
+namespace ArduinoJson {
+
+// Writes a float in a char[], like the serializer does, or with the given
+// number of decimals like dtostrf().
+// Returns the length; the text is truncated if the buffer is too small.
+template <typename TFloat>
+size_t formatFloat(TFloat value, char *buffer, size_t size,
+                   int8_t decimals = -1) {
+  Internals::StaticStringBuilder sb(buffer, size);
+  Internals::JsonWriter<Internals::StaticStringBuilder> writer(sb);
+  if (decimals < 0)
+    writer.writeFloat(value);
+  else
+    writer.writeFloat(value, decimals);
+  return writer.bytesWritten();
+}
+}
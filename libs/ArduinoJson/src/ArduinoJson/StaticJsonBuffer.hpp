@@ -34,6 +34,22 @@ class StaticJsonBufferBase : public JsonBufferBase<StaticJsonBufferBase> {
       }
     }
 
+    // Gives the string back to the buffer, after c_str().
+    void discard() const {
+      _parent->_size = size_t(_start - _parent->_buffer);
+    }
+
+    // Same as c_str(), but returns the interned copy of the string, if any,
+    // and then gives this one back to the buffer.
+    const char* intern(InternTableBase* table, bool isKey) const {
+      const char* str = c_str();
+      if (!str || !table) return str;
+      size_t length = size_t(_parent->_buffer + _parent->_size - _start);
+      const char* interned = table->intern(str, length - 1, isKey);
+      if (interned != str) _parent->_size -= length;
+      return interned;
+    }
+
    private:
     StaticJsonBufferBase* _parent;
     char* _start;
@@ -63,6 +79,7 @@ class StaticJsonBufferBase : public JsonBufferBase<StaticJsonBufferBase> {
   // USE WITH CAUTION: this invalidates all previously allocated data
   void clear() {
     _size = 0;
+    if (_internTable) _internTable->clear();
   }
 
   String startString() {
@@ -8,10 +8,31 @@
 
 #include <Stream.h>
 
+#include "BufferedStreamReader.hpp"
+
 namespace ArduinoJson {
 namespace Internals {
 
 struct ArduinoStreamTraits {
+#if ARDUINOJSON_STREAM_BUFFER_SIZE
+  class Source {
+    Stream* _stream;
+
+   public:
+    Source(Stream& stream) : _stream(&stream) {}
+
+    size_t readBlock(char* buffer, size_t maxSize) {
+      // readBytes() waits for the timeout until maxSize bytes arrive,
+      // so only ask for what is already there, or for a single byte.
+      int available = _stream->available();
+      size_t size = available > 0 ? size_t(available) : 1;
+      if (size > maxSize) size = maxSize;
+      return _stream->readBytes(buffer, size);
+    }
+  };
+
+  typedef BufferedStreamReader<Source, ARDUINOJSON_STREAM_BUFFER_SIZE> Reader;
+#else
   class Reader {
     Stream& _stream;
     char _current, _next;
@@ -43,6 +64,7 @@ struct ArduinoStreamTraits {
       return c;
     }
   };
+#endif
 
   static const bool has_append = false;
   static const bool has_equals = false;
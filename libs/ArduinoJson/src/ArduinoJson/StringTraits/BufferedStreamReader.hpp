@@ -0,0 +1,63 @@
+// ArduinoJson - arduinojson.org
+// Copyright Benoit Blanchon 2014-2018
+// MIT License
+
+#pragma once
+
+#include <string.h>  // for memmove
+
+#include "../TypeTraits/EnableIf.hpp"
+
+namespace ArduinoJson {
+namespace Internals {
+
+// A reader that pulls a stream by blocks of N bytes.
+// TSource is implicitly built from the stream and must have
+//   size_t readBlock(char* buffer, size_t maxSize);
+// which returns 0 at the end of the stream.
+template <typename TSource, size_t N>
+class BufferedStreamReader {
+  // next() needs two chars in the buffer, a smaller N fails to compile here
+  typedef typename EnableIf<(N >= 2), char>::type BufferHoldsTwoChars;
+
+ public:
+  explicit BufferedStreamReader(const TSource& source)
+      : _source(source), _begin(0), _end(0), _ended(false) {}
+
+  void move() {
+    if (_begin < _end) ++_begin;
+  }
+
+  char current() {
+    return fill(1) ? _buffer[_begin] : '\0';
+  }
+
+  char next() {
+    // assumes that current() has been called
+    return fill(2) ? _buffer[_begin + 1] : '\0';
+  }
+
+ private:
+  // Makes sure that at least count bytes are in the buffer
+  bool fill(size_t count) {
+    while (_end - _begin < count) {
+      if (_ended) return false;
+      if (_begin > 0) {
+        memmove(_buffer, _buffer + _begin, _end - _begin);
+        _end -= _begin;
+        _begin = 0;
+      }
+      size_t size = _source.readBlock(_buffer + _end, N - _end);
+      if (size == 0) _ended = true;
+      _end += size;
+    }
+    return true;
+  }
+
+  TSource _source;
+  char _buffer[N];
+  size_t _begin, _end;
+  bool _ended;
+};
+}
+}
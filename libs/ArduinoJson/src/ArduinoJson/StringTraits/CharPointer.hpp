@@ -11,15 +11,24 @@ template <typename TChar>
 struct CharPointerTraits {
   class Reader {
     const TChar* _ptr;
+    const TChar* _end;
 
    public:
     Reader(const TChar* ptr)
-        : _ptr(ptr ? ptr : reinterpret_cast<const TChar*>("")) {}
+        : _ptr(ptr ? ptr : reinterpret_cast<const TChar*>("")), _end(NULL) {}
 
     void move() {
       ++_ptr;
     }
 
+    void move(size_t count) {
+      _ptr += count;
+    }
+
+    const TChar* ptr() const {
+      return _ptr;
+    }
+
     char current() const {
       return char(_ptr[0]);
     }
@@ -27,10 +36,21 @@ struct CharPointerTraits {
     char next() const {
       return char(_ptr[1]);
     }
+
+    // The terminator of the input, NULL until a string was long enough to
+    // look for it. The parser writes behind _ptr only, so it stays there.
+    const TChar*& end() {
+      return _end;
+    }
   };
 
   static bool equals(const TChar* str, const char* expected) {
-    return strcmp(reinterpret_cast<const char*>(str), expected) == 0;
+    // interned keys are often the same pointer
+    const char* actual = reinterpret_cast<const char*>(str);
+    if (actual == expected) return true;
+    // a variant without text (number, boolean, null) compares as NULL
+    if (!actual || !expected) return false;
+    return strcmp(actual, expected) == 0;
   }
 
   static bool is_null(const TChar* str) {
@@ -31,7 +31,7 @@ struct StringTraits<const __FlashStringHelper*, void> {
   };
 
   static bool equals(const __FlashStringHelper* str, const char* expected) {
-    return strcmp_P(expected, (const char*)str) == 0;
+    return expected && strcmp_P(expected, (const char*)str) == 0;
   }
 
   static bool is_null(const __FlashStringHelper* str) {
@@ -39,7 +39,16 @@ struct StdStreamTraits {
     Reader& operator=(const Reader&);  // Visual Studio C4512
 
     char read() {
-      return _stream.eof() ? '\0' : static_cast<char>(_stream.get());
+      // go straight to the stream buffer, which is already filled by
+      // blocks, instead of paying for the sentry of get() on every char
+      std::streambuf* buf = _stream.good() ? _stream.rdbuf() : NULL;
+      if (!buf) return '\0';
+      int c = buf->sbumpc();
+      if (c == std::char_traits<char>::eof()) {
+        _stream.setstate(std::ios::eofbit);
+        return '\0';
+      }
+      return static_cast<char>(c);
     }
   };
 
@@ -30,6 +30,7 @@ struct StringTraits<TString&, void> : StringTraits<TString> {};
 }
 
 #include "ArduinoStream.hpp"
+#include "BufferedStreamReader.hpp"
 #include "CharPointer.hpp"
 #include "FlashString.hpp"
 #include "StdStream.hpp"
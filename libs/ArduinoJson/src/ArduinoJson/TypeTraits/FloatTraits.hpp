@@ -25,6 +25,9 @@ struct FloatTraits<T, 8 /*64bits*/> {
   typedef int16_t exponent_type;
   static const exponent_type exponent_max = 308;
 
+  typedef uint64_t bits_type;
+  static const short exponent_bias = 1023;
+
   template <typename TExponent>
   static T make_float(T m, TExponent e) {
     if (e > 0) {
@@ -85,6 +88,15 @@ struct FloatTraits<T, 8 /*64bits*/> {
     integerBits = (uint64_t(msb) << 32) | lsb;
     return floatBits;
   }
+
+  static bits_type bits(T value) {
+    union {
+      uint64_t integerBits;
+      T floatBits;
+    };
+    floatBits = value;
+    return integerBits;
+  }
 };
 
 template <typename T>
@@ -97,6 +109,9 @@ struct FloatTraits<T, 4 /*32bits*/> {
   typedef int8_t exponent_type;
   static const exponent_type exponent_max = 38;
 
+  typedef uint32_t bits_type;
+  static const short exponent_bias = 127;
+
   template <typename TExponent>
   static T make_float(T m, TExponent e) {
     if (e > 0) {
@@ -138,6 +153,15 @@ struct FloatTraits<T, 4 /*32bits*/> {
     return floatBits;
   }
 
+  static bits_type bits(T value) {
+    union {
+      uint32_t integerBits;
+      T floatBits;
+    };
+    floatBits = value;
+    return integerBits;
+  }
+
   static T nan() {
     return forge(0x7fc00000);
   }
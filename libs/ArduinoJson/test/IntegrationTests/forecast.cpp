@@ -0,0 +1,228 @@
+// ArduinoJson - arduinojson.org
+// Copyright Benoit Blanchon 2014-2018
+// MIT License
+
+#include <ArduinoJson.h>
+#include <catch.hpp>
+#include <ctime>
+#include <iostream>
+#include <sstream>
+#include <vector>
+
+// A 5 day / 3 hour forecast, as returned by OpenWeatherMap
+static std::string makeForecast(int count) {
+  std::ostringstream json;
+  json << "{\"cnt\":" << count << ",\"list\":[";
+  for (int i = 0; i < count; i++) {
+    if (i) json << ',';
+    json << "{\"dt\":" << 1514764800 + i * 10800 << ",\"main\":{\"temp\":"
+         << i - 10 << ".5,\"pressure\":1012},\"clouds\":{\"all\":" << i
+         << "},\"wind\":{\"speed\":3.1,\"deg\":" << i * 9 << "}}";
+  }
+  json << "]}";
+  return json.str();
+}
+
+// Same access pattern as the weather display: find two lines by date,
+// then index them again to read their parameters.
+static long scanForecast(const JsonObject& root) {
+  int count = root["cnt"];
+  int found = -1;
+  for (int i = 0; i < count; i++) {
+    long dt = root["list"][i]["dt"];
+    if (dt == 1514764800 + 38 * 10800) found = i;
+  }
+  if (found < 0) return -1;
+  long deg = root["list"][found]["wind"]["deg"];
+  long clouds = root["list"][found]["clouds"]["all"];
+  return deg + clouds;
+}
+
+TEST_CASE("Forecast") {
+  std::string json = makeForecast(40);
+  DynamicJsonBuffer jsonBuffer;
+  const JsonObject& root = jsonBuffer.parseObject(json);
+
+  SECTION("Success") {
+    REQUIRE(root.success());
+    REQUIRE(40U == root["list"].as<JsonArray>().size());
+  }
+
+  SECTION("Scan") {
+    REQUIRE(38 * 9 + 38 == scanForecast(root));
+  }
+
+  SECTION("Last") {
+    REQUIRE(39 == root["list"][39]["clouds"]["all"]);
+  }
+}
+
+// Sums the wind directions without building the tree
+struct WindDegSum : JsonEventHandler {
+  WindDegSum() : inWind(false), isDeg(false), sum(0) {}
+
+  bool key(const char* key) {
+    if (!strcmp(key, "wind")) inWind = true;
+    isDeg = inWind && !strcmp(key, "deg");
+    return true;
+  }
+
+  bool endObject() {
+    inWind = false;
+    return true;
+  }
+
+  bool value(const JsonVariant& value) {
+    if (isDeg) sum += value.as<long>();
+    return true;
+  }
+
+  bool inWind, isDeg;
+  long sum;
+};
+
+TEST_CASE("Forecast events") {
+  std::string json = makeForecast(400);
+  StaticJsonBuffer<16> jsonBuffer;
+  WindDegSum handler;
+
+  REQUIRE(jsonBuffer.parseEvents(json, handler));
+  REQUIRE(399L * 400 / 2 * 9 == handler.sum);
+}
+
+// Run with: IntegrationTests [benchmark]
+TEST_CASE("Forecast benchmark", "[.][benchmark]") {
+  std::string json = makeForecast(40);
+  DynamicJsonBuffer jsonBuffer;
+  const JsonObject& root = jsonBuffer.parseObject(json);
+  REQUIRE(root.success());
+
+  const int passes = 20000;
+  long sum = 0;
+  std::clock_t start = std::clock();
+  for (int i = 0; i < passes; i++) sum += scanForecast(root);
+  std::clock_t stop = std::clock();
+
+  REQUIRE(passes * (38L * 9 + 38) == sum);
+  std::cout << "Forecast scan: "
+            << 1e6 * static_cast<double>(stop - start) / CLOCKS_PER_SEC /
+                   passes
+            << " us per pass" << std::endl;
+}
+
+template <typename TInput>
+static double parseThroughput(const std::string& json, int passes) {
+  std::clock_t start = std::clock();
+  for (int i = 0; i < passes; i++) {
+    DynamicJsonBuffer jsonBuffer;
+    TInput input(json);
+    REQUIRE(jsonBuffer.parseObject(input).success());
+  }
+  std::clock_t stop = std::clock();
+  double seconds = static_cast<double>(stop - start) / CLOCKS_PER_SEC;
+  return static_cast<double>(json.size()) * passes / seconds / 1e6;
+}
+
+// Run with: IntegrationTests [benchmark]
+TEST_CASE("Forecast stream benchmark", "[.][benchmark]") {
+  std::string json = makeForecast(40);
+  const int passes = 2000;
+
+  std::cout << "Parse from std::string: "
+            << parseThroughput<std::string>(json, passes) << " MB/s"
+            << std::endl;
+  std::cout << "Parse from std::istream: "
+            << parseThroughput<std::istringstream>(json, passes) << " MB/s"
+            << std::endl;
+}
+
+// Same access pattern as scanForecast(), on a tape
+static long scanForecast(JsonTapeValue root) {
+  int count = root["cnt"];
+  int found = -1;
+  for (int i = 0; i < count; i++) {
+    long dt = root["list"][i]["dt"];
+    if (dt == 1514764800 + 38 * 10800) found = i;
+  }
+  if (found < 0) return -1;
+  long deg = root["list"][found]["wind"]["deg"];
+  long clouds = root["list"][found]["clouds"]["all"];
+  return deg + clouds;
+}
+
+TEST_CASE("Forecast tape") {
+  std::string json = makeForecast(40);
+  StaticJsonTape<1024> tape;
+  JsonTapeValue root = tape.parse(&json[0]);
+
+  REQUIRE(root.success());
+  REQUIRE(40U == root["list"].size());
+  REQUIRE(38 * 9 + 38 == scanForecast(root));
+}
+
+// Run with: IntegrationTests [benchmark]
+TEST_CASE("Forecast tape benchmark", "[.][benchmark]") {
+  const std::string json = makeForecast(40);
+  const int passes = 2000;
+  static StaticJsonTape<1024> tape;
+  long sum = 0;
+
+  std::clock_t start = std::clock();
+  for (int i = 0; i < passes; i++) {
+    std::string input(json);
+    DynamicJsonBuffer jsonBuffer;
+    JsonObject& root = jsonBuffer.parseObject(&input[0]);
+    long dt = root["list"][38]["dt"];
+    sum += dt;
+  }
+  std::clock_t middle = std::clock();
+  for (int i = 0; i < passes; i++) {
+    std::string input(json);
+    JsonTapeValue root = tape.parse(&input[0]);
+    long dt = root["list"][38]["dt"];
+    sum += dt;
+  }
+  std::clock_t stop = std::clock();
+
+  REQUIRE(2L * passes * (1514764800 + 38 * 10800) == sum);
+  double mb = static_cast<double>(json.size()) * passes / 1e6;
+  std::cout << "Forecast, one value read: JsonBuffer "
+            << mb / (static_cast<double>(middle - start) / CLOCKS_PER_SEC)
+            << " MB/s, JsonTape "
+            << mb / (static_cast<double>(stop - middle) / CLOCKS_PER_SEC)
+            << " MB/s" << std::endl;
+}
+
+// Parses in place, as the firmware does with a char[]
+static double inPlaceThroughput(const std::string& json, int passes) {
+  std::vector<char> input(json.size() + 1);
+  std::clock_t start = std::clock();
+  for (int i = 0; i < passes; i++) {
+    std::copy(json.begin(), json.end(), input.begin());
+    input[json.size()] = '\0';
+    DynamicJsonBuffer jsonBuffer;
+    REQUIRE(jsonBuffer.parseObject(&input[0]).success());
+  }
+  std::clock_t stop = std::clock();
+  double seconds = static_cast<double>(stop - start) / CLOCKS_PER_SEC;
+  return static_cast<double>(json.size()) * passes / seconds / 1e6;
+}
+
+// Run with: IntegrationTests [benchmark]
+TEST_CASE("Forecast in place benchmark", "[.][benchmark]") {
+  std::string compact = makeForecast(40);
+  std::string pretty;
+  DynamicJsonBuffer jsonBuffer;
+  jsonBuffer.parseObject(compact).prettyPrintTo(pretty);
+  std::string text = "{\"description\":\"";
+  for (int i = 0; i < 200; i++) text += "light rain and moderate wind, ";
+  text += "\"}";
+  const int passes = 2000;
+
+  std::cout << "In place, compact: " << inPlaceThroughput(compact, passes)
+            << " MB/s" << std::endl;
+  std::cout << "In place, pretty: " << inPlaceThroughput(pretty, passes)
+            << " MB/s" << std::endl;
+  std::cout << "In place, long string: " << inPlaceThroughput(text, passes)
+            << " MB/s" << std::endl;
+}
@@ -0,0 +1,83 @@
+// ArduinoJson - arduinojson.org
+// Copyright Benoit Blanchon 2014-2018
+// MIT License
+
+#include <ArduinoJson.h>
+#include <catch.hpp>
+#include <ctime>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+#include <string>
+
+static std::string readCorpus(const char* name) {
+  std::ifstream file((std::string(SEED_CORPUS) + name).c_str());
+  std::ostringstream content;
+  content << file.rdbuf();
+  return content.str();
+}
+
+// Parses, then reads the first value of the root
+template <typename TParse>
+static double throughput(const std::string& json, int passes, TParse parse) {
+  std::clock_t start = std::clock();
+  for (int i = 0; i < passes; i++) {
+    std::string input(json);
+    REQUIRE(parse(&input[0]));
+  }
+  std::clock_t stop = std::clock();
+  double seconds = static_cast<double>(stop - start) / CLOCKS_PER_SEC;
+  return static_cast<double>(json.size()) * passes / seconds / 1e6;
+}
+
+static bool parseWithJsonBuffer(char* json) {
+  DynamicJsonBuffer jsonBuffer;
+  JsonVariant root = jsonBuffer.parse(json);
+  return root.success();
+}
+
+static bool parseWithJsonTape(char* json) {
+  static StaticJsonTape<4096> tape;
+  return tape.parse(json).success();
+}
+
+static const char* const corpus[] = {
+    "Comments.json", "EmptyArray.json",   "EmptyObject.json",
+    "Numbers.json",  "OpenWeatherMap.json", "Strings.json",
+    "WeatherUnderground.json"};
+
+TEST_CASE("JsonTape accepts the seed corpus") {
+  for (size_t i = 0; i < sizeof(corpus) / sizeof(corpus[0]); i++) {
+    std::string json = readCorpus(corpus[i]);
+    INFO(corpus[i]);
+    REQUIRE_FALSE(json.empty());
+    REQUIRE(parseWithJsonBuffer(&std::string(json)[0]));
+    REQUIRE(parseWithJsonTape(&json[0]));
+  }
+}
+
+TEST_CASE("JsonTape OpenWeatherMap") {
+  std::string json = readCorpus("OpenWeatherMap.json");
+  StaticJsonTape<82> tape;
+  JsonTapeValue root = tape.parse(&json[0]);
+
+  REQUIRE(root.success());
+  REQUIRE(82 == tape.size());
+  REQUIRE(1032 == root["main"]["pressure"].as<int>());
+  REQUIRE(std::string("drizzle") ==
+          root["weather"][0]["description"].as<const char*>());
+  REQUIRE(2643743 == root["id"].as<long>());
+}
+
+// Run with: IntegrationTests [benchmark]
+TEST_CASE("Seed corpus benchmark", "[.][benchmark]") {
+  const int passes = 20000;
+  for (size_t i = 0; i < sizeof(corpus) / sizeof(corpus[0]); i++) {
+    std::string json = readCorpus(corpus[i]);
+    std::cout << corpus[i] << ": JsonBuffer "
+              << throughput(json, passes, parseWithJsonBuffer)
+              << " MB/s, JsonTape "
+              << throughput(json, passes, parseWithJsonTape) << " MB/s"
+              << std::endl;
+  }
+}
@@ -0,0 +1,65 @@
+// ArduinoJson - arduinojson.org
+// Copyright Benoit Blanchon 2014-2018
+// MIT License
+
+#include <ArduinoJson.h>
+#include <catch.hpp>
+
+TEST_CASE("JsonArray::at()") {
+  DynamicJsonBuffer _jsonBuffer;
+  JsonArray& _array = _jsonBuffer.createArray();
+  for (int i = 0; i < 10; i++) _array.add(i * 10);
+
+  SECTION("increasing indexes") {
+    for (int i = 0; i < 10; i++) REQUIRE(i * 10 == _array[i]);
+  }
+
+  SECTION("decreasing indexes") {
+    for (int i = 9; i >= 0; i--) REQUIRE(i * 10 == _array[i]);
+  }
+
+  SECTION("same index twice") {
+    REQUIRE(50 == _array[5]);
+    REQUIRE(50 == _array[5]);
+    REQUIRE(20 == _array[2]);
+    REQUIRE(70 == _array[7]);
+  }
+
+  SECTION("out of range") {
+    REQUIRE(_array.end() == _array.at(10));
+    REQUIRE(0 == _array[10].as<int>());
+    REQUIRE(90 == _array[9]);
+  }
+
+  SECTION("after remove()") {
+    REQUIRE(60 == _array[6]);
+    _array.remove(3);
+    REQUIRE(9U == _array.size());
+    REQUIRE(70 == _array[6]);
+    REQUIRE(20 == _array[2]);
+    REQUIRE(40 == _array[3]);
+  }
+
+  SECTION("after removing the last element") {
+    _array.remove(9);
+    REQUIRE(80 == _array[8]);
+    _array.add(100);
+    REQUIRE(10U == _array.size());
+    REQUIRE(100 == _array[9]);
+  }
+
+  SECTION("after removing every element") {
+    for (int i = 0; i < 10; i++) _array.remove(0);
+    REQUIRE(0U == _array.size());
+    REQUIRE(_array.end() == _array.at(0));
+    _array.add(1);
+    REQUIRE(1 == _array[0]);
+  }
+
+  SECTION("remove() with an iterator of another array") {
+    JsonArray& other = _jsonBuffer.createArray();
+    other.add(1);
+    _array.remove(other.begin());
+    REQUIRE(10U == _array.size());
+  }
+}
@@ -119,14 +119,18 @@ TEST_CASE("JsonArray::printTo()") {
   }
 
   SECTION("OneEmptyNestedArray") {
-    array.createNestedArray();
+    StaticJsonBuffer<JSON_ARRAY_SIZE(1) + JSON_ARRAY_SIZE(0)> nestedBuffer;
+    JsonArray &outer = nestedBuffer.createArray();
+    outer.createNestedArray();
 
-    check(array, "[[]]");
+    check(outer, "[[]]");
   }
 
   SECTION("OneEmptyNestedHash") {
-    array.createNestedObject();
+    StaticJsonBuffer<JSON_ARRAY_SIZE(1) + JSON_OBJECT_SIZE(0)> nestedBuffer;
+    JsonArray &outer = nestedBuffer.createArray();
+    outer.createNestedObject();
 
-    check(array, "[{}]");
+    check(outer, "[{}]");
   }
 }
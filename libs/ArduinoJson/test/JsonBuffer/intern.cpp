@@ -0,0 +1,157 @@
+// ArduinoJson - arduinojson.org
+// Copyright Benoit Blanchon 2014-2018
+// MIT License
+
+#include <ArduinoJson.h>
+#include <catch.hpp>
+#include <iostream>
+#include <sstream>
+
+// fuzzing/seed_corpus/OpenWeatherMap.json
+static const char owmWeather[] =
+    "{\"coord\":{\"lon\":-0.13,\"lat\":51.51},\"weather\":[{\"id\":301,"
+    "\"main\":\"Drizzle\",\"description\":\"drizzle\",\"icon\":\"09n\"},{"
+    "\"id\":701,\"main\":\"Mist\",\"description\":\"mist\",\"icon\":\"50n\"},"
+    "{\"id\":741,\"main\":\"Fog\",\"description\":\"fog\",\"icon\":\"50n\"}],"
+    "\"base\":\"stations\",\"main\":{\"temp\":281.87,\"pressure\":1032,"
+    "\"humidity\":100,\"temp_min\":281.15,\"temp_max\":283.15},"
+    "\"visibility\":2900,\"wind\":{\"speed\":1.5},\"clouds\":{\"all\":90},"
+    "\"dt\":1483820400,\"sys\":{\"type\":1,\"id\":5091,\"message\":0.0226,"
+    "\"country\":\"GB\",\"sunrise\":1483776245,\"sunset\":1483805443},"
+    "\"id\":2643743,\"name\":\"London\",\"cod\":200}";
+
+// An OWM 5 day / 3 hour forecast, with the entries of a recorded response
+static std::string owmForecast() {
+  std::ostringstream json;
+  json << "{\"cod\":\"200\",\"message\":0.0045,\"cnt\":40,\"list\":[";
+  for (int i = 0; i < 40; i++) {
+    if (i) json << ',';
+    json << "{\"dt\":" << 1514797200 + i * 10800
+         << ",\"main\":{\"temp\":-1.58,\"temp_min\":-1.58,\"temp_max\":-1.11,"
+            "\"pressure\":1005.37,\"sea_level\":1025.58,\"grnd_level\":"
+            "1005.37,\"humidity\":92,\"temp_kf\":-0.47},\"weather\":[{\"id\":"
+            "600,\"main\":\"Snow\",\"description\":\"light snow\",\"icon\":"
+            "\"13n\"}],\"clouds\":{\"all\":88},\"wind\":{\"speed\":4.21,"
+            "\"deg\":213.501},\"snow\":{\"3h\":0.245},\"sys\":{\"pod\":\"n\"},"
+            "\"dt_txt\":\"2018-01-01 03:00:00\"}";
+  }
+  json << "],\"city\":{\"id\":524901,\"name\":\"Moscow\",\"coord\":{\"lat\":"
+          "55.7522,\"lon\":37.6156},\"country\":\"RU\"}}";
+  return json.str();
+}
+
+static size_t parsedSize(const char* json, Internals::InternTableBase* table) {
+  DynamicJsonBuffer jb;
+  jb.setInternTable(table);
+  REQUIRE(jb.parseObject(json).success());
+  return jb.size();
+}
+
+TEST_CASE("JsonBuffer::setInternTable()") {
+  DynamicJsonBuffer jb;
+  JsonInternTable<8> table;
+  jb.setInternTable(&table);
+
+  SECTION("Repeated keys share one copy") {
+    JsonArray& arr = jb.parseArray("[{\"temp\":1},{\"temp\":2}]");
+    REQUIRE(arr.success());
+    REQUIRE(arr[0].as<JsonObject>().begin()->key ==
+            arr[1].as<JsonObject>().begin()->key);
+    REQUIRE(2 == arr[1]["temp"]);
+    REQUIRE(1 == table.size());
+    REQUIRE(5 == table.savedBytes());
+  }
+
+  SECTION("Values are not interned by default") {
+    JsonArray& arr = jb.parseArray("[\"13n\",\"13n\"]");
+    REQUIRE(arr[0].as<const char*>() != arr[1].as<const char*>());
+    REQUIRE(0 == table.size());
+  }
+
+  SECTION("Short values are interned on demand") {
+    table.setMaxValueLength(3);
+    JsonArray& arr = jb.parseArray("[\"13n\",\"13n\",\"Snow\",\"Snow\",13,13]");
+    REQUIRE(arr[0].as<const char*>() == arr[1].as<const char*>());
+    REQUIRE(arr[2].as<const char*>() != arr[3].as<const char*>());
+    REQUIRE(13 == arr[5]);
+    REQUIRE(std::string("Snow") == arr[3].as<const char*>());
+  }
+
+  SECTION("Keeps parsing when the table is full") {
+    JsonObject& obj = jb.parseObject(
+        "{\"a\":{\"k\":1},\"b\":{\"k\":2},\"c\":3,\"d\":4,\"e\":5,\"f\":6,"
+        "\"g\":7,\"h\":8,\"i\":9}");
+    REQUIRE(obj.success());
+    REQUIRE(7 == table.size());
+    REQUIRE(9 == obj["i"]);
+    REQUIRE(2 == obj["b"]["k"]);
+  }
+
+  SECTION("clear() empties the table") {
+    jb.parseObject("{\"key\":1}");
+    jb.clear();
+    REQUIRE(0 == table.size());
+  }
+
+  SECTION("Strings written in place are not interned") {
+    char json[] = "[{\"temp\":1},{\"temp\":2}]";
+    JsonArray& arr = jb.parseArray(json);
+    REQUIRE(2 == arr[1]["temp"]);
+    REQUIRE(0 == table.size());
+  }
+
+  SECTION("StaticJsonBuffer") {
+    const char json[] = "[{\"temperature\":1},{\"temperature\":2}]";
+    StaticJsonBuffer<JSON_ARRAY_SIZE(2) + 2 * JSON_OBJECT_SIZE(1) + 32> plain;
+    REQUIRE(plain.parseArray(json).success());
+
+    StaticJsonBuffer<JSON_ARRAY_SIZE(2) + 2 * JSON_OBJECT_SIZE(1) + 32> sjb;
+    sjb.setInternTable(&table);
+    JsonArray& arr = sjb.parseArray(json);
+    REQUIRE(arr.success());
+    REQUIRE(arr[0].as<JsonObject>().begin()->key ==
+            arr[1].as<JsonObject>().begin()->key);
+    REQUIRE(sjb.size() < plain.size());
+  }
+}
+
+struct OwmSizes {
+  size_t weatherPlain, weatherInterned;
+  size_t forecastPlain, forecastInterned, forecastAll;
+
+  OwmSizes() {
+    std::string forecast = owmForecast();
+
+    weatherPlain = parsedSize(owmWeather, NULL);
+    JsonInternTable<64> weatherKeys;
+    weatherInterned = parsedSize(owmWeather, &weatherKeys);
+
+    forecastPlain = parsedSize(forecast.c_str(), NULL);
+    JsonInternTable<64> forecastKeys;
+    forecastInterned = parsedSize(forecast.c_str(), &forecastKeys);
+
+    JsonInternTable<64> forecastValues;
+    forecastValues.setMaxValueLength(8);
+    forecastAll = parsedSize(forecast.c_str(), &forecastValues);
+  }
+};
+
+TEST_CASE("Memory saved by interning on OWM payloads") {
+  OwmSizes sizes;
+
+  REQUIRE(sizes.weatherInterned < sizes.weatherPlain);
+  REQUIRE(sizes.forecastInterned * 10 < sizes.forecastPlain * 9);
+  REQUIRE(sizes.forecastAll < sizes.forecastInterned);
+}
+
+// Run with: JsonBufferTests [report]
+TEST_CASE("Memory saved by interning on OWM payloads (report)", "[.][report]") {
+  OwmSizes sizes;
+
+  std::cout << "OWM weather: " << sizes.weatherPlain << " -> "
+            << sizes.weatherInterned << " bytes with keys interned"
+            << std::endl;
+  std::cout << "OWM forecast: " << sizes.forecastPlain << " -> "
+            << sizes.forecastInterned << " bytes with keys interned, "
+            << sizes.forecastAll << " with short values too" << std::endl;
+}
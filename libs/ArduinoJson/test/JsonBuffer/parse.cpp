@@ -4,6 +4,10 @@
 
 #include <ArduinoJson.h>
 #include <catch.hpp>
+#include <limits.h>
+#include <stdlib.h>
+#include <string.h>
+#include <string>
 
 using namespace Catch::Matchers;
 
@@ -30,6 +34,35 @@ TEST_CASE("JsonBuffer::parse()") {
     REQUIRE(variant == -42);
   }
 
+  SECTION("Biggest unsigned integer") {
+    JsonVariant variant = jb.parse("18446744073709551615");
+    REQUIRE(variant.success());
+    REQUIRE(variant.as<unsigned long>() == ULONG_MAX);
+  }
+
+  SECTION("Smallest integer") {
+    JsonVariant variant = jb.parse("-9223372036854775808");
+    REQUIRE(variant.success());
+    REQUIRE(variant.as<long>() == LONG_MIN);
+  }
+
+  SECTION("Integers and booleans don't keep their text") {
+    JsonObject& obj = jb.parseObject("{\"a\":123,\"b\":true}");
+    REQUIRE(obj.success());
+    REQUIRE(obj["a"].as<char*>() == 0);
+    REQUIRE(obj["b"].as<char*>() == 0);
+    REQUIRE_FALSE(obj["a"] == "123");
+    REQUIRE_FALSE(obj["b"] == std::string("true"));
+    REQUIRE(obj["a"].as<std::string>() == "123");
+    REQUIRE(obj["b"].as<std::string>() == "true");
+  }
+
+  SECTION("Integer too big keeps its text") {
+    JsonVariant variant = jb.parse("123456789012345678901234567890");
+    REQUIRE(variant.success());
+    REQUIRE_THAT(variant.as<char*>(), Equals("123456789012345678901234567890"));
+  }
+
   SECTION("Double") {
     JsonVariant variant = jb.parse("-1.23e+4");
     REQUIRE(variant.success());
@@ -78,3 +111,36 @@ TEST_CASE("JsonBuffer::parse()") {
     REQUIRE_THAT(variant.as<char*>(), Equals("hello"));
   }
 }
+
+// The input is in a heap block of the exact size, so that AddressSanitizer
+// catches any read after the terminator.
+static char* exactCopy(const std::string& json) {
+  char* copy = static_cast<char*>(malloc(json.size() + 1));
+  memcpy(copy, json.c_str(), json.size() + 1);
+  return copy;
+}
+
+TEST_CASE("JsonBuffer::parse() of a char* in an exactly sized block") {
+  DynamicJsonBuffer jb;
+
+  // every position of the terminator in the last word
+  SECTION("Long string") {
+    for (size_t length = 0; length < 48; length++) {
+      std::string value(length, 'a');
+      char* json = exactCopy("[\"" + value + "\"]");
+      JsonArray& array = jb.parseArray(json);
+      REQUIRE(array.success());
+      REQUIRE(array[0] == value);
+      free(json);
+    }
+  }
+
+  SECTION("Unterminated string") {
+    for (size_t length = 0; length < 48; length++) {
+      char* json = exactCopy("[\"" + std::string(length, 'a'));
+      JsonArray& array = jb.parseArray(json);
+      REQUIRE_FALSE(array.success());
+      free(json);
+    }
+  }
+}
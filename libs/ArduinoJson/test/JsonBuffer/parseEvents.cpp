@@ -0,0 +1,598 @@
+// ArduinoJson - arduinojson.org
+// Copyright Benoit Blanchon 2014-2018
+// MIT License
+
+#include <ArduinoJson.h>
+#include <catch.hpp>
+#include <sstream>
+#include <string>
+
+// Writes the events in a compact form: { k:v } and [ v ]
+// Strings are quoted, raw values are not, integers are prefixed with #,
+// empty non-quoted values are written <>
+struct EventRecorder : JsonEventHandler {
+  EventRecorder() : stopAfter(-1), afterKey(false) {}
+
+  bool startObject() {
+    return record("{");
+  }
+  bool endObject() {
+    return record("}");
+  }
+  bool startArray() {
+    return record("[");
+  }
+  bool endArray() {
+    return record("]");
+  }
+  bool key(const char* k) {
+    bool accepted = record(std::string(k) + ":");
+    afterKey = true;
+    return accepted;
+  }
+  bool value(const JsonVariant& v) {
+    std::string raw;
+    v.printTo(raw);
+    if (raw.empty()) return record("<>");
+    if (v.is<bool>()) return record(v.as<bool>() ? "true" : "false");
+    if (v.is<long>()) {
+      std::ostringstream s;
+      s << '#' << v.as<long>();
+      return record(s.str());
+    }
+    if (v.is<char*>() && v.as<char*>()) return record('"' + std::string(v.as<char*>()) + '"');
+    return record(raw);
+  }
+
+  bool record(const std::string& event) {
+    if (!log.empty() && !afterKey) log += ' ';
+    afterKey = false;
+    log += event;
+    return stopAfter-- != 0;
+  }
+
+  std::string log;
+  int stopAfter;
+  bool afterKey;
+};
+
+static std::string events(const char* json, uint8_t nestingLimit = 10) {
+  DynamicJsonBuffer jb;
+  EventRecorder recorder;
+  if (!jb.parseEvents(json, recorder, nestingLimit)) return "error";
+  return recorder.log;
+}
+
+TEST_CASE("JsonBuffer::parseEvents()") {
+  SECTION("EmptyObject") {
+    REQUIRE("{ }" == events("{}"));
+  }
+
+  SECTION("EmptyArray") {
+    REQUIRE("[ ]" == events("[]"));
+  }
+
+  SECTION("Integer") {
+    REQUIRE("#-42" == events("-42"));
+  }
+
+  SECTION("Double") {
+    REQUIRE("-1.23e+4" == events("-1.23e+4"));
+  }
+
+  SECTION("Double quoted string") {
+    REQUIRE("\"hello world\"" == events("\"hello world\""));
+  }
+
+  SECTION("Single quoted string") {
+    REQUIRE("\"hello world\"" == events("'hello world'"));
+  }
+
+  SECTION("Escaped chars") {
+    REQUIRE("\"1\"2\\3/4\b5\f6\n7\r8\t9\"" ==
+            events("\"1\\\"2\\\\3\\/4\\b5\\f6\\n7\\r8\\t9\""));
+  }
+
+  SECTION("True and false") {
+    REQUIRE("[ true false ]" == events("[true,false]"));
+  }
+
+  SECTION("Null") {
+    REQUIRE("[ null ]" == events("[null]"));
+  }
+
+  SECTION("Array of integers") {
+    REQUIRE("[ #42 #-84 ]" == events("[ \t\r\n42 ,\n-84 ]"));
+  }
+
+  SECTION("Object") {
+    REQUIRE("{ key1:\"value1\" key2:#2 }" ==
+            events("{\"key1\":\"value1\",key2:2}"));
+  }
+
+  SECTION("Nested") {
+    REQUIRE("{ a:[ { b:#1 } [ ] ] c:{ } }" ==
+            events("{\"a\":[{\"b\":1},[]],\"c\":{}}"));
+  }
+
+  SECTION("Comments") {
+    REQUIRE("[ #1 #2 ]" == events("/*a*/[1 // b\n,2]"));
+  }
+
+  SECTION("Writable input") {
+    char json[] = "{\"a\":[\"b\",1]}";
+    DynamicJsonBuffer jb;
+    EventRecorder recorder;
+    REQUIRE(jb.parseEvents(json, recorder));
+    REQUIRE("{ a:[ \"b\" #1 ] }" == recorder.log);
+    REQUIRE(0 == jb.size());
+  }
+
+  SECTION("std::string") {
+    DynamicJsonBuffer jb;
+    EventRecorder recorder;
+    REQUIRE(jb.parseEvents(std::string("[\"a\"]"), recorder));
+    REQUIRE("[ \"a\" ]" == recorder.log);
+  }
+
+  SECTION("std::istream") {
+    std::istringstream json("{\"a\":1}");
+    DynamicJsonBuffer jb;
+    EventRecorder recorder;
+    REQUIRE(jb.parseEvents(json, recorder));
+    REQUIRE("{ a:#1 }" == recorder.log);
+  }
+}
+
+// The sections of parseArray.cpp, the events must match the tree
+TEST_CASE("JsonBuffer::parseEvents() arrays") {
+  SECTION("EmptyArrayWithLeadingSpaces") {
+    REQUIRE("[ ]" == events("  []"));
+  }
+
+  SECTION("EmptyArrayWithInnerSpaces") {
+    REQUIRE("[ ]" == events("[ \t\r\n]"));
+  }
+
+  SECTION("OneInteger") {
+    REQUIRE("[ #42 ]" == events("[42]"));
+  }
+
+  SECTION("OneIntegerWithSpacesBefore") {
+    REQUIRE("[ #42 ]" == events("[ \t\r\n42]"));
+  }
+
+  SECTION("OneIntegerWithSpaceAfter") {
+    REQUIRE("[ #42 ]" == events("[42 \t\r\n]"));
+  }
+
+  SECTION("TwoIntegers") {
+    REQUIRE("[ #42 #84 ]" == events("[42,84]"));
+  }
+
+  SECTION("TwoDoubles") {
+    REQUIRE("[ 4.2 1e2 ]" == events("[4.2,1e2]"));
+  }
+
+  SECTION("UnsignedLong") {
+    REQUIRE("[ #4294967295 ]" == events("[4294967295]"));
+  }
+
+  SECTION("TwoBooleans") {
+    REQUIRE("[ true false ]" == events("[true,false]"));
+  }
+
+  SECTION("TwoNulls") {
+    REQUIRE("[ null null ]" == events("[null,null]"));
+  }
+
+  SECTION("TwoStringsDoubleQuotes") {
+    REQUIRE("[ \"hello\" \"world\" ]" ==
+            events("[ \"hello\" , \"world\" ]"));
+  }
+
+  SECTION("TwoStringsSingleQuotes") {
+    REQUIRE("[ \"hello\" \"world\" ]" == events("[ 'hello' , 'world' ]"));
+  }
+
+  SECTION("TwoStringsNoQuotes") {
+    REQUIRE("[ hello world ]" == events("[ hello , world ]"));
+  }
+
+  SECTION("EmptyStringsDoubleQuotes") {
+    REQUIRE("[ \"\" \"\" ]" == events("[\"\",\"\"]"));
+  }
+
+  SECTION("EmptyStringSingleQuotes") {
+    REQUIRE("[ \"\" \"\" ]" == events("[\'\',\'\']"));
+  }
+
+  SECTION("EmptyStringNoQuotes") {
+    REQUIRE("[ <> <> ]" == events("[,]"));
+  }
+
+  SECTION("Trailing comma") {
+    REQUIRE("[ #1 <> ]" == events("[1,]"));
+  }
+
+  SECTION("Two commas") {
+    REQUIRE("[ #1 <> #2 ]" == events("[1,,2]"));
+  }
+
+  SECTION("ClosingDoubleQuoteMissing") {
+    REQUIRE("error" == events("[\"]"));
+  }
+
+  SECTION("ClosingSingleQuoteMissing") {
+    REQUIRE("error" == events("[\']"));
+  }
+
+  SECTION("Unterminated string") {
+    REQUIRE("error" == events("[\"hello"));
+    REQUIRE("error" == events("['hello"));
+  }
+
+  SECTION("StringWithEscapedChars") {
+    REQUIRE("[ \"1\"2\\3/4\b5\f6\n7\r8\t9\" ]" ==
+            events("[\"1\\\"2\\\\3\\/4\\b5\\f6\\n7\\r8\\t9\"]"));
+  }
+
+  SECTION("StringWithUnterminatedEscapeSequence") {
+    DynamicJsonBuffer jb;
+    EventRecorder recorder;
+    REQUIRE_FALSE(jb.parseEvents(std::string("[\"\\\0\"]", 5), recorder));
+  }
+
+  SECTION("Escape at the end of the input") {
+    REQUIRE("error" == events("[\"a\\"));
+  }
+
+  SECTION("Escaped closing quote only") {
+    REQUIRE("error" == events("[\"a\\\"]"));
+  }
+
+  SECTION("Unknown escape keeps the char") {
+    REQUIRE("[ \"x\" ]" == events("[\"\\x\"]"));
+  }
+
+  SECTION("CCommentBeforeOpeningBracket") {
+    REQUIRE("[ \"hello\" ]" == events("/*COMMENT*/  [\"hello\"]"));
+  }
+
+  SECTION("CCommentAfterOpeningBracket") {
+    REQUIRE("[ \"hello\" ]" == events("[/*COMMENT*/ \"hello\"]"));
+  }
+
+  SECTION("CCommentBeforeClosingBracket") {
+    REQUIRE("[ \"hello\" ]" == events("[\"hello\"/*COMMENT*/]"));
+  }
+
+  SECTION("CCommentAfterClosingBracket") {
+    REQUIRE("[ \"hello\" ]" == events("[\"hello\"]/*COMMENT*/"));
+  }
+
+  SECTION("CCommentBeforeComma") {
+    REQUIRE("[ \"hello\" \"world\" ]" ==
+            events("[\"hello\"/*COMMENT*/,\"world\"]"));
+  }
+
+  SECTION("CCommentAfterComma") {
+    REQUIRE("[ \"hello\" \"world\" ]" ==
+            events("[\"hello\",/*COMMENT*/ \"world\"]"));
+  }
+
+  SECTION("CppCommentBeforeOpeningBracket") {
+    REQUIRE("[ \"hello\" ]" == events("//COMMENT\n\t[\"hello\"]"));
+  }
+
+  SECTION("CppCommentAfterOpeningBracket") {
+    REQUIRE("[ \"hello\" ]" == events("[//COMMENT\n\"hello\"]"));
+  }
+
+  SECTION("CppCommentBeforeClosingBracket") {
+    REQUIRE("[ \"hello\" ]" == events("[\"hello\"//COMMENT\r\n]"));
+  }
+
+  SECTION("CppCommentAfterClosingBracket") {
+    REQUIRE("[ \"hello\" ]" == events("[\"hello\"]//COMMENT\n"));
+  }
+
+  SECTION("CppCommentBeforeComma") {
+    REQUIRE("[ \"hello\" \"world\" ]" ==
+            events("[\"hello\"//COMMENT\n,\"world\"]"));
+  }
+
+  SECTION("CppCommentAfterComma") {
+    REQUIRE("[ \"hello\" \"world\" ]" ==
+            events("[\"hello\",//COMMENT\n\"world\"]"));
+  }
+
+  SECTION("InvalidCppComment") {
+    REQUIRE("error" == events("[/COMMENT\n]"));
+  }
+
+  SECTION("InvalidComment") {
+    REQUIRE("error" == events("[/*/\n]"));
+  }
+
+  SECTION("UnfinishedCComment") {
+    REQUIRE("error" == events("[/*COMMENT]"));
+  }
+
+  SECTION("EndsInCppComment") {
+    REQUIRE("error" == events("[//COMMENT"));
+  }
+
+  SECTION("AfterClosingStar") {
+    REQUIRE("error" == events("[/*COMMENT*"));
+  }
+
+  SECTION("Lone slash") {
+    REQUIRE("error" == events("[/"));
+  }
+
+  SECTION("DeeplyNested") {
+    REQUIRE("[ [ [ [ [ [ [ [ [ \"Not too deep\" ] ] ] ] ] ] ] ] ]" ==
+            events("[[[[[[[[[\"Not too deep\"]]]]]]]]]"));
+  }
+
+  SECTION("Text after the closing bracket is ignored") {
+    REQUIRE("[ #1 ]" == events("[1] x"));
+  }
+}
+
+// The sections of parseObject.cpp, the events must match the tree
+TEST_CASE("JsonBuffer::parseEvents() objects") {
+  SECTION("Quotes") {
+    SECTION("Double quotes") {
+      REQUIRE("{ key:\"value\" }" == events("{\"key\":\"value\"}"));
+    }
+
+    SECTION("Single quotes") {
+      REQUIRE("{ key:\"value\" }" == events("{'key':'value'}"));
+    }
+
+    SECTION("No quotes") {
+      REQUIRE("{ key:value }" == events("{key:value}"));
+    }
+
+    SECTION("No quotes, allow underscore in key") {
+      REQUIRE("{ _k_e_y_:#42 }" == events("{_k_e_y_:42}"));
+    }
+
+    SECTION("Number as a key") {
+      REQUIRE("{ 1:#2 }" == events("{1:2}"));
+    }
+  }
+
+  SECTION("Spaces") {
+    SECTION("Before the key") {
+      REQUIRE("{ key:\"value\" }" == events("{ \"key\":\"value\"}"));
+    }
+
+    SECTION("After the key") {
+      REQUIRE("{ key:\"value\" }" == events("{\"key\" :\"value\"}"));
+    }
+
+    SECTION("Before the value") {
+      REQUIRE("{ key:\"value\" }" == events("{\"key\": \"value\"}"));
+    }
+
+    SECTION("After the value") {
+      REQUIRE("{ key:\"value\" }" == events("{\"key\":\"value\" }"));
+    }
+
+    SECTION("Before the comma") {
+      REQUIRE("{ key1:\"value1\" key2:\"value2\" }" ==
+              events("{\"key1\":\"value1\" ,\"key2\":\"value2\"}"));
+    }
+
+    SECTION("After the comma") {
+      REQUIRE("{ key1:\"value1\" key2:\"value2\" }" ==
+              events("{\"key1\":\"value1\", \"key2\":\"value2\"}"));
+    }
+
+    SECTION("Everywhere") {
+      REQUIRE("{ a:#1 b:[ #2 ] }" ==
+              events(" \t{ \r\n\"a\" : 1 ,\n\"b\"\t:\t[ 2 ] \n} "));
+    }
+  }
+
+  SECTION("Comments") {
+    SECTION("C comments around every token") {
+      REQUIRE("{ a:#1 }" == events("{/*c*/\"a\"/*c*/:/*c*/1/*c*/}"));
+    }
+
+    SECTION("C++ comments around every token") {
+      REQUIRE("{ a:#1 }" == events("{//c\n\"a\"//c\n://c\n1//c\n}"));
+    }
+
+    SECTION("Unfinished comment in a key") {
+      REQUIRE("error" == events("{\"a\"/*:1}"));
+    }
+  }
+
+  SECTION("Values types") {
+    SECTION("String") {
+      REQUIRE("{ key1:\"value1\" key2:\"value2\" }" ==
+              events("{\"key1\":\"value1\",\"key2\":\"value2\"}"));
+    }
+
+    SECTION("Integer") {
+      REQUIRE("{ key1:#42 key2:#-42 }" == events("{\"key1\":42,\"key2\":-42}"));
+    }
+
+    SECTION("Double") {
+      REQUIRE("{ key1:12.345 key2:-7E89 }" ==
+              events("{\"key1\":12.345,\"key2\":-7E89}"));
+    }
+
+    SECTION("Booleans") {
+      REQUIRE("{ key1:true key2:false }" ==
+              events("{\"key1\":true,\"key2\":false}"));
+    }
+
+    SECTION("Null") {
+      REQUIRE("{ key1:null key2:null }" ==
+              events("{\"key1\":null,\"key2\":null}"));
+    }
+
+    SECTION("Empty non-quoted values") {
+      REQUIRE("{ a:<> b:<> }" == events("{\"a\":,\"b\":}"));
+    }
+  }
+
+  SECTION("Misc") {
+    SECTION("The opening brace is missing") {
+      REQUIRE("error" == events("}"));
+    }
+
+    SECTION("The closing brace is missing") {
+      REQUIRE("error" == events("{"));
+    }
+
+    SECTION("A quoted key without value") {
+      REQUIRE("error" == events("{\"key\"}"));
+    }
+
+    SECTION("A non-quoted key without value") {
+      REQUIRE("error" == events("{key}"));
+    }
+
+    SECTION("A dangling comma") {
+      REQUIRE("error" == events("{\"key1\":\"value1\",}"));
+    }
+
+    SECTION("Only a comma") {
+      REQUIRE("error" == events("{,}"));
+    }
+
+    SECTION("null as a key") {
+      // Any value is a document, what follows it is ignored
+      REQUIRE("null" == events("null:\"value\"}"));
+    }
+
+    SECTION("Two colons") {
+      REQUIRE("error" == events("{\"a\"::1}"));
+    }
+
+    SECTION("Two values") {
+      REQUIRE("error" == events("{a:b:c}"));
+    }
+
+    SECTION("Missing comma between members") {
+      REQUIRE("error" == events("{\"a\":1 \"b\":2}"));
+    }
+
+    SECTION("Unterminated key") {
+      REQUIRE("error" == events("{\"key:1}"));
+    }
+
+    SECTION("Unterminated value") {
+      REQUIRE("error" == events("{\"key\":'value}"));
+    }
+
+    SECTION("Bad escape at the end of a key") {
+      REQUIRE("error" == events("{\"key\\"));
+    }
+
+    SECTION("Escaped key") {
+      REQUIRE("{ a\"b:#1 }" == events("{\"a\\\"b\":1}"));
+    }
+
+    SECTION("Text after the closing brace is ignored") {
+      REQUIRE("{ a:#1 }" == events("{\"a\":1}}"));
+    }
+  }
+}
+
+TEST_CASE("JsonBuffer::parseEvents() errors") {
+  SECTION("MissingOpeningBracket") {
+    REQUIRE("error" == events("]"));
+  }
+
+  SECTION("ArrayWithNoEnd") {
+    REQUIRE("error" == events("["));
+  }
+
+  SECTION("MissingComma") {
+    REQUIRE("error" == events("[1 2]"));
+  }
+
+  SECTION("ObjectWithNoEnd") {
+    REQUIRE("error" == events("{\"a\":1"));
+  }
+
+  SECTION("MissingColon") {
+    REQUIRE("error" == events("{\"a\" 1}"));
+  }
+
+  SECTION("Garbage") {
+    REQUIRE("error" == events("%*$£¤"));
+  }
+
+  SECTION("Incomplete comment") {
+    REQUIRE("error" == events("[/*]"));
+  }
+
+  SECTION("Empty document") {
+    REQUIRE("error" == events(""));
+    REQUIRE("error" == events(" \t\r\n"));
+    REQUIRE("error" == events("/* only a comment */"));
+  }
+}
+
+TEST_CASE("JsonBuffer::parseEvents() nestingLimit") {
+  SECTION("Array") {
+    REQUIRE("[ ]" == events("[]", 0));
+    REQUIRE("error" == events("[[]]", 0));
+    REQUIRE("[ [ ] ]" == events("[[]]", 1));
+    REQUIRE("error" == events("[[[]]]", 1));
+  }
+
+  SECTION("Object") {
+    REQUIRE("{ }" == events("{}", 0));
+    REQUIRE("error" == events("{\"key\":{}}", 0));
+    REQUIRE("{ key:{ } }" == events("{\"key\":{}}", 1));
+  }
+}
+
+TEST_CASE("JsonBuffer::parseEvents() handler") {
+  DynamicJsonBuffer jb;
+  EventRecorder recorder;
+
+  SECTION("Stops when the handler returns false") {
+    recorder.stopAfter = 2;
+    REQUIRE_FALSE(jb.parseEvents("[1,2,3,4]", recorder));
+    REQUIRE("[ #1 #2" == recorder.log);
+  }
+
+  SECTION("Base class ignores the events") {
+    JsonEventHandler ignore;
+    REQUIRE(jb.parseEvents("{\"a\":[1,{\"b\":null}]}", ignore));
+  }
+}
+
+TEST_CASE("JsonBuffer::parseEvents() memory") {
+  // The strings are given back after each event, so the document can be much
+  // bigger than the buffer.
+  std::string json = "[";
+  for (int i = 0; i < 1000; i++) {
+    if (i) json += ',';
+    json += "{\"key\":\"value\",\"number\":1234.5}";
+  }
+  json += "]";
+
+  SECTION("Fits in a small buffer") {
+    StaticJsonBuffer<16> jb;
+    EventRecorder recorder;
+    REQUIRE(jb.parseEvents(json, recorder));
+    REQUIRE(0 == jb.size());
+  }
+
+  SECTION("Fails if a string doesn't fit") {
+    StaticJsonBuffer<6> jb;
+    JsonEventHandler ignore;
+    REQUIRE_FALSE(jb.parseEvents(json, ignore));
+  }
+}
@@ -0,0 +1,73 @@
+// ArduinoJson - arduinojson.org
+// Copyright Benoit Blanchon 2014-2018
+// MIT License
+
+#include <ArduinoJson.h>
+#include <catch.hpp>
+#include <string>
+
+using namespace Catch::Matchers;
+
+TEST_CASE("JsonTapeValue::as()") {
+  StaticJsonTape<16> tape;
+
+  SECTION("Integer") {
+    char json[] = "[-42]";
+    JsonTapeValue value = tape.parse(json)[0];
+    REQUIRE(value.is<int>());
+    REQUIRE(-42 == value.as<int>());
+  }
+
+  SECTION("Float") {
+    char json[] = "[1.23e+4]";
+    JsonTapeValue value = tape.parse(json)[0];
+    REQUIRE(value.is<double>());
+    REQUIRE_FALSE(value.is<int>());
+    REQUIRE(1.23e+4 == value.as<double>());
+  }
+
+  SECTION("Booleans") {
+    char json[] = "[true,false]";
+    JsonTapeValue root = tape.parse(json);
+    REQUIRE(root[0].is<bool>());
+    REQUIRE(true == root[0].as<bool>());
+    REQUIRE(false == root[1].as<bool>());
+  }
+
+  SECTION("Null") {
+    char json[] = "[null]";
+    REQUIRE(0 == tape.parse(json)[0].as<const char*>());
+  }
+
+  SECTION("String") {
+    char json[] = "[\"hello\",'world']";
+    JsonTapeValue root = tape.parse(json);
+    REQUIRE(root[0].is<const char*>());
+    REQUIRE_THAT(root[0].as<const char*>(), Equals("hello"));
+    REQUIRE_THAT(root[1].as<const char*>(), Equals("world"));
+  }
+
+  SECTION("Escaped string is unescaped in place") {
+    char json[] = "[\"1\\\"2\\\\3\\/4\\b5\\f6\\n7\\r8\\t9\",0]";
+    JsonTapeValue root = tape.parse(json);
+    const char* s = root[0].as<const char*>();
+    REQUIRE_THAT(s, Equals("1\"2\\3/4\b5\f6\n7\r8\t9"));
+    REQUIRE(json + 2 == s);
+    REQUIRE(s == root[0].as<const char*>());
+    REQUIRE(0 == root[1].as<int>());
+  }
+
+  SECTION("Values are decoded only when read") {
+    char json[] = "[\"a\\nb\",1,2]";
+    JsonTapeValue root = tape.parse(json);
+    REQUIRE(2 == root[2].as<int>());
+    REQUIRE(std::string("[\"a\\nb\",1,") == std::string(json, 10));
+  }
+
+  SECTION("Object as a value") {
+    char json[] = "{}";
+    JsonTapeValue root = tape.parse(json);
+    REQUIRE_FALSE(root.is<int>());
+    REQUIRE(0 == root.as<const char*>());
+  }
+}
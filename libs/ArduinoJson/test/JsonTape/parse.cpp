@@ -0,0 +1,91 @@
+// ArduinoJson - arduinojson.org
+// Copyright Benoit Blanchon 2014-2018
+// MIT License
+
+#include <ArduinoJson.h>
+#include <catch.hpp>
+#include <string>
+
+static bool tryParse(const char* json, uint8_t nestingLimit = 10) {
+  std::string copy(json);
+  StaticJsonTape<16> tape;
+  return tape.parse(&copy[0], nestingLimit).success();
+}
+
+TEST_CASE("JsonTape::parse()") {
+  StaticJsonTape<16> tape;
+
+  SECTION("EmptyObject") {
+    char json[] = "{}";
+    JsonTapeValue root = tape.parse(json);
+    REQUIRE(root.success());
+    REQUIRE(root.isObject());
+    REQUIRE(0 == root.size());
+    REQUIRE(1 == tape.size());
+  }
+
+  SECTION("EmptyArray") {
+    char json[] = " [ ] ";
+    JsonTapeValue root = tape.parse(json);
+    REQUIRE(root.isArray());
+    REQUIRE(0 == root.size());
+  }
+
+  SECTION("One token per value and per key") {
+    char json[] = "{\"a\":[1,2],\"b\":{\"c\":null}}";
+    JsonTapeValue root = tape.parse(json);
+    REQUIRE(root.success());
+    REQUIRE(9 == tape.size());
+    REQUIRE(2 == root.size());
+  }
+
+  SECTION("Input is not modified by the parsing") {
+    char json[] = "{\"a\":\"b\\nc\",\"d\":1}";
+    tape.parse(json);
+    REQUIRE(std::string("{\"a\":\"b\\nc\",\"d\":1}") == json);
+  }
+
+  SECTION("Tape too small") {
+    StaticJsonTape<2> smallTape;
+    char json[] = "[1,2]";
+    REQUIRE_FALSE(smallTape.parse(json).success());
+  }
+
+  SECTION("Tape of the right size") {
+    StaticJsonTape<3> smallTape;
+    char json[] = "[1,2]";
+    REQUIRE(smallTape.parse(json).success());
+  }
+
+  SECTION("Null input") {
+    REQUIRE_FALSE(tape.parse(0).success());
+  }
+
+  SECTION("Comments") {
+    REQUIRE(tryParse("/*a*/[1 // b\n,2]"));
+  }
+
+  SECTION("Single quotes and unquoted keys") {
+    REQUIRE(tryParse("{key:'value'}"));
+  }
+
+  SECTION("Invalid input") {
+    REQUIRE_FALSE(tryParse(""));
+    REQUIRE_FALSE(tryParse("]"));
+    REQUIRE_FALSE(tryParse("["));
+    REQUIRE_FALSE(tryParse("[1 2]"));
+    REQUIRE_FALSE(tryParse("[1,]"));
+    REQUIRE_FALSE(tryParse("{\"a\" 1}"));
+    REQUIRE_FALSE(tryParse("{\"a\":1"));
+    REQUIRE_FALSE(tryParse("\"unterminated"));
+    REQUIRE_FALSE(tryParse("\"escaped end\\"));
+    REQUIRE_FALSE(tryParse("%*$"));
+  }
+
+  SECTION("Nesting limit") {
+    REQUIRE(tryParse("[]", 0));
+    REQUIRE_FALSE(tryParse("[[]]", 0));
+    REQUIRE(tryParse("[[]]", 1));
+    REQUIRE_FALSE(tryParse("{\"a\":{\"b\":{}}}", 1));
+  }
+}
@@ -0,0 +1,66 @@
+// ArduinoJson - arduinojson.org
+// Copyright Benoit Blanchon 2014-2018
+// MIT License
+
+#include <ArduinoJson.h>
+#include <catch.hpp>
+
+TEST_CASE("JsonTapeValue subscripts") {
+  StaticJsonTape<32> tape;
+  char json[] =
+      "{\"list\":[{\"dt\":1,\"main\":{\"temp\":-1.5}},[],"
+      "{\"dt\":3,\"wind\":{\"deg\":270}}],\"cnt\":3}";
+  JsonTapeValue root = tape.parse(json);
+  REQUIRE(root.success());
+
+  SECTION("Key") {
+    REQUIRE(3 == root["cnt"].as<int>());
+  }
+
+  SECTION("Key after a skipped array") {
+    long cnt = root["cnt"];
+    REQUIRE(3 == cnt);
+  }
+
+  SECTION("Index") {
+    REQUIRE(3 == root["list"].size());
+    REQUIRE(270 == root["list"][2]["wind"]["deg"].as<int>());
+    REQUIRE(root["list"][1].isArray());
+  }
+
+  SECTION("Nested") {
+    REQUIRE(-1.5 == root["list"][0]["main"]["temp"].as<double>());
+  }
+
+  SECTION("Missing key") {
+    REQUIRE_FALSE(root["missing"].success());
+    REQUIRE(0 == root["missing"].as<int>());
+    REQUIRE_FALSE(root["list"][0]["wind"]["deg"].success());
+  }
+
+  SECTION("Index out of range") {
+    REQUIRE_FALSE(root["list"][3].success());
+  }
+
+  SECTION("Subscript of the wrong type") {
+    REQUIRE_FALSE(root[0].success());
+    REQUIRE_FALSE(root["list"]["dt"].success());
+    REQUIRE_FALSE(root["cnt"]["dt"].success());
+    REQUIRE(0 == root["cnt"].size());
+  }
+
+  SECTION("Same key read twice") {
+    REQUIRE(1 == root["list"][0]["dt"].as<int>());
+    REQUIRE(1 == root["list"][0]["dt"].as<int>());
+  }
+}
+
+TEST_CASE("JsonTapeValue escaped keys") {
+  StaticJsonTape<8> tape;
+  char json[] = "{\"a\\\"b\":1,'c':2,d:3}";
+  JsonTapeValue root = tape.parse(json);
+
+  REQUIRE(1 == root["a\"b"].as<int>());
+  REQUIRE(2 == root["c"].as<int>());
+  REQUIRE(3 == root["d"].as<int>());
+}
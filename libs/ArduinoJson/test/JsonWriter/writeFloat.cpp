@@ -3,14 +3,30 @@
 // MIT License
 
 #include <catch.hpp>
+#include <ctime>
+#include <iostream>
 #include <limits>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
 #include <string>
 
 #include <ArduinoJson/Serialization/DynamicStringBuilder.hpp>
 #include <ArduinoJson/Serialization/JsonWriter.hpp>
+#include <ArduinoJson/Serialization/formatFloat.hpp>
 
 using namespace ArduinoJson::Internals;
 
+template <typename TFloat>
+std::string toString(TFloat input, int8_t decimals) {
+  std::string output;
+  DynamicStringBuilder<std::string> sb(output);
+  JsonWriter<DynamicStringBuilder<std::string> > writer(sb);
+  writer.writeFloat(input, decimals);
+  REQUIRE(writer.bytesWritten() == output.size());
+  return output;
+}
+
 template <typename TFloat>
 void check(TFloat input, const std::string& expected) {
   std::string output;
@@ -21,6 +37,28 @@ void check(TFloat input, const std::string& expected) {
   CHECK(expected == output);
 }
 
+template <typename TFloat>
+void check(TFloat input, const std::string& expected, int8_t decimals) {
+  CHECK(expected == toString(input, decimals));
+}
+
+// xorshift32, a reproducible sequence of 32-bit patterns
+static uint32_t nextBits(uint32_t& state) {
+  state ^= state << 13;
+  state ^= state >> 17;
+  state ^= state << 5;
+  return state;
+}
+
+static double readDouble(const std::string& s) {
+  return strtod(s.c_str(), NULL);
+}
+
+static float readFloat(const std::string& s) {
+  return strtof(s.c_str(), NULL);
+}
+
+#if !ARDUINOJSON_ROUND_TRIP_FLOATS
 TEST_CASE("JsonWriter::writeFloat(double)") {
   SECTION("Pi") {
     check<double>(3.14159265359, "3.141592654");
@@ -115,3 +153,168 @@ TEST_CASE("JsonWriter::writeFloat(float)") {
     check<float>(24.3f, "24.3");
   }
 }
+#else
+TEST_CASE("JsonWriter::writeFloat() with ARDUINOJSON_ROUND_TRIP_FLOATS") {
+  SECTION("Pi") {
+    check<double>(3.14159265359, "3.14159265359");
+    check<float>(3.14159265359f, "3.1415927");
+  }
+
+  SECTION("NaN and Infinity") {
+    check<double>(std::numeric_limits<double>::quiet_NaN(), "NaN");
+    check<double>(-std::numeric_limits<double>::infinity(), "-Infinity");
+  }
+
+  SECTION("Exponents") {
+    check<double>(1e-5, "1e-5");
+    check<double>(10000000.0, "1e7");
+    check<double>(9999999.999, "9999999.999");
+  }
+
+  SECTION("24.3") {  // # issue #588
+    check<float>(24.3f, "24.3");
+  }
+}
+#endif
+
+TEST_CASE("JsonWriter::writeFloat(double, FLOAT_SHORTEST)") {
+  SECTION("Pi") {
+    check<double>(3.14159265359, "3.14159265359", FLOAT_SHORTEST);
+  }
+
+  SECTION("0.1") {
+    check<double>(0.1, "0.1", FLOAT_SHORTEST);
+  }
+
+  SECTION("Max double") {
+    check<double>(1.7976931348623157E+308, "1.7976931348623157e308",
+                  FLOAT_SHORTEST);
+  }
+
+  SECTION("Min double") {
+    check<double>(4.94065645841247e-324, "5e-324", FLOAT_SHORTEST);
+  }
+
+  SECTION("Round trip") {
+    uint32_t state = 2463534242u;
+    for (int i = 0; i < 100000; i++) {
+      uint64_t bits = uint64_t(nextBits(state)) << 32 | nextBits(state);
+      double value;
+      memcpy(&value, &bits, sizeof(value));
+      if (value != value || value - value != 0) continue;  // NaN or infinity
+      std::string output = toString(value, FLOAT_SHORTEST);
+      INFO(output);
+      REQUIRE(readDouble(output) == value);
+    }
+  }
+}
+
+TEST_CASE("JsonWriter::writeFloat(float, FLOAT_SHORTEST)") {
+  SECTION("Pi") {
+    check<float>(3.14159265359f, "3.1415927", FLOAT_SHORTEST);
+  }
+
+  SECTION("Round trip") {
+    uint32_t state = 2463534242u;
+    for (int i = 0; i < 100000; i++) {
+      uint32_t bits = nextBits(state);
+      float value;
+      memcpy(&value, &bits, sizeof(value));
+      if (value != value || value - value != 0) continue;  // NaN or infinity
+      std::string output = toString(value, FLOAT_SHORTEST);
+      INFO(output);
+      REQUIRE(readFloat(output) == value);
+    }
+  }
+
+  SECTION("Round trip of the sensor range") {
+    for (int i = -50000; i <= 50000; i++) {
+      float value = float(i) / 100;
+      REQUIRE(readFloat(toString(value, FLOAT_SHORTEST)) == value);
+    }
+  }
+}
+
+TEST_CASE("JsonWriter::writeFloat(value, decimals)") {
+  SECTION("Pads with zeros") {
+    check<float>(24.3f, "24.30", 2);
+    check<double>(0, "0.00", 2);
+    check<double>(1e10, "10000000000.0", 1);
+  }
+
+  SECTION("Rounds half up") {
+    check<float>(749.96f, "750.0", 1);
+    check<double>(0.125, "0.13", 2);
+    check<double>(0.5, "1", 0);
+    check<double>(-0.001, "-0.00", 2);
+  }
+
+  SECTION("Rounds the exact value, not the shortest digits") {
+    check<double>(1.0049999999999999, "1.00", 2);
+    check<float>(21.0049992f, "21.00", 2);
+    check<double>(0.1, "0.10000000000000001", 17);
+  }
+
+  SECTION("Matches printf() in the sensor range") {
+    char expected[16];
+    for (int i = -50000; i <= 50000; i++) {
+      float value = float(i) / 100;
+      snprintf(expected, sizeof(expected), "%.2f", double(value));
+      if (!strcmp(expected, "-0.00")) continue;  // no negative zero
+      REQUIRE(toString(value, 2) == expected);
+    }
+  }
+
+  SECTION("Never uses exponents") {
+    check<double>(1e-7, "0.0000001", 7);
+    check<double>(1e-7, "0.000", 3);
+  }
+}
+
+// Millions of sensor like values (-40.00 to 79.99) formatted per second
+template <typename TFormat>
+static double formatThroughput(TFormat format) {
+  char buffer[32];
+  const int passes = 50;
+  size_t length = 0;
+  std::clock_t start = std::clock();
+  for (int i = 0; i < passes; i++) {
+    for (int j = -4000; j < 8000; j++)
+      length += format(float(j) / 100, buffer, sizeof(buffer));
+  }
+  std::clock_t stop = std::clock();
+  REQUIRE(length > 0);
+  return passes * 12000 / 1e6 / static_cast<double>(stop - start) *
+         CLOCKS_PER_SEC;
+}
+
+static size_t formatDefault(float value, char* buffer, size_t size) {
+  return ArduinoJson::formatFloat(value, buffer, size);
+}
+
+static size_t formatShortest(float value, char* buffer, size_t size) {
+  StaticStringBuilder sb(buffer, size);
+  JsonWriter<StaticStringBuilder> writer(sb);
+  writer.writeFloat(value, FLOAT_SHORTEST);
+  return writer.bytesWritten();
+}
+
+static size_t formatTwoDecimals(float value, char* buffer, size_t size) {
+  return ArduinoJson::formatFloat(value, buffer, size, 2);
+}
+
+static size_t printTwoDecimals(float value, char* buffer, size_t size) {
+  return size_t(snprintf(buffer, size, "%.2f", value));
+}
+
+// Run with: JsonWriterTests [benchmark]
+TEST_CASE("JsonWriter::writeFloat() benchmark", "[.][benchmark]") {
+  std::cout << "formatFloat(): " << formatThroughput(formatDefault)
+            << " M/s" << std::endl;
+  std::cout << "writeFloat(, FLOAT_SHORTEST): "
+            << formatThroughput(formatShortest) << " M/s" << std::endl;
+  std::cout << "formatFloat(, 2): " << formatThroughput(formatTwoDecimals)
+            << " M/s" << std::endl;
+  std::cout << "snprintf(\"%.2f\"): " << formatThroughput(printTwoDecimals)
+            << " M/s" << std::endl;
+}
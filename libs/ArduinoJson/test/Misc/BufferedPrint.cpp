@@ -0,0 +1,106 @@
+// ArduinoJson - arduinojson.org
+// Copyright Benoit Blanchon 2014-2018
+// MIT License
+
+#include <ArduinoJson.h>
+#include <catch.hpp>
+#include <string>
+
+// Counts the calls, like a File or a WiFiClient would count flash or TCP
+// writes. Accepts at most `capacity` bytes.
+class WriteCounter {
+ public:
+  WriteCounter(size_t capacity = 1000) : writes(0), _capacity(capacity) {}
+
+  size_t write(const uint8_t* bytes, size_t length) {
+    writes++;
+    if (length > _capacity - output.size())
+      length = _capacity - output.size();
+    output.append(reinterpret_cast<const char*>(bytes), length);
+    return length;
+  }
+
+  int writes;
+  std::string output;
+
+ private:
+  size_t _capacity;
+};
+
+TEST_CASE("BufferedPrint") {
+  WriteCounter counter;
+  char block[4];
+
+  SECTION("Writes nothing until full") {
+    ArduinoJson::Internals::BufferedPrint<WriteCounter> print(counter, block,
+                                                              sizeof(block));
+    REQUIRE(3 == print.print("ABC"));
+    REQUIRE(0 == counter.writes);
+  }
+
+  SECTION("Writes by blocks") {
+    ArduinoJson::Internals::BufferedPrint<WriteCounter> print(counter, block,
+                                                              sizeof(block));
+    REQUIRE(10 == print.print("ABCDEFGHIJ"));
+    REQUIRE(1 == print.print('K'));
+    REQUIRE(2 == counter.writes);
+    REQUIRE(print.flush());
+    REQUIRE(3 == counter.writes);
+    REQUIRE(std::string("ABCDEFGHIJK") == counter.output);
+  }
+
+  SECTION("Flushes when destroyed") {
+    {
+      ArduinoJson::Internals::BufferedPrint<WriteCounter> print(
+          counter, block, sizeof(block));
+      print.print("AB");
+    }
+    REQUIRE(1 == counter.writes);
+    REQUIRE(std::string("AB") == counter.output);
+  }
+}
+
+TEST_CASE("JsonObject::printTo(destination, block)") {
+  DynamicJsonBuffer jsonBuffer;
+  JsonObject& obj = jsonBuffer.createObject();
+  obj["ssid"] = "my-network";
+  obj["password"] = "0123456789abcdef";
+  obj["mqtt_port"] = 1883;
+  obj["temperature"] = 21.5;
+
+  std::string expected;
+  obj.printTo(expected);
+
+  SECTION("One write per block") {
+    WriteCounter counter;
+    char block[16];
+    REQUIRE(expected.size() == obj.printTo(counter, block));
+    REQUIRE(expected == counter.output);
+    REQUIRE(int((expected.size() + 15) / 16) == counter.writes);
+  }
+
+  SECTION("One write when the block is as large as the document") {
+    WriteCounter counter;
+    char block[128];
+    REQUIRE(obj.measureLength() == obj.printTo(counter, block));
+    REQUIRE(expected == counter.output);
+    REQUIRE(1 == counter.writes);
+  }
+
+  SECTION("Pretty") {
+    std::string prettyExpected;
+    obj.prettyPrintTo(prettyExpected);
+
+    WriteCounter counter;
+    char block[32];
+    REQUIRE(obj.measurePrettyLength() == obj.prettyPrintTo(counter, block));
+    REQUIRE(prettyExpected == counter.output);
+    REQUIRE(int((prettyExpected.size() + 31) / 32) == counter.writes);
+  }
+
+  SECTION("Returns 0 when the destination is full") {
+    WriteCounter counter(10);
+    char block[16];
+    REQUIRE(0 == obj.printTo(counter, block));
+  }
+}
@@ -0,0 +1,106 @@
+// ArduinoJson - arduinojson.org
+// Copyright Benoit Blanchon 2014-2018
+// MIT License
+
+#include <ArduinoJson/Serialization/FloatDigits.hpp>
+#include <catch.hpp>
+#include <string>
+
+using namespace ArduinoJson::Internals;
+
+template <typename TFloat>
+std::string digitsOf(const FloatDigits<TFloat>& digits) {
+  return std::string(digits.digits, size_t(digits.length));
+}
+
+TEST_CASE("FloatDigits<double>") {
+  SECTION("1.7976931348623157E+308") {
+    FloatDigits<double> digits(1.7976931348623157E+308);
+    REQUIRE(digitsOf(digits) == "17976931348623157");
+    REQUIRE(digits.exponent == 308);
+  }
+
+  SECTION("4.94065645841247e-324") {
+    FloatDigits<double> digits(4.94065645841247e-324);
+    REQUIRE(digitsOf(digits) == "5");
+    REQUIRE(digits.exponent == -324);
+  }
+
+  SECTION("0") {
+    FloatDigits<double> digits(0.0);
+    REQUIRE(digits.length == 0);
+  }
+
+  SECTION("0.1") {
+    FloatDigits<double> digits(0.1);
+    REQUIRE(digitsOf(digits) == "1");
+    REQUIRE(digits.exponent == -1);
+  }
+
+  SECTION("1000") {
+    FloatDigits<double> digits(1000.0);
+    REQUIRE(digitsOf(digits) == "1");
+    REQUIRE(digits.exponent == 3);
+  }
+
+  SECTION("Decimals") {
+    FloatDigits<double> digits(0.1234567895, 9);
+    REQUIRE(digitsOf(digits) == "123456789");  // 0.12345678949999999707
+    REQUIRE(digits.exponent == -1);
+  }
+
+  SECTION("Decimals carry") {
+    FloatDigits<double> digits(99.96, 1);
+    REQUIRE(digitsOf(digits) == "1");
+    REQUIRE(digits.exponent == 2);
+  }
+
+  SECTION("Decimals round to zero") {
+    FloatDigits<double> digits(0.0004, 2);
+    REQUIRE(digits.length == 0);
+  }
+
+  SECTION("Decimals round the exact value") {
+    FloatDigits<double> digits(1.0049999999999999, 2);
+    REQUIRE(digitsOf(digits) == "1");
+    REQUIRE(digits.exponent == 0);
+  }
+
+  SECTION("Decimals of a tiny value") {
+    FloatDigits<double> digits(1.5e-200, 201);
+    REQUIRE(digitsOf(digits) == "15");
+    REQUIRE(digits.exponent == -200);
+  }
+}
+
+TEST_CASE("FloatDigits<float>") {
+  SECTION("3.4E+38") {
+    FloatDigits<float> digits(3.4E+38f);
+    REQUIRE(digitsOf(digits) == "34");
+    REQUIRE(digits.exponent == 38);
+  }
+
+  SECTION("1.17549435e-38") {
+    FloatDigits<float> digits(1.17549435e-38f);
+    REQUIRE(digitsOf(digits) == "11754944");
+    REQUIRE(digits.exponent == -38);
+  }
+
+  SECTION("1.4e-45") {
+    FloatDigits<float> digits(1.4e-45f);
+    REQUIRE(digitsOf(digits) == "1");
+    REQUIRE(digits.exponent == -45);
+  }
+
+  SECTION("24.3") {
+    FloatDigits<float> digits(24.3f);
+    REQUIRE(digitsOf(digits) == "243");
+    REQUIRE(digits.exponent == 1);
+  }
+
+  SECTION("Decimals round the exact value") {
+    FloatDigits<float> digits(21.0049992f, 2);
+    REQUIRE(digitsOf(digits) == "21");
+    REQUIRE(digits.exponent == 1);
+  }
+}
@@ -0,0 +1,142 @@
+// ArduinoJson - arduinojson.org
+// Copyright Benoit Blanchon 2014-2018
+// MIT License
+
+#include <ArduinoJson.h>
+#include <catch.hpp>
+#include <string>
+
+using namespace Catch::Matchers;
+
+struct Weather {
+  long dt;
+  float temp;
+  int humidity;
+  unsigned long sunrise;
+  double speed;
+  bool rain;
+  char name[8];
+  unsigned deg;
+};
+
+static const JsonField weatherFields[] = {
+    JSON_FIELD(Weather, dt, "dt"),
+    JSON_FIELD(Weather, temp, "main.temp"),
+    JSON_FIELD(Weather, humidity, "main.humidity"),
+    JSON_FIELD(Weather, sunrise, "sys.sunrise"),
+    JSON_FIELD(Weather, speed, "wind.speed"),
+    JSON_FIELD(Weather, rain, "rain"),
+    JSON_FIELD(Weather, name, "name"),
+    JSON_FIELD(Weather, deg, "list[2].wind.deg"),
+};
+
+static Weather read(const char* json, bool* success = NULL) {
+  Weather weather = {1, 2, 3, 4, 5, false, "none", 6};
+  StaticJsonBuffer<32> jsonBuffer;
+  JsonStructReader reader(&weather, weatherFields);
+  bool ok = jsonBuffer.parseEvents(json, reader);
+  if (success) *success = ok;
+  return weather;
+}
+
+TEST_CASE("JsonStructReader") {
+  SECTION("Flat values") {
+    bool ok;
+    Weather w = read("{\"dt\":1414846800,\"name\":\"Cairns\",\"rain\":true}", &ok);
+    REQUIRE(ok);
+    REQUIRE(1414846800 == w.dt);
+    REQUIRE_THAT(w.name, Equals("Cairns"));
+    REQUIRE(true == w.rain);
+  }
+
+  SECTION("Nested values") {
+    Weather w = read(
+        "{\"main\":{\"temp\":296.15,\"humidity\":83},"
+        "\"sys\":{\"sunrise\":1414784325},\"wind\":{\"speed\":2.22}}");
+    REQUIRE(296.15f == w.temp);
+    REQUIRE(83 == w.humidity);
+    REQUIRE(1414784325UL == w.sunrise);
+    REQUIRE(2.22 == w.speed);
+  }
+
+  SECTION("Array element") {
+    Weather w = read(
+        "{\"list\":[{\"wind\":{\"deg\":10}},{\"wind\":{\"deg\":20}},"
+        "{\"wind\":{\"deg\":30}},{\"wind\":{\"deg\":40}}]}");
+    REQUIRE(30 == w.deg);
+  }
+
+  SECTION("Missing values keep their default") {
+    Weather w = read("{\"main\":{\"temp\":20}}");
+    REQUIRE(20 == w.temp);
+    REQUIRE(1 == w.dt);
+    REQUIRE(3 == w.humidity);
+    REQUIRE_THAT(w.name, Equals("none"));
+  }
+
+  SECTION("Unknown values are skipped") {
+    Weather w = read(
+        "{\"coord\":{\"lon\":145.77,\"lat\":-16.92},\"temp\":1,"
+        "\"weather\":[{\"id\":801,\"main\":\"Clouds\"}],\"dt\":7}");
+    REQUIRE(7 == w.dt);
+    REQUIRE(2 == w.temp);
+  }
+
+  SECTION("Same key at another level") {
+    Weather w = read("{\"sys\":{\"dt\":8},\"dt\":9}");
+    REQUIRE(9 == w.dt);
+  }
+
+  SECTION("Long string is truncated") {
+    Weather w = read("{\"name\":\"Petropavlovsk\"}");
+    REQUIRE_THAT(w.name, Equals("Petropa"));
+  }
+
+  SECTION("Invalid input") {
+    bool ok;
+    read("{\"dt\":1,", &ok);
+    REQUIRE_FALSE(ok);
+  }
+
+  SECTION("Count") {
+    Weather weather;
+    StaticJsonBuffer<32> jsonBuffer;
+    JsonStructReader reader(&weather, weatherFields);
+    REQUIRE(jsonBuffer.parseEvents("{\"dt\":1,\"x\":2,\"main\":{\"temp\":3}}",
+                                   reader));
+    REQUIRE(2 == reader.count());
+  }
+}
+
+struct Deep {
+  int value;
+};
+
+static const JsonField deepFields[] = {
+    JSON_FIELD(Deep, value, "a.b.c.d"),
+};
+
+TEST_CASE("JsonStructReader limits") {
+  Deep deep = {0};
+  DynamicJsonBuffer jsonBuffer;
+  JsonStructReader reader(&deep, deepFields);
+
+  SECTION("Deepest level") {
+    REQUIRE(jsonBuffer.parseEvents("{\"a\":{\"b\":{\"c\":{\"d\":4}}}}", reader));
+    REQUIRE(4 == deep.value);
+  }
+
+  SECTION("Deeper values are skipped") {
+    REQUIRE(jsonBuffer.parseEvents("{\"a\":{\"b\":{\"c\":{\"d\":[5]}}}}",
+                                   reader));
+    REQUIRE(0 == deep.value);
+  }
+
+  SECTION("Path too long") {
+    std::string json = "{\"a\":{\"b\":{\"c\":{\"";
+    json += std::string(ARDUINOJSON_STRUCT_PATH_SIZE, 'x');
+    json += "\":1,\"d\":6}}}}";
+    REQUIRE(jsonBuffer.parseEvents(json, reader));
+    REQUIRE(6 == deep.value);
+  }
+}
@@ -0,0 +1,136 @@
+// ArduinoJson - arduinojson.org
+// Copyright Benoit Blanchon 2014-2018
+// MIT License
+
+#include <ArduinoJson.h>
+#include <catch.hpp>
+
+using namespace ArduinoJson::Internals;
+
+// A stream that delivers at most chunkSize bytes per read
+class ChunkedStream {
+ public:
+  ChunkedStream(const char* input, size_t chunkSize)
+      : _input(input), _chunkSize(chunkSize), _reads(0) {}
+
+  size_t read(char* buffer, size_t maxSize) {
+    _reads++;
+    size_t size = strlen(_input);
+    if (size > maxSize) size = maxSize;
+    if (size > _chunkSize) size = _chunkSize;
+    memcpy(buffer, _input, size);
+    _input += size;
+    return size;
+  }
+
+  size_t reads() const {
+    return _reads;
+  }
+
+ private:
+  const char* _input;
+  size_t _chunkSize;
+  size_t _reads;
+};
+
+class ChunkedSource {
+  ChunkedStream* _stream;
+
+ public:
+  ChunkedSource(ChunkedStream& stream) : _stream(&stream) {}
+
+  size_t readBlock(char* buffer, size_t maxSize) {
+    return _stream->read(buffer, maxSize);
+  }
+};
+
+namespace ArduinoJson {
+namespace Internals {
+template <>
+struct StringTraits<ChunkedStream, void> {
+  typedef BufferedStreamReader<ChunkedSource, 8> Reader;
+
+  static const bool has_append = false;
+  static const bool has_equals = false;
+};
+}
+}
+
+static std::string readAll(ChunkedStream& stream) {
+  BufferedStreamReader<ChunkedSource, 4> reader(stream);
+  std::string result;
+  while (reader.current()) {
+    result += reader.current();
+    reader.move();
+  }
+  return result;
+}
+
+TEST_CASE("BufferedStreamReader") {
+  SECTION("Empty") {
+    ChunkedStream stream("", 8);
+    BufferedStreamReader<ChunkedSource, 4> reader(stream);
+    REQUIRE('\0' == reader.current());
+    REQUIRE('\0' == reader.next());
+  }
+
+  SECTION("ReadsEverything") {
+    ChunkedStream stream("hello world", 3);
+    REQUIRE("hello world" == readAll(stream));
+  }
+
+  SECTION("NextAcrossBlocks") {
+    ChunkedStream stream("abcdef", 4);
+    BufferedStreamReader<ChunkedSource, 4> reader(stream);
+    reader.current();
+    reader.move();
+    reader.current();
+    reader.move();
+    reader.current();
+    REQUIRE('c' == reader.current());
+    REQUIRE('d' == reader.next());
+    reader.move();
+    REQUIRE('d' == reader.current());
+    REQUIRE('e' == reader.next());
+    reader.move();
+    reader.move();
+    REQUIRE('f' == reader.current());
+    REQUIRE('\0' == reader.next());
+    reader.move();
+    REQUIRE('\0' == reader.current());
+  }
+
+  SECTION("ReadsByBlocks") {
+    ChunkedStream stream("0123456789abcdef", 100);
+    readAll(stream);
+    REQUIRE(5 == stream.reads());  // 4 blocks + end of stream
+  }
+
+  SECTION("StopsReadingAtTheEnd") {
+    ChunkedStream stream("", 8);
+    BufferedStreamReader<ChunkedSource, 4> reader(stream);
+    reader.current();
+    reader.current();
+    reader.next();
+    REQUIRE(1 == stream.reads());
+  }
+}
+
+TEST_CASE("Parse from a buffered stream") {
+  DynamicJsonBuffer jb;
+
+  SECTION("Object") {
+    ChunkedStream stream(
+        "{\"key\":\"a \\\"quoted\\\" value\",/* comment */\"list\":[1,2,3]}", 5);
+    JsonObject& obj = jb.parseObject(stream);
+    REQUIRE(obj.success());
+    REQUIRE(std::string("a \"quoted\" value") == obj["key"].as<char*>());
+    REQUIRE(3 == obj["list"][2]);
+  }
+
+  SECTION("Truncated") {
+    ChunkedStream stream("{\"key\":\"val", 3);
+    JsonObject& obj = jb.parseObject(stream);
+    REQUIRE_FALSE(obj.success());
+  }
+}
@@ -0,0 +1,33 @@
+// ArduinoJson - arduinojson.org
+// Copyright Benoit Blanchon 2014-2018
+// MIT License
+
+#include <ArduinoJson.h>
+#include <catch.hpp>
+#include <string>
+
+TEST_CASE("formatFloat()") {
+  char buffer[16];
+
+  SECTION("Shortest digits") {
+    REQUIRE(formatFloat(21.37f, buffer, sizeof(buffer)) == 5);
+    REQUIRE(std::string(buffer) == "21.37");
+  }
+
+  SECTION("Decimals") {
+    REQUIRE(formatFloat(754.25f, buffer, sizeof(buffer), 1) == 5);
+    REQUIRE(std::string(buffer) == "754.3");
+  }
+
+  SECTION("Decimals are rounded once") {
+    REQUIRE(formatFloat(1.0049999999999999, buffer, sizeof(buffer), 2) == 4);
+    REQUIRE(std::string(buffer) == "1.00");
+    REQUIRE(formatFloat(21.0049992f, buffer, sizeof(buffer), 2) == 5);
+    REQUIRE(std::string(buffer) == "21.00");
+  }
+
+  SECTION("Truncates") {
+    REQUIRE(formatFloat(3.14159265359, buffer, 5) == 4);
+    REQUIRE(std::string(buffer) == "3.14");
+  }
+}
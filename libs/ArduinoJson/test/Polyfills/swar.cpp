@@ -0,0 +1,92 @@
+// ArduinoJson - arduinojson.org
+// Copyright Benoit Blanchon 2014-2018
+// MIT License
+
+#include <ArduinoJson/Polyfills/swar.hpp>
+#include <catch.hpp>
+#include <stdlib.h>
+#include <string.h>
+#include <string>
+
+using namespace ArduinoJson::Internals;
+
+static size_t copyFrom(const char* input, size_t shift, char* output) {
+  char buffer[128];
+  memset(buffer, 'x', sizeof(buffer));
+  strcpy(buffer + shift, input);
+  const char* end = NULL;
+  size_t count = swarCopyPlainChars(output, buffer + shift, end, '"', '\\');
+  output[count] = 0;
+  return count;
+}
+
+TEST_CASE("swarZeroBytes()") {
+  REQUIRE(swarZeroBytes(swarRepeat('a')) == 0);
+  REQUIRE(swarZeroBytes(0) == swarRepeat(0x80));
+  REQUIRE(swarZeroBytes(swarRepeat(0x80)) == 0);
+  REQUIRE(swarZeroBytes(swarRepeat(0xFF)) == 0);
+  REQUIRE(swarZeroBytes(swarRepeat(0x01)) == 0);
+}
+
+TEST_CASE("swarCopyPlainChars()") {
+  char output[128];
+
+  // every alignment, and stops before, inside and after the first words.
+  // The loops are in the sections, Catch runs a section once per test case.
+  SECTION("Stops at the terminator") {
+    for (size_t shift = 0; shift < 2 * sizeof(swar_word); shift++) {
+      REQUIRE(copyFrom("", shift, output) == 0);
+      REQUIRE(copyFrom("hello", shift, output) == 5);
+      REQUIRE(copyFrom("0123456789abcdefghijklmnopqrstuvwxyz", shift,
+                       output) == 36);
+      REQUIRE(std::string(output) == "0123456789abcdefghijklmnopqrstuvwxyz");
+    }
+  }
+
+  SECTION("Stops at the stop chars") {
+    for (size_t shift = 0; shift < 2 * sizeof(swar_word); shift++) {
+      for (size_t length = 0; length < 40; length++) {
+        std::string input(length, 'a');
+        REQUIRE(copyFrom((input + "\"bbbbbbbbbbbbbbbbbbbbbbbb").c_str(), shift,
+                         output) == length);
+        REQUIRE(copyFrom((input + "\\bbbbbbbbbbbbbbbbbbbbbbbb").c_str(), shift,
+                         output) == length);
+        REQUIRE(std::string(output) == input);
+      }
+    }
+  }
+
+  SECTION("Copies the chars with the high bit") {
+    for (size_t shift = 0; shift < 2 * sizeof(swar_word); shift++) {
+      REQUIRE(copyFrom("\xC3\xA9\xC3\xA9\xC3\xA9\xC3\xA9\xC3\xA9\xC3\xA9\xC3"
+                       "\xA9\xC3\xA9\xC3\xA9\"",
+                       shift, output) == 18);
+    }
+  }
+
+  SECTION("Copies in place") {
+    char buffer[] = "0123456789abcdefghijklmnopqrstuvwxyz\"";
+    const char* end = NULL;
+    REQUIRE(swarCopyPlainChars(buffer, buffer + 1, end, '"', '\\') == 35);
+    REQUIRE(std::string(buffer) == "123456789abcdefghijklmnopqrstuvwxyzz\"");
+  }
+
+  SECTION("Finds the terminator once") {
+    const char* input = "0123456789abcdefghijklmnopqrstuvwxyz\"abc";
+    const char* end = NULL;
+    REQUIRE(swarCopyPlainChars(output, input, end, '"', '\\') == 36);
+    REQUIRE(end == input + 40);
+  }
+
+  SECTION("Doesn't read after the terminator") {
+    // the block has the exact size, AddressSanitizer checks the reads
+    for (size_t length = 0; length < 48; length++) {
+      char* input = static_cast<char*>(malloc(length + 1));
+      memset(input, 'a', length);
+      input[length] = 0;
+      const char* end = NULL;
+      REQUIRE(swarCopyPlainChars(output, input, end, '"', '\\') == length);
+      free(input);
+    }
+  }
+}
@@ -0,0 +1,58 @@
+// ArduinoJson - arduinojson.org
+// Copyright Benoit Blanchon 2014-2018
+// MIT License
+
+#include <ArduinoJson.h>
+#include <catch.hpp>
+
+// The input is const, so the parser copies the strings in the buffer
+template <size_t CAPACITY>
+static bool canParseObject(const char* json) {
+  StaticJsonBuffer<CAPACITY> jsonBuffer;
+  return jsonBuffer.parseObject(json).success();
+}
+
+template <size_t CAPACITY>
+static bool canParseArray(const char* json) {
+  StaticJsonBuffer<CAPACITY> jsonBuffer;
+  return jsonBuffer.parseArray(json).success();
+}
+
+TEST_CASE("StaticJsonBuffer capacity") {
+  SECTION("Integer needs no string") {
+    const char* json = "{\"dt\":1414846800}";
+    REQUIRE(canParseObject<JSON_OBJECT_SIZE(1) + JSON_STRING_SIZE(2)>(json));
+    REQUIRE_FALSE(
+        canParseObject<JSON_OBJECT_SIZE(1) + JSON_STRING_SIZE(2) - 1>(json));
+  }
+
+  SECTION("Negative integer needs no string") {
+    const char* json = "[-16,0,-2147483648]";
+    REQUIRE(canParseArray<JSON_ARRAY_SIZE(3)>(json));
+  }
+
+  SECTION("Booleans need no string") {
+    const char* json = "[true,false]";
+    REQUIRE(canParseArray<JSON_ARRAY_SIZE(2)>(json));
+  }
+
+  SECTION("Float keeps its text") {
+    const char* json = "[296.15]";
+    REQUIRE(canParseArray<JSON_ARRAY_SIZE(1) + JSON_STRING_SIZE(6)>(json));
+    REQUIRE_FALSE(
+        canParseArray<JSON_ARRAY_SIZE(1) + JSON_STRING_SIZE(6) - 1>(json));
+  }
+
+  SECTION("Null keeps its text") {
+    const char* json = "[null]";
+    REQUIRE(canParseArray<JSON_ARRAY_SIZE(1) + JSON_STRING_SIZE(4)>(json));
+  }
+
+  SECTION("String") {
+    const char* json = "{\"icon\":\"02n\"}";
+    REQUIRE(canParseObject<JSON_OBJECT_SIZE(1) + JSON_STRING_SIZE(4) +
+                           JSON_STRING_SIZE(3)>(json));
+    REQUIRE_FALSE(canParseObject<JSON_OBJECT_SIZE(1) + JSON_STRING_SIZE(4) +
+                                 JSON_STRING_SIZE(3) - 1>(json));
+  }
+}
@@ -29,6 +29,7 @@ courtesy of Brian McNoldy at http://andrew.rsmas.miami.edu.
  */
 
 #include <Wire.h>
+#include <string.h>
 
 #include "BME280.h"
 
@@ -38,7 +39,14 @@ BME280::BME280
 (
    const Settings& settings
 ):m_settings(settings),
-  m_initialized(false)
+  m_initialized(false),
+  m_measurementStart(0),
+  m_ctrlHum(0),
+  m_ctrlMeas(0),
+  m_config(0),
+  m_registersValid(false),
+  m_lastDataTime(0),
+  m_hasLastData(false)
 {
 }
 
@@ -53,7 +61,9 @@ bool BME280::Initialize()
    if(success)
    {
       success &= ReadTrim();
-      WriteSettings();
+      m_registersValid = false;
+      m_hasLastData = false;
+      success &= WriteSettings();
    }
 
    m_initialized = success;
@@ -90,11 +100,27 @@ bool BME280::WriteSettings()
 {
    uint8_t ctrlHum, ctrlMeas, config;
 
+   bool success(true);
+
    CalculateRegisters(ctrlHum, ctrlMeas, config);
 
-   WriteRegister(CTRL_HUM_ADDR, ctrlHum);
-   WriteRegister(CTRL_MEAS_ADDR, ctrlMeas);
-   WriteRegister(CONFIG_ADDR, config);
+   // ctrl_hum only takes effect after a ctrl_meas write, which is always done.
+   // In forced mode that write is what triggers the conversion.
+   if (!m_registersValid || ctrlHum != m_ctrlHum)
+   {
+      success &= WriteRegister(CTRL_HUM_ADDR, ctrlHum);
+   }
+   success &= WriteRegister(CTRL_MEAS_ADDR, ctrlMeas);
+   if (!m_registersValid || config != m_config)
+   {
+      success &= WriteRegister(CONFIG_ADDR, config);
+   }
+
+   m_ctrlHum = ctrlHum;
+   m_ctrlMeas = ctrlMeas;
+   m_config = config;
+   m_registersValid = success;
+   return success;
 }
 
 
@@ -105,6 +131,7 @@ void BME280::setSettings
 )
 {
    m_settings = settings;
+   m_hasLastData = false;
    WriteSettings();
 }
 
@@ -148,17 +175,13 @@ bool BME280::ReadTrim()
 {
    uint8_t ord(0);
    bool success = true;
+   uint8_t buffer[TEMP_PRESS_HUM1_DIG_LENGTH];
 
-   // Temp. Dig
-   success &= ReadRegister(TEMP_DIG_ADDR, &m_dig[ord], TEMP_DIG_LENGTH);
-   ord += TEMP_DIG_LENGTH;
-
-   // Pressure Dig
-   success &= ReadRegister(PRESS_DIG_ADDR, &m_dig[ord], PRESS_DIG_LENGTH);
-   ord += PRESS_DIG_LENGTH;
-
-   // Humidity Dig 1
-   success &= ReadRegister(HUM_DIG_ADDR1, &m_dig[ord], HUM_DIG_ADDR1_LENGTH);
+   // Temp. Dig, Pressure Dig and Humidity Dig 1 are one block with a gap at 0xA0.
+   success &= ReadRegister(TEMP_DIG_ADDR, buffer, TEMP_PRESS_HUM1_DIG_LENGTH);
+   memcpy(&m_dig[ord], buffer, TEMP_DIG_LENGTH + PRESS_DIG_LENGTH);
+   ord += TEMP_DIG_LENGTH + PRESS_DIG_LENGTH;
+   m_dig[ord] = buffer[HUM_DIG_ADDR1 - TEMP_DIG_ADDR];
    ord += HUM_DIG_ADDR1_LENGTH;
 
    // Humidity Dig 2
@@ -185,22 +208,35 @@ bool BME280::ReadData
    int32_t data[SENSOR_DATA_LENGTH]
 )
 {
-   bool success;
-   uint8_t buffer[SENSOR_DATA_LENGTH];
-
    // For forced mode we need to write the mode to BME280 register before reading
    if (m_settings.mode == Mode_Forced)
    {
       WriteSettings();
    }
 
+   return ReadRawData(data);
+}
+
+
+/****************************************************************/
+bool BME280::ReadRawData
+(
+   int32_t data[SENSOR_DATA_LENGTH]
+)
+{
+   bool success;
+   uint8_t buffer[SENSOR_DATA_LENGTH];
+
    // Registers are in order. So we can start at the pressure register and read 8 bytes.
    success = ReadRegister(PRESS_ADDR, buffer, SENSOR_DATA_LENGTH);
 
    for(int i = 0; i < SENSOR_DATA_LENGTH; ++i)
    {
       data[i] = static_cast<int32_t>(buffer[i]);
+      m_lastData[i] = data[i];
    }
+   m_lastDataTime = micros();
+   m_hasLastData = success;
 
 #ifdef DEBUG_ON
    Serial.print("Data: ");
@@ -217,28 +253,102 @@ bool BME280::ReadData
 
 
 /****************************************************************/
-float BME280::CalculateTemperature
+bool BME280::ReadCachedData
+(
+   int32_t data[SENSOR_DATA_LENGTH]
+)
+{
+   if (!m_hasLastData || micros() - m_lastDataTime >= SampleValidTime())
+   {
+      return ReadData(data);
+   }
+
+   for(int i = 0; i < SENSOR_DATA_LENGTH; ++i)
+   {
+      data[i] = m_lastData[i];
+   }
+   return true;
+}
+
+
+/****************************************************************/
+uint32_t BME280::SampleValidTime
+(
+) const
+{
+   // Standby times from the data sheet, in microseconds, indexed by StandbyTime.
+   static const uint32_t StandbyTimes[] = { 500, 62500, 125000, 250000, 50000, 1000000, 10000, 20000 };
+
+   uint32_t time = measurementTime();
+   if (m_settings.mode == Mode_Normal)
+   {
+      time += StandbyTimes[m_settings.standbyTime & 0x07];
+   }
+   return time;
+}
+
+
+/****************************************************************/
+void BME280::ConvertData
+(
+   const int32_t data[SENSOR_DATA_LENGTH],
+   float& pressure,
+   float& temp,
+   float& humidity,
+   TempUnit tempUnit,
+   PresUnit presUnit
+)
+{
+   int32_t t_fine;
+   uint32_t rawPressure = (data[0] << 12) | (data[1] << 4) | (data[2] >> 4);
+   uint32_t rawTemp = (data[3] << 12) | (data[4] << 4) | (data[5] >> 4);
+   uint32_t rawHumidity = (data[6] << 8) | data[7];
+   temp = CalculateTemperature(rawTemp, t_fine, tempUnit);
+   pressure = CalculatePressure(rawPressure, t_fine, presUnit);
+   humidity = CalculateHumidity(rawHumidity, t_fine);
+}
+
+
+/****************************************************************/
+void BME280::ConvertDataFixed
+(
+   const int32_t data[SENSOR_DATA_LENGTH],
+   uint32_t& pressure,
+   int32_t& temp,
+   uint32_t& humidity
+)
+{
+   int32_t t_fine;
+   uint32_t rawPressure = (data[0] << 12) | (data[1] << 4) | (data[2] >> 4);
+   uint32_t rawTemp = (data[3] << 12) | (data[4] << 4) | (data[5] >> 4);
+   uint32_t rawHumidity = (data[6] << 8) | data[7];
+   temp = CompensateTemperature(rawTemp, t_fine);
+   pressure = CompensatePressure(rawPressure, t_fine);
+   humidity = CompensateHumidity(rawHumidity, t_fine);
+}
+
+
+/****************************************************************/
+int32_t BME280::CompensateTemperature
 (
    int32_t raw,
-   int32_t& t_fine,
-   TempUnit unit
+   int32_t& t_fine
 )
 {
    // Code based on calibration algorthim provided by Bosch.
-   int32_t var1, var2, final;
+   int32_t var1, var2;
    uint16_t dig_T1 = (m_dig[1] << 8) | m_dig[0];
    int16_t   dig_T2 = (m_dig[3] << 8) | m_dig[2];
    int16_t   dig_T3 = (m_dig[5] << 8) | m_dig[4];
    var1 = ((((raw >> 3) - ((int32_t)dig_T1 << 1))) * ((int32_t)dig_T2)) >> 11;
    var2 = (((((raw >> 4) - ((int32_t)dig_T1)) * ((raw >> 4) - ((int32_t)dig_T1))) >> 12) * ((int32_t)dig_T3)) >> 14;
    t_fine = var1 + var2;
-   final = (t_fine * 5 + 128) >> 8;
-   return unit == TempUnit_Celsius ? final/100.0 : final/100.0*9.0/5.0 + 32.0;
+   return (t_fine * 5 + 128) >> 8;
 }
 
 
 /****************************************************************/
-float BME280::CalculateHumidity
+uint32_t BME280::CompensateHumidity
 (
    int32_t raw,
    int32_t t_fine
@@ -261,21 +371,19 @@ float BME280::CalculateHumidity
    var1 = (var1 - (((((var1 >> 15) * (var1 >> 15)) >> 7) * ((int32_t)dig_H1)) >> 4));
    var1 = (var1 < 0 ? 0 : var1);
    var1 = (var1 > 419430400 ? 419430400 : var1);
-   return ((uint32_t)(var1 >> 12))/1024.0;
+   return (uint32_t)(var1 >> 12);
 }
 
 
 /****************************************************************/
-float BME280::CalculatePressure
+uint32_t BME280::CompensatePressure
 (
    int32_t raw,
-   int32_t t_fine,
-   PresUnit unit
+   int32_t t_fine
 )
 {
    // Code based on calibration algorthim provided by Bosch.
    int64_t var1, var2, pressure;
-   float final;
 
    uint16_t dig_P1 = (m_dig[7]   << 8) | m_dig[6];
    int16_t   dig_P2 = (m_dig[9]   << 8) | m_dig[8];
@@ -293,14 +401,52 @@ float BME280::CalculatePressure
    var2 = var2 + (((int64_t)dig_P4) << 35);
    var1 = ((var1 * var1 * (int64_t)dig_P3) >> 8) + ((var1 * (int64_t)dig_P2) << 12);
    var1 = (((((int64_t)1) << 47) + var1)) * ((int64_t)dig_P1) >> 33;
-   if (var1 == 0) { return NAN; }                                                         // Don't divide by zero.
+   if (var1 == 0) { return 0; }                                                           // Don't divide by zero.
    pressure   = 1048576 - raw;
    pressure = (((pressure << 31) - var2) * 3125)/var1;
    var1 = (((int64_t)dig_P9) * (pressure >> 13) * (pressure >> 13)) >> 25;
    var2 = (((int64_t)dig_P8) * pressure) >> 19;
    pressure = ((pressure + var1 + var2) >> 8) + (((int64_t)dig_P7) << 4);
+   return (uint32_t)pressure;
+}
 
-   final = ((uint32_t)pressure)/256.0;
+
+/****************************************************************/
+float BME280::CalculateTemperature
+(
+   int32_t raw,
+   int32_t& t_fine,
+   TempUnit unit
+)
+{
+   int32_t final = CompensateTemperature(raw, t_fine);
+   return unit == TempUnit_Celsius ? final/100.0 : final/100.0*9.0/5.0 + 32.0;
+}
+
+
+/****************************************************************/
+float BME280::CalculateHumidity
+(
+   int32_t raw,
+   int32_t t_fine
+)
+{
+   return CompensateHumidity(raw, t_fine)/1024.0;
+}
+
+
+/****************************************************************/
+float BME280::CalculatePressure
+(
+   int32_t raw,
+   int32_t t_fine,
+   PresUnit unit
+)
+{
+   uint32_t pressure = CompensatePressure(raw, t_fine);
+   if (pressure == 0) { return NAN; }
+
+   float final = pressure/256.0;
 
    // Conversion units courtesy of www.endmemo.com.
    switch(unit){
@@ -337,7 +483,7 @@ float BME280::temp
 {
    int32_t data[8];
    int32_t t_fine;
-   if(!ReadData(data)){ return NAN; }
+   if(!ReadCachedData(data)){ return NAN; }
    uint32_t rawTemp   = (data[3] << 12) | (data[4] << 4) | (data[5] >> 4);
    return CalculateTemperature(rawTemp, t_fine, unit);
 }
@@ -351,7 +497,7 @@ float BME280::pres
 {
    int32_t data[8];
    int32_t t_fine;
-   if(!ReadData(data)){ return NAN; }
+   if(!ReadCachedData(data)){ return NAN; }
    uint32_t rawTemp       = (data[3] << 12) | (data[4] << 4) | (data[5] >> 4);
    uint32_t rawPressure = (data[0] << 12) | (data[1] << 4) | (data[2] >> 4);
    CalculateTemperature(rawTemp, t_fine);
@@ -364,7 +510,7 @@ float BME280::hum()
 {
    int32_t data[8];
    int32_t t_fine;
-   if(!ReadData(data)){ return NAN; }
+   if(!ReadCachedData(data)){ return NAN; }
    uint32_t rawTemp = (data[3] << 12) | (data[4] << 4) | (data[5] >> 4);
    uint32_t rawHumidity = (data[6] << 8) | data[7];
    CalculateTemperature(rawTemp, t_fine);
@@ -383,17 +529,116 @@ void BME280::read
 )
 {
    int32_t data[8];
-   int32_t t_fine;
    if(!ReadData(data)){
       pressure = temp = humidity = NAN;
       return;
    }
-   uint32_t rawPressure = (data[0] << 12) | (data[1] << 4) | (data[2] >> 4);
-   uint32_t rawTemp = (data[3] << 12) | (data[4] << 4) | (data[5] >> 4);
-   uint32_t rawHumidity = (data[6] << 8) | data[7];
-   temp = CalculateTemperature(rawTemp, t_fine, tempUnit);
-   pressure = CalculatePressure(rawPressure, t_fine, presUnit);
-   humidity = CalculateHumidity(rawHumidity, t_fine);
+   ConvertData(data, pressure, temp, humidity, tempUnit, presUnit);
+}
+
+
+/****************************************************************/
+bool BME280::readFixed
+(
+   uint32_t& pressure,
+   int32_t& temp,
+   uint32_t& humidity
+)
+{
+   int32_t data[8];
+   if(!ReadData(data)){
+      return false;
+   }
+   ConvertDataFixed(data, pressure, temp, humidity);
+   return true;
+}
+
+
+/****************************************************************/
+bool BME280::startMeasurement
+(
+)
+{
+   m_measurementStart = micros();
+   if (m_settings.mode != Mode_Forced)
+   {
+      return true;
+   }
+
+   // Writing ctrl_meas with the forced mode bits starts a single conversion.
+   return WriteSettings();
+}
+
+
+/****************************************************************/
+bool BME280::isReady
+(
+)
+{
+   if (m_settings.mode != Mode_Forced)
+   {
+      return true;
+   }
+   if (micros() - m_measurementStart < measurementTime())
+   {
+      return false;
+   }
+
+   uint8_t status;
+   return ReadRegister(STATUS_ADDR, &status, 1) && (status & STATUS_MEASURING) == 0;
+}
+
+
+/****************************************************************/
+uint32_t BME280::measurementTime
+(
+) const
+{
+   // Maximum measurement time from the data sheet, appendix B, in microseconds.
+   uint32_t tempCount = m_settings.tempOSR ? 1 << (m_settings.tempOSR - 1) : 0;
+   uint32_t presCount = m_settings.presOSR ? 1 << (m_settings.presOSR - 1) : 0;
+   uint32_t humCount = m_settings.humOSR ? 1 << (m_settings.humOSR - 1) : 0;
+   uint32_t time = 1250 + 2300 * tempCount;
+   if (presCount) { time += 2300 * presCount + 575; }
+   if (humCount) { time += 2300 * humCount + 575; }
+   return time;
+}
+
+
+/****************************************************************/
+bool BME280::collect
+(
+   float& pressure,
+   float& temp,
+   float& humidity,
+   TempUnit tempUnit,
+   PresUnit presUnit
+)
+{
+   int32_t data[8];
+   if(!ReadRawData(data)){
+      pressure = temp = humidity = NAN;
+      return false;
+   }
+   ConvertData(data, pressure, temp, humidity, tempUnit, presUnit);
+   return true;
+}
+
+
+/****************************************************************/
+bool BME280::collectFixed
+(
+   uint32_t& pressure,
+   int32_t& temp,
+   uint32_t& humidity
+)
+{
+   int32_t data[8];
+   if(!ReadRawData(data)){
+      return false;
+   }
+   ConvertDataFixed(data, pressure, temp, humidity);
+   return true;
 }
 
 
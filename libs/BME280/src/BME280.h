@@ -176,6 +176,55 @@ struct Settings {
       TempUnit  tempUnit    = TempUnit_Celsius,
       PresUnit  presUnit    = PresUnit_Pa);
 
+   /////////////////////////////////////////////////////////////////
+   /// Read the data from the BME280 as fixed point integers without
+   /// any floating point math. Temperature is in 0.01 DegC, pressure
+   /// in Pa * 256 (Q24.8), humidity in %RH * 1024 (Q22.10).
+   /// Return true if successful.
+   bool   readFixed(
+      uint32_t& pressure,
+      int32_t&  temperature,
+      uint32_t& humidity);
+
+/*****************************************************************/
+/* ASYNCHRONOUS FUNCTIONS                                        */
+/*****************************************************************/
+
+   /////////////////////////////////////////////////////////////////
+   /// Start a conversion and return without waiting for it. In
+   /// forced mode this triggers a single measurement, in normal
+   /// mode the sensor converts on its own. Return true if successful.
+   bool   startMeasurement();
+
+   /////////////////////////////////////////////////////////////////
+   /// Return true when the conversion started by startMeasurement()
+   /// is done. The bus is not touched until the conversion time has
+   /// passed, then the status register is polled.
+   bool   isReady();
+
+   /////////////////////////////////////////////////////////////////
+   /// Return the maximum conversion time in microseconds for the
+   /// configured oversampling.
+   uint32_t measurementTime() const;
+
+   /////////////////////////////////////////////////////////////////
+   /// Read the result of the last conversion in the specified unit
+   /// without triggering a new one.
+   bool   collect(
+      float&    pressure,
+      float&    temperature,
+      float&    humidity,
+      TempUnit  tempUnit    = TempUnit_Celsius,
+      PresUnit  presUnit    = PresUnit_Pa);
+
+   /////////////////////////////////////////////////////////////////
+   /// Read the result of the last conversion as fixed point integers,
+   /// see readFixed().
+   bool   collectFixed(
+      uint32_t& pressure,
+      int32_t&  temperature,
+      uint32_t& humidity);
+
 
 /*****************************************************************/
 /* ACCESSOR FUNCTIONS                                            */
@@ -226,6 +275,7 @@ private:
 
    static const uint8_t CTRL_HUM_ADDR   = 0xF2;
    static const uint8_t CTRL_MEAS_ADDR  = 0xF4;
+   static const uint8_t STATUS_ADDR     = 0xF3;
    static const uint8_t CONFIG_ADDR     = 0xF5;
    static const uint8_t PRESS_ADDR      = 0xF7;
    static const uint8_t TEMP_ADDR       = 0xFA;
@@ -240,9 +290,12 @@ private:
    static const uint8_t PRESS_DIG_LENGTH        = 18;
    static const uint8_t HUM_DIG_ADDR1_LENGTH    = 1;
    static const uint8_t HUM_DIG_ADDR2_LENGTH    = 7;
+   static const uint8_t TEMP_PRESS_HUM1_DIG_LENGTH = 26;
    static const uint8_t DIG_LENGTH              = 32;
    static const uint8_t SENSOR_DATA_LENGTH      = 8;
 
+   static const uint8_t STATUS_MEASURING        = 0x08;
+
 /*****************************************************************/
 /* VARIABLES                                                     */
 /*****************************************************************/
@@ -255,6 +308,19 @@ private:
 
    bool m_initialized;
 
+   uint32_t m_measurementStart;
+
+   // Last values written to the control registers, valid once m_registersValid is set.
+   uint8_t m_ctrlHum;
+   uint8_t m_ctrlMeas;
+   uint8_t m_config;
+   bool m_registersValid;
+
+   // Last raw sample, reused by the single value getters while no newer one can exist.
+   int32_t m_lastData[8];
+   uint32_t m_lastDataTime;
+   bool m_hasLastData;
+
 /*****************************************************************/
 /* ABSTRACT FUNCTIONS                                            */
 /*****************************************************************/
@@ -306,6 +372,60 @@ private:
    bool ReadData(
       int32_t data[8]);
 
+   /////////////////////////////////////////////////////////////////
+   /// Read the raw data registers without triggering a conversion.
+   bool ReadRawData(
+      int32_t data[8]);
+
+   /////////////////////////////////////////////////////////////////
+   /// Return the last raw sample if the sensor cannot have a newer
+   /// one yet, otherwise read the data like ReadData.
+   bool ReadCachedData(
+      int32_t data[8]);
+
+   /////////////////////////////////////////////////////////////////
+   /// Time in microseconds before the sensor has a new sample.
+   uint32_t SampleValidTime() const;
+
+   /////////////////////////////////////////////////////////////////
+   /// Convert raw data into floats in the specified units.
+   void ConvertData(
+      const int32_t data[8],
+      float& pressure,
+      float& temperature,
+      float& humidity,
+      TempUnit tempUnit,
+      PresUnit presUnit);
+
+   /////////////////////////////////////////////////////////////////
+   /// Convert raw data into fixed point integers.
+   void ConvertDataFixed(
+      const int32_t data[8],
+      uint32_t& pressure,
+      int32_t& temperature,
+      uint32_t& humidity);
+
+   /////////////////////////////////////////////////////////////////
+   /// Bosch integer compensation of the temperature, return
+   /// 0.01 DegC and set t_fine for the other channels.
+   int32_t CompensateTemperature(
+      int32_t raw,
+      int32_t& t_fine);
+
+   /////////////////////////////////////////////////////////////////
+   /// Bosch 64 bit integer compensation of the pressure, return
+   /// Pa * 256 or 0 if the trim is not valid.
+   uint32_t CompensatePressure(
+      int32_t raw,
+      int32_t t_fine);
+
+   /////////////////////////////////////////////////////////////////
+   /// Bosch integer compensation of the humidity, return
+   /// %RH * 1024.
+   uint32_t CompensateHumidity(
+      int32_t raw,
+      int32_t t_fine);
+
    /////////////////////////////////////////////////////////////////
    /// Calculate the temperature from the BME280 raw data and
    /// BME280 trim, return a float.
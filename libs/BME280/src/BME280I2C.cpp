@@ -58,9 +58,8 @@ bool BME280I2C::WriteRegister
   Wire.beginTransmission(m_bme_280_addr);
   Wire.write(addr);
   Wire.write(data);
-  Wire.endTransmission();
 
-  return true; // TODO: Chech return values from wire calls.
+  return Wire.endTransmission() == 0;
 }
 
 
@@ -76,7 +75,11 @@ bool BME280I2C::ReadRegister
 
   Wire.beginTransmission(m_bme_280_addr);
   Wire.write(addr);
-  Wire.endTransmission();
+  // Repeated start, the read follows without releasing the bus.
+  if (Wire.endTransmission(false) != 0)
+  {
+    return false;
+  }
 
   Wire.requestFrom(m_bme_280_addr, length);
 
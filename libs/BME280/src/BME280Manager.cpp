@@ -0,0 +1,196 @@
+/*
+BME280Manager.cpp
+
+Sampling manager for several BME280 devices on one or more buses.
+This file is part of the Arduino BME280 library.
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+This header must be included in any derived code or copies of the code.
+ */
+
+#include "BME280Manager.h"
+
+
+/****************************************************************/
+BME280Manager::BME280Manager
+(
+   uint32_t periodMs,
+   BME280::TempUnit tempUnit,
+   BME280::PresUnit presUnit
+):m_periodMs(periodMs),
+  m_tempUnit(tempUnit),
+  m_presUnit(presUnit),
+  m_count(0)
+{
+}
+
+
+/****************************************************************/
+bool BME280Manager::add
+(
+   BME280& sensor
+)
+{
+   if (m_count == MAX_DEVICES)
+   {
+      return false;
+   }
+
+   Device& device = m_devices[m_count++];
+   device.sensor = &sensor;
+   device.state = State_Idle;
+   device.started = 0;
+   device.pressure = device.temperature = device.humidity = NAN;
+   device.isNew = false;
+   device.health = Health();
+
+   // Spread the start times of all devices over one period.
+   uint32_t now = millis();
+   for (uint8_t i = 0; i < m_count; ++i)
+   {
+      m_devices[i].nextStart = now + m_periodMs * i / m_count;
+   }
+   return true;
+}
+
+
+/****************************************************************/
+void BME280Manager::loop
+(
+)
+{
+   uint32_t now = millis();
+   for (uint8_t i = 0; i < m_count; ++i)
+   {
+      Step(m_devices[i], now);
+   }
+}
+
+
+/****************************************************************/
+void BME280Manager::Step
+(
+   Device& device,
+   uint32_t now
+)
+{
+   switch (device.state)
+   {
+      case State_Idle:
+         if ((int32_t)(now - device.nextStart) < 0)
+         {
+            return;
+         }
+         device.nextStart += m_periodMs;
+         if ((int32_t)(now - device.nextStart) >= 0)
+         {
+            // Fell behind by more than a period, do not try to catch up.
+            device.nextStart = now + m_periodMs;
+         }
+         device.started = micros();
+         if (!device.sensor->startMeasurement())
+         {
+            Fail(device);
+            return;
+         }
+         device.state = State_Converting;
+         return;
+
+      case State_Converting:
+      {
+         uint32_t elapsed = micros() - device.started;
+         if (!device.sensor->isReady())
+         {
+            // The status bit should clear well within twice the maximum time.
+            if (elapsed > 2 * device.sensor->measurementTime())
+            {
+               Fail(device);
+            }
+            return;
+         }
+
+         device.state = State_Idle;
+         if (!device.sensor->collect(device.pressure, device.temperature, device.humidity, m_tempUnit, m_presUnit))
+         {
+            Fail(device);
+            return;
+         }
+         device.isNew = true;
+         device.health.samples++;
+         device.health.lastLatency = elapsed;
+         if (elapsed > device.health.maxLatency)
+         {
+            device.health.maxLatency = elapsed;
+         }
+         device.health.lastSample = millis();
+         return;
+      }
+   }
+}
+
+
+/****************************************************************/
+void BME280Manager::Fail
+(
+   Device& device
+)
+{
+   device.state = State_Idle;
+   device.health.failures++;
+}
+
+
+/****************************************************************/
+bool BME280Manager::fetch
+(
+   uint8_t index,
+   float& pressure,
+   float& temperature,
+   float& humidity
+)
+{
+   if (index >= m_count)
+   {
+      return false;
+   }
+
+   Device& device = m_devices[index];
+   pressure = device.pressure;
+   temperature = device.temperature;
+   humidity = device.humidity;
+
+   bool isNew = device.isNew;
+   device.isNew = false;
+   return isNew;
+}
+
+
+/****************************************************************/
+uint8_t BME280Manager::count
+(
+) const
+{
+   return m_count;
+}
+
+
+/****************************************************************/
+const BME280Manager::Health& BME280Manager::health
+(
+   uint8_t index
+) const
+{
+   return m_devices[index].health;
+}
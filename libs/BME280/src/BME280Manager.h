@@ -0,0 +1,125 @@
+/*
+BME280Manager.h
+
+Sampling manager for several BME280 devices on one or more buses.
+This file is part of the Arduino BME280 library.
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+This header must be included in any derived code or copies of the code.
+ */
+
+#ifndef TG_BME_280_MANAGER_H
+#define TG_BME_280_MANAGER_H
+
+#include "BME280.h"
+
+//////////////////////////////////////////////////////////////////
+/// BME280Manager - Samples a set of BME280 devices without blocking.
+///
+/// Every device is converted once per period in forced mode. Start
+/// times are staggered over the period, so the bus is used for one
+/// device while the others convert. loop() never waits for a
+/// conversion and does at most one bus transfer per device.
+///
+class BME280Manager
+{
+public:
+
+   static const uint8_t MAX_DEVICES = 4;
+
+   struct Health
+   {
+      uint32_t samples;
+      uint32_t failures;
+      uint32_t lastLatency;   // Microseconds from start to collect.
+      uint32_t maxLatency;
+      uint32_t lastSample;    // millis() of the last good sample.
+   };
+
+   /////////////////////////////////////////////////////////////////
+   /// Constructor, periodMs is the sampling period of every device.
+   BME280Manager(
+      uint32_t periodMs,
+      BME280::TempUnit tempUnit = BME280::TempUnit_Celsius,
+      BME280::PresUnit presUnit = BME280::PresUnit_Pa);
+
+   /////////////////////////////////////////////////////////////////
+   /// Add a device that has been started with begin(). Return false
+   /// if there is no room left.
+   bool add(
+      BME280& device);
+
+   /////////////////////////////////////////////////////////////////
+   /// Advance the sampling of all devices, call from the main loop.
+   void loop();
+
+   /////////////////////////////////////////////////////////////////
+   /// Get the latest sample of a device. Return true if it is new
+   /// since the last call.
+   bool fetch(
+      uint8_t index,
+      float& pressure,
+      float& temperature,
+      float& humidity);
+
+   /////////////////////////////////////////////////////////////////
+   uint8_t count() const;
+
+   /////////////////////////////////////////////////////////////////
+   const Health& health(
+      uint8_t index) const;
+
+private:
+
+   enum State
+   {
+      State_Idle,
+      State_Converting
+   };
+
+   struct Device
+   {
+      BME280* sensor;
+      State state;
+      uint32_t nextStart;
+      uint32_t started;
+      float pressure;
+      float temperature;
+      float humidity;
+      bool isNew;
+      Health health;
+   };
+
+   /////////////////////////////////////////////////////////////////
+   /// Advance one device by at most one bus transfer.
+   void Step(
+      Device& device,
+      uint32_t now);
+
+   /////////////////////////////////////////////////////////////////
+   /// Record a failed start or collect and wait for the next period.
+   void Fail(
+      Device& device);
+
+   uint32_t m_periodMs;
+   BME280::TempUnit m_tempUnit;
+   BME280::PresUnit m_presUnit;
+
+   Device m_devices[MAX_DEVICES];
+   uint8_t m_count;
+
+};
+
+#endif // TG_BME_280_MANAGER_H
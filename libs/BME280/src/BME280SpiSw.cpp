@@ -39,10 +39,7 @@ BME280SpiSw::BME280SpiSw
    const Settings& settings
 )
 :BME280(settings),
- csPin(settings.spiCsPin),
- mosiPin(settings.spiMosiPin),
- misoPin(settings.spiMisoPin),
- sckPin(settings.spiSckPin)
+ m_spi(settings.spiCsPin, settings.spiMosiPin, settings.spiMisoPin, settings.spiSckPin)
 {
 }
 
@@ -50,35 +47,12 @@ BME280SpiSw::BME280SpiSw
 /****************************************************************/
 bool BME280SpiSw::Initialize(){
 
-   digitalWrite(csPin, HIGH);
-   pinMode(csPin, OUTPUT);
-
-   pinMode(sckPin, OUTPUT);
-   pinMode(mosiPin, OUTPUT);
-   pinMode(misoPin, INPUT);
+   m_spi.begin();
 
    return BME280::Initialize();
 }
 
 
-/****************************************************************/
-uint8_t BME280SpiSw::SpiTransferSw
-(
-   uint8_t data
-)
-{
-   uint8_t resp = 0;
-   for (int bit = 7; bit >= 0; --bit) {
-      resp <<= 1;
-      digitalWrite(sckPin, LOW);
-      digitalWrite(mosiPin, data & (1 << bit));
-      digitalWrite(sckPin, HIGH);
-      resp |= digitalRead(misoPin);
-   }
-   return resp;
-}
-
-
 /****************************************************************/
 bool BME280SpiSw::ReadRegister
 (
@@ -93,19 +67,15 @@ bool BME280SpiSw::ReadRegister
    uint8_t readAddr = addr |   BME280_SPI_READ;
 
    //select the device
-   digitalWrite(csPin, LOW);
+   m_spi.select();
    // transfer the addr
-   SpiTransferSw(readAddr);
+   m_spi.transfer(readAddr);
 
-   // read the data
-   for(int i = 0; i < length; ++i)
-   {
-      // transfer 0x00 to get the data
-      data[i] = SpiTransferSw(0);
-   }
+   // read the data, transferring 0x00 for every byte
+   m_spi.transfer(NULL, data, length);
 
    // de-select the device
-   digitalWrite(csPin, HIGH);
+   m_spi.deselect();
 
    return true;
 }
@@ -123,14 +93,14 @@ bool BME280SpiSw::WriteRegister
    uint8_t writeAddr = addr & ~0x80;
 
    // select the device
-   digitalWrite(csPin, LOW);
+   m_spi.select();
 
    // transfer the addr and then the data to spi device
-   SpiTransferSw(writeAddr);
-   SpiTransferSw(data);
+   m_spi.transfer(writeAddr);
+   m_spi.transfer(data);
 
    // de-select the device
-   digitalWrite(csPin, HIGH);
+   m_spi.deselect();
 
 return true;
 }
@@ -31,6 +31,7 @@ Based on the data sheet provided by Bosch for the Bme280 environmental sensor.
 #define TG_BME_280_SPI_H
 
 #include "BME280.h"
+#include "SoftSpi.h"
 
 class BME280SpiSw: public BME280{
 
@@ -77,16 +78,7 @@ private:
    static const uint8_t BME280_SPI_WRITE = 0x7F;
    static const uint8_t BME280_SPI_READ = 0x80;
 
-   // TODO: Move to settings object.
-   uint8_t csPin;
-   int8_t mosiPin;
-   int8_t misoPin;
-   int8_t sckPin;
-
-   ////////////////////////////////////////////////////////////////
-   /// Does a sw spi transfer.
-   uint8_t SpiTransferSw(
-      uint8_t data);
+   SoftSpi m_spi;
 
    ////////////////////////////////////////////////////////////////
    /// Read the data from the BME280 addr into an array and return
@@ -0,0 +1,190 @@
+/*
+SoftSpi.cpp
+
+Bit-banged SPI master with precomputed pin masks.
+This file is part of the Arduino BME280 library.
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+This header must be included in any derived code or copies of the code.
+ */
+
+#include "SoftSpi.h"
+
+#if defined(ESP8266)
+   // GPIO0-15 are reachable through the set/clear/input registers.
+   #define SOFT_SPI_REG_PIN(pin) ((pin) < 16)
+   #define SOFT_SPI_SET(mask)    GPOS = (mask)
+   #define SOFT_SPI_CLEAR(mask)  GPOC = (mask)
+   #define SOFT_SPI_READ(mask)   (GPI & (mask))
+#else
+   #define SOFT_SPI_REG_PIN(pin) false
+   #define SOFT_SPI_SET(mask)
+   #define SOFT_SPI_CLEAR(mask)
+   #define SOFT_SPI_READ(mask)   0
+#endif
+
+// Mode 0/3 compatible: clock low, data out, clock high, sample in.
+#define SOFT_SPI_BIT(bit)                                  \
+   SOFT_SPI_CLEAR(sck);                                    \
+   if (data & (1 << (bit))) { SOFT_SPI_SET(mosi); }        \
+   else { SOFT_SPI_CLEAR(mosi); }                          \
+   SOFT_SPI_SET(sck);                                      \
+   if (SOFT_SPI_READ(miso)) { resp |= (1 << (bit)); }
+
+
+/****************************************************************/
+SoftSpi::SoftSpi
+(
+   uint8_t cs,
+   uint8_t mosi,
+   uint8_t miso,
+   uint8_t sck
+):m_cs(cs),
+  m_mosi(mosi),
+  m_miso(miso),
+  m_sck(sck),
+  m_csMask(0),
+  m_mosiMask(0),
+  m_misoMask(0),
+  m_sckMask(0),
+  m_fast(false)
+{
+}
+
+
+/****************************************************************/
+void SoftSpi::begin()
+{
+   digitalWrite(m_cs, HIGH);
+   pinMode(m_cs, OUTPUT);
+   pinMode(m_sck, OUTPUT);
+   pinMode(m_mosi, OUTPUT);
+   if(m_miso != NO_PIN)
+   {
+      pinMode(m_miso, INPUT);
+   }
+
+   m_fast = SOFT_SPI_REG_PIN(m_cs) && SOFT_SPI_REG_PIN(m_mosi) &&
+      SOFT_SPI_REG_PIN(m_sck) &&
+      (m_miso == NO_PIN || SOFT_SPI_REG_PIN(m_miso));
+   if(m_fast)
+   {
+      m_csMask = 1UL << m_cs;
+      m_mosiMask = 1UL << m_mosi;
+      m_sckMask = 1UL << m_sck;
+      m_misoMask = m_miso == NO_PIN ? 0 : 1UL << m_miso;
+   }
+}
+
+
+/****************************************************************/
+void SoftSpi::select()
+{
+   if(m_fast)
+   {
+      SOFT_SPI_CLEAR(m_csMask);
+   }
+   else
+   {
+      digitalWrite(m_cs, LOW);
+   }
+}
+
+
+/****************************************************************/
+void SoftSpi::deselect()
+{
+   if(m_fast)
+   {
+      SOFT_SPI_SET(m_csMask);
+   }
+   else
+   {
+      digitalWrite(m_cs, HIGH);
+   }
+}
+
+
+/****************************************************************/
+uint8_t SoftSpi::transfer
+(
+   uint8_t data
+)
+{
+   if(!m_fast)
+   {
+      return TransferPins(data);
+   }
+
+   // Keep the masks in registers for the whole byte.
+   const uint32_t sck = m_sckMask;
+   const uint32_t mosi = m_mosiMask;
+   const uint32_t miso = m_misoMask;
+   uint8_t resp = 0;
+
+   SOFT_SPI_BIT(7)
+   SOFT_SPI_BIT(6)
+   SOFT_SPI_BIT(5)
+   SOFT_SPI_BIT(4)
+   SOFT_SPI_BIT(3)
+   SOFT_SPI_BIT(2)
+   SOFT_SPI_BIT(1)
+   SOFT_SPI_BIT(0)
+
+   (void)sck;
+   (void)mosi;
+   (void)miso;
+   return resp;
+}
+
+
+/****************************************************************/
+void SoftSpi::transfer
+(
+   const uint8_t* out,
+   uint8_t* in,
+   uint16_t length
+)
+{
+   for(uint16_t i = 0; i < length; ++i)
+   {
+      uint8_t resp = transfer(out ? out[i] : 0);
+      if(in)
+      {
+         in[i] = resp;
+      }
+   }
+}
+
+
+/****************************************************************/
+uint8_t SoftSpi::TransferPins
+(
+   uint8_t data
+)
+{
+   uint8_t resp = 0;
+   for (int bit = 7; bit >= 0; --bit) {
+      resp <<= 1;
+      digitalWrite(m_sck, LOW);
+      digitalWrite(m_mosi, data & (1 << bit));
+      digitalWrite(m_sck, HIGH);
+      if(m_miso != NO_PIN)
+      {
+         resp |= digitalRead(m_miso);
+      }
+   }
+   return resp;
+}
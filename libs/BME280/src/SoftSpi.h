@@ -0,0 +1,98 @@
+/*
+SoftSpi.h
+
+Bit-banged SPI master with precomputed pin masks.
+This file is part of the Arduino BME280 library.
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+This header must be included in any derived code or copies of the code.
+ */
+
+#ifndef TG_SOFT_SPI_H
+#define TG_SOFT_SPI_H
+
+#include "Arduino.h"
+
+//////////////////////////////////////////////////////////////////
+/// SoftSpi - Software SPI master, MSB first, sampling on the rising
+/// clock edge.
+///
+/// On the ESP8266 the pin masks are computed once in begin() and a
+/// transfer writes GPOS/GPOC and reads GPI directly, the same way
+/// UTFT drives its serial modes. Pins the registers cannot reach
+/// (GPIO16) and other architectures use digitalWrite/digitalRead.
+/// The class has no dependency on the sensor code, so any bit-banged
+/// SPI device can use it.
+///
+class SoftSpi
+{
+public:
+
+   /////////////////////////////////////////////////////////////////
+   /// Constructor, pass 0xFF as miso for a write-only bus.
+   SoftSpi(
+      uint8_t cs,
+      uint8_t mosi,
+      uint8_t miso,
+      uint8_t sck);
+
+   /////////////////////////////////////////////////////////////////
+   /// Set the pin modes and deselect the device.
+   void begin();
+
+   /////////////////////////////////////////////////////////////////
+   /// Pull chip select low.
+   void select();
+
+   /////////////////////////////////////////////////////////////////
+   /// Release chip select.
+   void deselect();
+
+   /////////////////////////////////////////////////////////////////
+   /// Shift one byte out and return the byte shifted in.
+   uint8_t transfer(
+      uint8_t data);
+
+   /////////////////////////////////////////////////////////////////
+   /// Shift length bytes out of out (0x00 if null) and store the
+   /// bytes shifted in to in (skipped if null).
+   void transfer(
+      const uint8_t* out,
+      uint8_t* in,
+      uint16_t length);
+
+   static const uint8_t NO_PIN = 0xFF;
+
+private:
+
+   uint8_t m_cs;
+   uint8_t m_mosi;
+   uint8_t m_miso;
+   uint8_t m_sck;
+
+   uint32_t m_csMask;
+   uint32_t m_mosiMask;
+   uint32_t m_misoMask;
+   uint32_t m_sckMask;
+   bool m_fast;
+
+   /////////////////////////////////////////////////////////////////
+   /// Per pin transfer used when the registers cannot be used.
+   uint8_t TransferPins(
+      uint8_t data);
+
+};
+
+#endif // TG_SOFT_SPI_H
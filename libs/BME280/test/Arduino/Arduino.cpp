@@ -0,0 +1,70 @@
+#include "Arduino.h"
+
+namespace fake
+{
+   uint32_t now = 0;
+   Gpio* gpio = NULL;
+}
+
+uint32_t micros()
+{
+   return fake::now;
+}
+
+uint32_t millis()
+{
+   return fake::now / 1000;
+}
+
+void delay(uint32_t ms)
+{
+   fake::now += ms * 1000;
+}
+
+void pinMode(uint8_t, uint8_t)
+{
+}
+
+void digitalWrite(uint8_t pin, uint8_t value)
+{
+   if(fake::gpio)
+   {
+      fake::gpio->OnWrite(pin, value != LOW);
+   }
+}
+
+int digitalRead(uint8_t pin)
+{
+   return fake::gpio && fake::gpio->OnRead(pin) ? HIGH : LOW;
+}
+
+#if defined(ESP8266)
+FakeGpioOutput GPOS(true);
+FakeGpioOutput GPOC(false);
+FakeGpioInput GPI;
+
+FakeGpioOutput& FakeGpioOutput::operator=(uint32_t mask)
+{
+   for(uint8_t pin = 0; pin < 16; ++pin)
+   {
+      if((mask & (1UL << pin)) && fake::gpio)
+      {
+         fake::gpio->OnWrite(pin, m_level);
+      }
+   }
+   return *this;
+}
+
+FakeGpioInput::operator uint32_t() const
+{
+   uint32_t levels = 0;
+   for(uint8_t pin = 0; pin < 16; ++pin)
+   {
+      if(fake::gpio && fake::gpio->OnRead(pin))
+      {
+         levels |= 1UL << pin;
+      }
+   }
+   return levels;
+}
+#endif
@@ -0,0 +1,57 @@
+// Host stand-in for the parts of the Arduino core the library uses.
+// Time only moves when a test moves it, pins go to a fake::Gpio.
+#ifndef FAKE_ARDUINO_H
+#define FAKE_ARDUINO_H
+
+#include <math.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#define HIGH   0x1
+#define LOW    0x0
+#define INPUT  0x0
+#define OUTPUT 0x1
+
+uint32_t micros();
+uint32_t millis();
+void delay(uint32_t ms);
+void pinMode(uint8_t pin, uint8_t mode);
+void digitalWrite(uint8_t pin, uint8_t value);
+int digitalRead(uint8_t pin);
+
+namespace fake
+{
+   //////////////////////////////////////////////////////////////////
+   /// Whatever is wired to the pins.
+   class Gpio
+   {
+   public:
+      virtual ~Gpio() {}
+      virtual void OnWrite(uint8_t pin, bool level) = 0;
+      virtual bool OnRead(uint8_t pin) = 0;
+   };
+
+   extern uint32_t now;
+   extern Gpio* gpio;
+}
+
+#if defined(ESP8266)
+// GPIO0-15 set, clear and input registers of the ESP8266.
+struct FakeGpioOutput
+{
+   explicit FakeGpioOutput(bool level): m_level(level) {}
+   FakeGpioOutput& operator=(uint32_t mask);
+   bool m_level;
+};
+
+struct FakeGpioInput
+{
+   operator uint32_t() const;
+};
+
+extern FakeGpioOutput GPOS;
+extern FakeGpioOutput GPOC;
+extern FakeGpioInput GPI;
+#endif
+
+#endif // FAKE_ARDUINO_H
@@ -0,0 +1,61 @@
+#include "Wire.h"
+
+namespace fake
+{
+   I2cDevice* i2c = NULL;
+}
+
+TwoWire Wire;
+
+TwoWire::TwoWire(): m_address(0), m_length(0), m_index(0)
+{
+}
+
+void TwoWire::begin(int, int)
+{
+}
+
+void TwoWire::beginTransmission(uint8_t address)
+{
+   m_address = address;
+   m_length = 0;
+   m_index = 0;
+}
+
+size_t TwoWire::write(uint8_t data)
+{
+   if(m_length == BUFFER_LENGTH)
+   {
+      return 0;
+   }
+   m_buffer[m_length++] = data;
+   return 1;
+}
+
+uint8_t TwoWire::endTransmission(bool)
+{
+   // 2 is the Arduino code for an address NACK.
+   return fake::i2c && fake::i2c->OnWrite(m_address, m_buffer, m_length) ? 0 : 2;
+}
+
+uint8_t TwoWire::requestFrom(uint8_t address, uint8_t quantity)
+{
+   m_index = 0;
+   m_length = 0;
+   if(quantity > BUFFER_LENGTH || !fake::i2c || !fake::i2c->OnRead(address, m_buffer, quantity))
+   {
+      return 0;
+   }
+   m_length = quantity;
+   return quantity;
+}
+
+int TwoWire::available()
+{
+   return static_cast<int>(m_length - m_index);
+}
+
+int TwoWire::read()
+{
+   return m_index < m_length ? m_buffer[m_index++] : -1;
+}
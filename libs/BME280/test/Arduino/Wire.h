@@ -0,0 +1,46 @@
+// Host stand-in for the Arduino Wire library, talks to a fake::I2cDevice.
+#ifndef FAKE_WIRE_H
+#define FAKE_WIRE_H
+
+#include "Arduino.h"
+
+namespace fake
+{
+   //////////////////////////////////////////////////////////////////
+   /// Target on the fake bus, gets whole transfers.
+   class I2cDevice
+   {
+   public:
+      virtual ~I2cDevice() {}
+      virtual bool OnWrite(uint8_t address, const uint8_t* data, size_t length) = 0;
+      virtual bool OnRead(uint8_t address, uint8_t* data, size_t length) = 0;
+   };
+
+   extern I2cDevice* i2c;
+}
+
+class TwoWire
+{
+public:
+   TwoWire();
+
+   void begin(int sda, int scl);
+   void beginTransmission(uint8_t address);
+   size_t write(uint8_t data);
+   uint8_t endTransmission(bool sendStop = true);
+   uint8_t requestFrom(uint8_t address, uint8_t quantity);
+   int available();
+   int read();
+
+private:
+   static const size_t BUFFER_LENGTH = 32;
+
+   uint8_t m_address;
+   uint8_t m_buffer[BUFFER_LENGTH];
+   size_t m_length;
+   size_t m_index;
+};
+
+extern TwoWire Wire;
+
+#endif // FAKE_WIRE_H
@@ -0,0 +1,150 @@
+#include "FakeBme280.h"
+
+#include <BME280I2C.h>
+
+#include <catch.hpp>
+
+#include <math.h>
+
+// startMeasurement(), isReady() and collect() split a forced read so the
+// caller can do other work during the conversion.
+namespace
+{
+   const uint8_t STATUS = 0xF3;
+   const uint8_t CTRL_MEAS = 0xF4;
+   const uint8_t STATUS_MEASURING = 0x08;
+}
+
+TEST_CASE("measurementTime() is the data sheet maximum")
+{
+   FakeBme280 device;
+
+   SECTION("one sample of each")
+   {
+      BME280I2C bme;
+      REQUIRE(bme.measurementTime() == 1250 + 2300 + 2 * (2300 + 575));
+   }
+
+   SECTION("16 samples of each")
+   {
+      BME280I2C bme(BME280I2C::Settings(BME280::OSR_X16, BME280::OSR_X16, BME280::OSR_X16));
+      REQUIRE(bme.measurementTime() == 1250 + 16 * 2300 + 2 * (16 * 2300 + 575));
+   }
+
+   SECTION("mixed oversampling")
+   {
+      // temperature, humidity, pressure
+      BME280I2C bme(BME280I2C::Settings(BME280::OSR_X2, BME280::OSR_X4, BME280::OSR_X8));
+      REQUIRE(bme.measurementTime() == 1250 + 2 * 2300 + (8 * 2300 + 575) + (4 * 2300 + 575));
+   }
+}
+
+TEST_CASE("startMeasurement() writes ctrl_meas once in forced mode")
+{
+   FakeBme280 device;
+   BME280I2C bme;
+   REQUIRE(bme.begin(4, 5));
+   device.ResetCounters();
+
+   REQUIRE(bme.startMeasurement());
+   REQUIRE(device.transactions == 1);
+   REQUIRE(device.registerWrites[CTRL_MEAS] == 1);
+   REQUIRE((device.registers[CTRL_MEAS] & 0x03) == BME280::Mode_Forced);
+}
+
+TEST_CASE("startMeasurement() fails with the ctrl_meas write")
+{
+   FakeBme280 device;
+   BME280I2C bme;
+   REQUIRE(bme.begin(4, 5));
+
+   device.failWrites = true;
+   REQUIRE_FALSE(bme.startMeasurement());
+}
+
+TEST_CASE("isReady() stays off the bus for the measurement time")
+{
+   FakeBme280 device;
+   BME280I2C bme;
+   REQUIRE(bme.begin(4, 5));
+   REQUIRE(bme.startMeasurement());
+   device.ResetCounters();
+
+   fake::now += bme.measurementTime() - 1;
+   REQUIRE_FALSE(bme.isReady());
+   REQUIRE(device.transactions == 0);
+}
+
+TEST_CASE("isReady() polls the status register after the measurement time")
+{
+   FakeBme280 device;
+   BME280I2C bme;
+   REQUIRE(bme.begin(4, 5));
+   REQUIRE(bme.startMeasurement());
+   fake::now += bme.measurementTime();
+   device.ResetCounters();
+
+   SECTION("conversion done")
+   {
+      REQUIRE(bme.isReady());
+      REQUIRE(device.transactions == 2);
+   }
+
+   SECTION("still measuring")
+   {
+      device.registers[STATUS] = STATUS_MEASURING;
+      REQUIRE_FALSE(bme.isReady());
+      REQUIRE(device.transactions == 2);
+
+      device.registers[STATUS] = 0;
+      REQUIRE(bme.isReady());
+      REQUIRE(device.transactions == 4);
+   }
+
+   SECTION("failed read")
+   {
+      device.failReads = true;
+      REQUIRE_FALSE(bme.isReady());
+   }
+}
+
+TEST_CASE("isReady() is always true outside forced mode")
+{
+   FakeBme280 device;
+   BME280I2C bme(BME280I2C::Settings(BME280::OSR_X1, BME280::OSR_X1, BME280::OSR_X1,
+      BME280::Mode_Normal));
+   REQUIRE(bme.begin(4, 5));
+   device.ResetCounters();
+
+   REQUIRE(bme.startMeasurement());
+   REQUIRE(bme.isReady());
+   REQUIRE(device.transactions == 0);
+}
+
+TEST_CASE("collect() reads the data block without starting a conversion")
+{
+   FakeBme280 device;
+   BME280I2C bme;
+   REQUIRE(bme.begin(4, 5));
+   REQUIRE(bme.startMeasurement());
+   fake::now += bme.measurementTime();
+   device.ResetCounters();
+
+   float pressure, temperature, humidity;
+
+   SECTION("success")
+   {
+      REQUIRE(bme.collect(pressure, temperature, humidity));
+      REQUIRE(device.transactions == 2);
+      REQUIRE(device.registerWrites[CTRL_MEAS] == 0);
+   }
+
+   SECTION("failed read")
+   {
+      device.failReads = true;
+      REQUIRE_FALSE(bme.collect(pressure, temperature, humidity));
+      REQUIRE(isnan(pressure));
+      REQUIRE(isnan(temperature));
+      REQUIRE(isnan(humidity));
+   }
+}
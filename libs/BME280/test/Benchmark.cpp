@@ -0,0 +1,93 @@
+// Cost of one read, conversion included, with a bus that costs nothing.
+// On the host the cycles are TSC cycles, on x86 only.
+#include <BME280.h>
+
+#include <chrono>
+#include <stdio.h>
+#include <string.h>
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#define BENCHMARK_CYCLES() __rdtsc()
+#else
+#define BENCHMARK_CYCLES() 0ULL
+#endif
+
+namespace
+{
+   // Registers of the data sheet example, the bus is a memcpy.
+   class MemoryBme280: public BME280
+   {
+   public:
+      MemoryBme280(): BME280(Settings())
+      {
+         static const uint8_t Trim[] = {
+            0x70, 0x6B, 0x43, 0x67, 0x18, 0xFC, 0x7D, 0x8E, 0x43, 0xD6, 0xD0, 0x0B,
+            0x27, 0x0B, 0x8C, 0x00, 0xF9, 0xFF, 0x8C, 0x3C, 0xF8, 0xC6, 0x70, 0x17
+         };
+         static const uint8_t Humidity[] = { 0x6A, 0x01, 0x00, 0x13, 0x29, 0x03, 0x1E };
+         static const uint8_t Data[] = { 0x65, 0x5A, 0xC0, 0x7E, 0xED, 0x00, 0x69, 0x78 };
+         memset(m_registers, 0, sizeof(m_registers));
+         m_registers[0xD0] = 0x60;
+         memcpy(&m_registers[0x88], Trim, sizeof(Trim));
+         m_registers[0xA1] = 0x4B;
+         memcpy(&m_registers[0xE1], Humidity, sizeof(Humidity));
+         memcpy(&m_registers[0xF7], Data, sizeof(Data));
+      }
+
+   private:
+      virtual bool WriteRegister(uint8_t addr, uint8_t data)
+      {
+         m_registers[addr] = data;
+         return true;
+      }
+
+      virtual bool ReadRegister(uint8_t addr, uint8_t data[], uint8_t length)
+      {
+         memcpy(data, &m_registers[addr], length);
+         return true;
+      }
+
+      uint8_t m_registers[256];
+   };
+
+   template <typename Read>
+   void Measure(const char* name, Read read)
+   {
+      const int Count = 1000000;
+      std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+      unsigned long long cycles = BENCHMARK_CYCLES();
+      for(int i = 0; i < Count; ++i)
+      {
+         read();
+      }
+      cycles = BENCHMARK_CYCLES() - cycles;
+      double ns = std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count();
+      printf("%-10s %8.1f ns/read %8.1f cycles/read\n", name, ns / Count, static_cast<double>(cycles) / Count);
+   }
+
+   volatile uint32_t sink;
+}
+
+int main()
+{
+   MemoryBme280 bme;
+   if(!bme.begin())
+   {
+      printf("begin() failed\n");
+      return 1;
+   }
+
+   Measure("readFixed", [&bme] {
+      uint32_t pressure, humidity;
+      int32_t temperature;
+      bme.readFixed(pressure, temperature, humidity);
+      sink = pressure + temperature + humidity;
+   });
+   Measure("read", [&bme] {
+      float pressure, temperature, humidity;
+      bme.read(pressure, temperature, humidity);
+      sink = static_cast<uint32_t>(pressure + temperature + humidity);
+   });
+   return 0;
+}
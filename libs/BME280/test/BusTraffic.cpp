@@ -0,0 +1,139 @@
+#include "FakeBme280.h"
+
+#include <BME280I2C.h>
+
+#include <catch.hpp>
+
+// A register read is the address write plus the read, two transactions.
+namespace
+{
+   const uint8_t CTRL_HUM = 0xF2;
+   const uint8_t CTRL_MEAS = 0xF4;
+   const uint8_t CONFIG = 0xF5;
+
+   void Read(BME280& bme)
+   {
+      uint32_t pressure, humidity;
+      int32_t temperature;
+      REQUIRE(bme.readFixed(pressure, temperature, humidity));
+   }
+}
+
+TEST_CASE("begin() reads the id and the trim in three reads")
+{
+   FakeBme280 device;
+   BME280I2C bme;
+   REQUIRE(bme.begin(4, 5));
+
+   // id, trim block 0x88-0xA1, trim block 0xE1-0xE7, then the three settings
+   REQUIRE(device.transactions == 3 * 2 + 3);
+   REQUIRE(device.registerWrites[CTRL_HUM] == 1);
+   REQUIRE(device.registerWrites[CTRL_MEAS] == 1);
+   REQUIRE(device.registerWrites[CONFIG] == 1);
+}
+
+TEST_CASE("A forced read only rewrites ctrl_meas")
+{
+   FakeBme280 device;
+   BME280I2C bme;
+   REQUIRE(bme.begin(4, 5));
+   device.ResetCounters();
+
+   Read(bme);
+   Read(bme);
+
+   REQUIRE(device.transactions == 2 * (1 + 2));
+   REQUIRE(device.registerWrites[CTRL_HUM] == 0);
+   REQUIRE(device.registerWrites[CTRL_MEAS] == 2);
+   REQUIRE(device.registerWrites[CONFIG] == 0);
+}
+
+TEST_CASE("setSettings() only writes the registers that change")
+{
+   FakeBme280 device;
+   BME280I2C bme;
+   REQUIRE(bme.begin(4, 5));
+   device.ResetCounters();
+
+   SECTION("same settings")
+   {
+      bme.setSettings(BME280I2C::Settings());
+      REQUIRE(device.registerWrites[CTRL_HUM] == 0);
+      REQUIRE(device.registerWrites[CONFIG] == 0);
+   }
+
+   SECTION("humidity oversampling")
+   {
+      bme.setSettings(BME280I2C::Settings(BME280::OSR_X1, BME280::OSR_X4));
+      REQUIRE(device.registerWrites[CTRL_HUM] == 1);
+      REQUIRE(device.registerWrites[CONFIG] == 0);
+      REQUIRE(device.registers[CTRL_HUM] == BME280::OSR_X4);
+   }
+
+   SECTION("filter")
+   {
+      bme.setSettings(BME280I2C::Settings(BME280::OSR_X1, BME280::OSR_X1, BME280::OSR_X1,
+         BME280::Mode_Forced, BME280::StandbyTime_1000ms, BME280::Filter_4));
+      REQUIRE(device.registerWrites[CTRL_HUM] == 0);
+      REQUIRE(device.registerWrites[CONFIG] == 1);
+   }
+
+   // ctrl_hum only takes effect with a ctrl_meas write
+   REQUIRE(device.registerWrites[CTRL_MEAS] == 1);
+}
+
+TEST_CASE("A failed write makes the next read rewrite every setting")
+{
+   FakeBme280 device;
+   BME280I2C bme;
+   REQUIRE(bme.begin(4, 5));
+
+   device.failWrites = true;
+   uint32_t pressure, humidity;
+   int32_t temperature;
+   bme.readFixed(pressure, temperature, humidity);
+   device.failWrites = false;
+   device.ResetCounters();
+
+   Read(bme);
+
+   REQUIRE(device.registerWrites[CTRL_HUM] == 1);
+   REQUIRE(device.registerWrites[CTRL_MEAS] == 1);
+   REQUIRE(device.registerWrites[CONFIG] == 1);
+}
+
+TEST_CASE("The single value getters share a sample in normal mode")
+{
+   FakeBme280 device;
+   BME280I2C bme(BME280I2C::Settings(BME280::OSR_X1, BME280::OSR_X1, BME280::OSR_X1,
+      BME280::Mode_Normal, BME280::StandbyTime_1000ms));
+   REQUIRE(bme.begin(4, 5));
+   device.ResetCounters();
+
+   bme.temp();
+   bme.pres();
+   bme.hum();
+   REQUIRE(device.transactions == 2);
+
+   // Standby time plus conversion time later the sensor has a new sample
+   fake::now += 1000000 + bme.measurementTime();
+   bme.temp();
+   REQUIRE(device.transactions == 4);
+   REQUIRE(device.registerWrites[CTRL_MEAS] == 0);
+}
+
+TEST_CASE("The single value getters read again in forced mode once a conversion is done")
+{
+   FakeBme280 device;
+   BME280I2C bme;
+   REQUIRE(bme.begin(4, 5));
+   device.ResetCounters();
+
+   bme.temp();
+   bme.hum();
+   REQUIRE(device.transactions == 1 + 2);
+
+   fake::now += bme.measurementTime();
+   bme.hum();
+   REQUIRE(device.transactions == 2 * (1 + 2));
+}
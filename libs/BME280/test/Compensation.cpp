@@ -0,0 +1,153 @@
+#include "FakeBme280.h"
+
+#include <BME280I2C.h>
+
+#include <catch.hpp>
+
+// Floating point compensation from the BME280 data sheet, section 8.1,
+// as the reference for the integer code.
+namespace
+{
+   struct Reference
+   {
+      double temperature;
+      double pressure;
+      double humidity;
+   };
+
+   Reference Compensate(const FakeBme280::Trim& trim, int32_t adcP, int32_t adcT, int32_t adcH)
+   {
+      Reference result;
+
+      double var1 = (adcT / 16384.0 - trim.t1 / 1024.0) * trim.t2;
+      double var2 = (adcT / 131072.0 - trim.t1 / 8192.0) * (adcT / 131072.0 - trim.t1 / 8192.0) * trim.t3;
+      double tFine = var1 + var2;
+      result.temperature = tFine / 5120.0;
+
+      var1 = tFine / 2.0 - 64000.0;
+      var2 = var1 * var1 * trim.p6 / 32768.0;
+      var2 = var2 + var1 * trim.p5 * 2.0;
+      var2 = var2 / 4.0 + trim.p4 * 65536.0;
+      var1 = (trim.p3 * var1 * var1 / 524288.0 + trim.p2 * var1) / 524288.0;
+      var1 = (1.0 + var1 / 32768.0) * trim.p1;
+      double p = 1048576.0 - adcP;
+      p = (p - var2 / 4096.0) * 6250.0 / var1;
+      var1 = trim.p9 * p * p / 2147483648.0;
+      var2 = p * trim.p8 / 32768.0;
+      result.pressure = p + (var1 + var2 + trim.p7) / 16.0;
+
+      double h = tFine - 76800.0;
+      h = (adcH - (trim.h4 * 64.0 + trim.h5 / 16384.0 * h)) *
+         (trim.h2 / 65536.0 * (1.0 + trim.h6 / 67108864.0 * h * (1.0 + trim.h3 / 67108864.0 * h)));
+      h = h * (1.0 - trim.h1 * h / 524288.0);
+      result.humidity = h > 100.0 ? 100.0 : (h < 0.0 ? 0.0 : h);
+      return result;
+   }
+
+   struct Sample
+   {
+      int32_t pressure;
+      int32_t temperature;
+      int32_t humidity;
+   };
+
+   // Worked example of the BMP280 data sheet, section 3.12, the humidity
+   // trim is that of a BME280.
+   const FakeBme280::Trim DataSheetTrim = {
+      27504, 26435, -1000,
+      36477, -10685, 3024, 2855, 140, -7, 15500, -14600, 6000,
+      75, 362, 0, 313, 50, 30
+   };
+
+   const FakeBme280::Trim ModuleTrim = {
+      28485, 26735, 50,
+      36738, -10635, 3024, 6980, -4, -7, 9900, -10230, 4285,
+      75, 353, 0, 340, 0, 30
+   };
+
+   // Cold and dry to hot and humid, at sea level and on a mountain.
+   const Sample Samples[] = {
+      { 415148, 519888, 27000 },
+      { 400000, 470000, 24000 },
+      { 430000, 500000, 30000 },
+      { 470000, 540000, 36000 },
+      { 500000, 560000, 42000 },
+      { 440000, 600000, 22000 },
+   };
+}
+
+TEST_CASE("readFixed() reproduces the data sheet example")
+{
+   FakeBme280 device;
+   device.SetTrim(DataSheetTrim);
+   device.SetRaw(415148, 519888, 27000);
+   BME280I2C bme;
+   REQUIRE(bme.begin(4, 5));
+
+   uint32_t pressure, humidity;
+   int32_t temperature;
+   REQUIRE(bme.readFixed(pressure, temperature, humidity));
+
+   REQUIRE(temperature == 2508);
+   REQUIRE(pressure / 256.0 == Approx(100653.27).epsilon(1e-6));
+}
+
+TEST_CASE("readFixed() matches the floating point compensation")
+{
+   const FakeBme280::Trim* trims[] = { &DataSheetTrim, &ModuleTrim };
+   for(size_t t = 0; t < 2; ++t)
+   {
+      FakeBme280 device;
+      device.SetTrim(*trims[t]);
+      BME280I2C bme;
+      REQUIRE(bme.begin(4, 5));
+
+      for(size_t i = 0; i < sizeof(Samples) / sizeof(Samples[0]); ++i)
+      {
+         const Sample& sample = Samples[i];
+         device.SetRaw(sample.pressure, sample.temperature, sample.humidity);
+         Reference reference = Compensate(*trims[t], sample.pressure, sample.temperature, sample.humidity);
+         CAPTURE(t);
+         CAPTURE(i);
+         CAPTURE(reference.temperature);
+         CAPTURE(reference.pressure);
+         CAPTURE(reference.humidity);
+
+         uint32_t pressure, humidity;
+         int32_t temperature;
+         REQUIRE(bme.readFixed(pressure, temperature, humidity));
+
+         // The integer code resolves 0.01 DegC, 1/256 Pa and 1/1024 %RH.
+         CHECK(temperature / 100.0 == Approx(reference.temperature).margin(0.01));
+         CHECK(pressure / 256.0 == Approx(reference.pressure).margin(1.0));
+         CHECK(humidity / 1024.0 == Approx(reference.humidity).margin(0.05));
+
+         // The float API is the fixed point result scaled.
+         float p, temp, h;
+         bme.read(p, temp, h);
+         CHECK(temp == Approx(temperature / 100.0));
+         CHECK(p == Approx(pressure / 256.0));
+         CHECK(h == Approx(humidity / 1024.0));
+      }
+   }
+}
+
+TEST_CASE("readFixed() returns 0 Pa for a zero P1 trim")
+{
+   FakeBme280 device;
+   FakeBme280::Trim trim = DataSheetTrim;
+   trim.p1 = 0;
+   device.SetTrim(trim);
+   device.SetRaw(415148, 519888, 27000);
+   BME280I2C bme;
+   REQUIRE(bme.begin(4, 5));
+
+   uint32_t pressure, humidity;
+   int32_t temperature;
+   REQUIRE(bme.readFixed(pressure, temperature, humidity));
+   REQUIRE(pressure == 0);
+
+   float p, temp, h;
+   bme.read(p, temp, h);
+   REQUIRE(isnan(p));
+}
@@ -0,0 +1,206 @@
+#include "FakeBme280.h"
+
+#include <string.h>
+
+namespace
+{
+   void PutU16(uint8_t* registers, uint8_t addr, uint16_t value)
+   {
+      registers[addr] = value & 0xFF;
+      registers[addr + 1] = value >> 8;
+   }
+}
+
+FakeBme280::FakeBme280():
+  transactions(0),
+  failWrites(false),
+  failReads(false),
+  m_pointer(0),
+  m_cs(0xFF), m_mosi(0xFF), m_miso(0xFF), m_sck(0xFF),
+  m_csLevel(true), m_sckLevel(false), m_mosiLevel(false), m_misoLevel(false),
+  m_bit(0), m_in(0), m_out(0), m_spiBytes(0), m_spiRead(false)
+{
+   memset(registers, 0, sizeof(registers));
+   registers[0xD0] = 0x60;
+   ResetCounters();
+   fake::i2c = this;
+   fake::gpio = this;
+}
+
+FakeBme280::~FakeBme280()
+{
+   fake::i2c = NULL;
+   fake::gpio = NULL;
+}
+
+void FakeBme280::SetTrim(const Trim& trim)
+{
+   PutU16(registers, 0x88, trim.t1);
+   PutU16(registers, 0x8A, trim.t2);
+   PutU16(registers, 0x8C, trim.t3);
+   PutU16(registers, 0x8E, trim.p1);
+   PutU16(registers, 0x90, trim.p2);
+   PutU16(registers, 0x92, trim.p3);
+   PutU16(registers, 0x94, trim.p4);
+   PutU16(registers, 0x96, trim.p5);
+   PutU16(registers, 0x98, trim.p6);
+   PutU16(registers, 0x9A, trim.p7);
+   PutU16(registers, 0x9C, trim.p8);
+   PutU16(registers, 0x9E, trim.p9);
+   registers[0xA1] = trim.h1;
+   PutU16(registers, 0xE1, trim.h2);
+   registers[0xE3] = trim.h3;
+   // H4 and H5 are 12 bits each, sharing the nibbles of 0xE5.
+   registers[0xE4] = (trim.h4 >> 4) & 0xFF;
+   registers[0xE5] = (trim.h4 & 0x0F) | ((trim.h5 & 0x0F) << 4);
+   registers[0xE6] = (trim.h5 >> 4) & 0xFF;
+   registers[0xE7] = trim.h6;
+}
+
+void FakeBme280::SetRaw(int32_t pressure, int32_t temperature, int32_t humidity)
+{
+   registers[0xF7] = (pressure >> 12) & 0xFF;
+   registers[0xF8] = (pressure >> 4) & 0xFF;
+   registers[0xF9] = (pressure & 0x0F) << 4;
+   registers[0xFA] = (temperature >> 12) & 0xFF;
+   registers[0xFB] = (temperature >> 4) & 0xFF;
+   registers[0xFC] = (temperature & 0x0F) << 4;
+   registers[0xFD] = (humidity >> 8) & 0xFF;
+   registers[0xFE] = humidity & 0xFF;
+}
+
+void FakeBme280::AttachSpi(uint8_t cs, uint8_t mosi, uint8_t miso, uint8_t sck)
+{
+   m_cs = cs;
+   m_mosi = mosi;
+   m_miso = miso;
+   m_sck = sck;
+}
+
+void FakeBme280::ResetCounters()
+{
+   transactions = 0;
+   memset(registerWrites, 0, sizeof(registerWrites));
+   trace.clear();
+}
+
+void FakeBme280::WriteRegister(uint8_t addr, uint8_t value)
+{
+   registers[addr] = value;
+   ++registerWrites[addr];
+}
+
+bool FakeBme280::OnWrite(uint8_t address, const uint8_t* data, size_t length)
+{
+   if(address != ADDRESS)
+   {
+      return false;
+   }
+   ++transactions;
+   if(length == 0)
+   {
+      return true;
+   }
+   if(failWrites && length > 1)
+   {
+      return false;
+   }
+
+   // A write is register address, value, repeated for burst writes.
+   m_pointer = data[0];
+   for(size_t i = 1; i < length; i += 2)
+   {
+      WriteRegister(data[i - 1], data[i]);
+   }
+   return true;
+}
+
+bool FakeBme280::OnRead(uint8_t address, uint8_t* data, size_t length)
+{
+   if(address != ADDRESS)
+   {
+      return false;
+   }
+   ++transactions;
+   if(failReads)
+   {
+      return false;
+   }
+   for(size_t i = 0; i < length; ++i)
+   {
+      data[i] = registers[m_pointer++];
+   }
+   return true;
+}
+
+void FakeBme280::OnWrite(uint8_t pin, bool level)
+{
+   char letter = '?';
+   if(pin == m_cs)
+   {
+      letter = 'S';
+      if(!level && m_csLevel)
+      {
+         ++transactions;
+         m_bit = 0;
+         m_in = 0;
+         m_out = 0;
+         m_spiBytes = 0;
+         m_misoLevel = false;
+      }
+      m_csLevel = level;
+   }
+   else if(pin == m_sck)
+   {
+      letter = 'K';
+      if(!m_csLevel && level && !m_sckLevel)
+      {
+         // Rising edge: sample the data in.
+         m_in = (m_in << 1) | (m_mosiLevel ? 1 : 0);
+         if(++m_bit == 8)
+         {
+            OnSpiByte(m_in);
+            m_bit = 0;
+            m_in = 0;
+         }
+      }
+      else if(!m_csLevel && !level && m_sckLevel)
+      {
+         // Falling edge: shift the next bit out.
+         m_misoLevel = (m_out >> (7 - m_bit)) & 1;
+      }
+      m_sckLevel = level;
+   }
+   else if(pin == m_mosi)
+   {
+      letter = 'D';
+      m_mosiLevel = level;
+   }
+   trace += level ? letter : static_cast<char>(letter | 0x20);
+}
+
+bool FakeBme280::OnRead(uint8_t pin)
+{
+   return pin == m_miso && !m_csLevel && m_misoLevel;
+}
+
+void FakeBme280::OnSpiByte(uint8_t data)
+{
+   // In SPI mode bit 7 of the control byte is the read flag and stands
+   // in for bit 7 of the register address, which is always set.
+   if(m_spiBytes == 0)
+   {
+      m_spiRead = (data & 0x80) != 0;
+      m_pointer = data | 0x80;
+   }
+   else if(!m_spiRead && m_spiBytes % 2 == 0)
+   {
+      m_pointer = data | 0x80;
+   }
+   else if(!m_spiRead)
+   {
+      WriteRegister(m_pointer, data);
+   }
+   ++m_spiBytes;
+   m_out = m_spiRead ? registers[m_pointer++] : 0;
+}
@@ -0,0 +1,63 @@
+#ifndef FAKE_BME_280_H
+#define FAKE_BME_280_H
+
+#include <Wire.h>
+
+#include <string>
+
+//////////////////////////////////////////////////////////////////
+/// Register level model of a BME280 on the fake I2C bus and on the
+/// fake GPIO pins as an SPI target. Counts the bus traffic and
+/// records the pin writes.
+///
+/// Trace letters, upper case for high: S chip select, K clock,
+/// D data in (MOSI), anything else '?'.
+class FakeBme280: public fake::I2cDevice, public fake::Gpio
+{
+public:
+   struct Trim
+   {
+      uint16_t t1; int16_t t2; int16_t t3;
+      uint16_t p1; int16_t p2; int16_t p3; int16_t p4; int16_t p5;
+      int16_t p6; int16_t p7; int16_t p8; int16_t p9;
+      uint8_t h1; int16_t h2; uint8_t h3; int16_t h4; int16_t h5; int8_t h6;
+   };
+
+   static const uint8_t ADDRESS = 0x76;
+
+   FakeBme280();
+   ~FakeBme280();
+
+   void SetTrim(const Trim& trim);
+   void SetRaw(int32_t pressure, int32_t temperature, int32_t humidity);
+   void AttachSpi(uint8_t cs, uint8_t mosi, uint8_t miso, uint8_t sck);
+   void ResetCounters();
+
+   virtual bool OnWrite(uint8_t address, const uint8_t* data, size_t length);
+   virtual bool OnRead(uint8_t address, uint8_t* data, size_t length);
+   virtual void OnWrite(uint8_t pin, bool level);
+   virtual bool OnRead(uint8_t pin);
+
+   uint8_t registers[256];
+   size_t transactions;
+   size_t registerWrites[256];
+   bool failWrites;
+   bool failReads;
+   std::string trace;
+
+private:
+   void WriteRegister(uint8_t addr, uint8_t value);
+   void OnSpiByte(uint8_t data);
+
+   uint8_t m_pointer;
+
+   uint8_t m_cs, m_mosi, m_miso, m_sck;
+   bool m_csLevel, m_sckLevel, m_mosiLevel, m_misoLevel;
+   uint8_t m_bit;
+   uint8_t m_in;
+   uint8_t m_out;
+   size_t m_spiBytes;
+   bool m_spiRead;
+};
+
+#endif // FAKE_BME_280_H
@@ -0,0 +1,117 @@
+#include "FakeBme280.h"
+
+#include <BME280SpiSw.h>
+#include <SoftSpi.h>
+
+#include <catch.hpp>
+#include <string.h>
+
+// Built twice: over digitalWrite, and with ESP8266 defined over the
+// GPOS/GPOC/GPI registers. Both must put the same edges on the pins.
+namespace
+{
+   const uint8_t CS = 15;
+   const uint8_t MOSI = 13;
+   const uint8_t MISO = 12;
+   const uint8_t SCK = 14;
+
+   // Recorded from the pins, one byte per group: for every bit, MSB
+   // first, clock low, data out, clock high.
+   std::string Trace(const char* recorded)
+   {
+      std::string trace;
+      for(; *recorded; ++recorded)
+      {
+         if(*recorded != ' ')
+         {
+            trace += *recorded;
+         }
+      }
+      return trace;
+   }
+}
+
+TEST_CASE("SoftSpi writes a register MSB first, changing data while the clock is low")
+{
+   FakeBme280 device;
+   device.AttachSpi(CS, MOSI, MISO, SCK);
+   SoftSpi spi(CS, MOSI, MISO, SCK);
+   spi.begin();
+   device.ResetCounters();
+
+   // ctrl_meas (0xF4) with the read flag cleared, then the value
+   spi.select();
+   spi.transfer(0x74);
+   spi.transfer(0x27);
+   spi.deselect();
+
+   REQUIRE(device.trace == Trace(
+      "s"
+      " kdK kDK kDK kDK kdK kDK kdK kdK"
+      " kdK kdK kDK kdK kdK kDK kDK kDK"
+      " S"));
+   REQUIRE(device.registers[0xF4] == 0x27);
+}
+
+TEST_CASE("SoftSpi reads a register MSB first")
+{
+   FakeBme280 device;
+   device.AttachSpi(CS, MOSI, MISO, SCK);
+   SoftSpi spi(CS, MOSI, MISO, SCK);
+   spi.begin();
+   device.ResetCounters();
+
+   spi.select();
+   spi.transfer(0xD0);
+   uint8_t id = spi.transfer(0x00);
+   spi.deselect();
+
+   REQUIRE(id == 0x60);
+   REQUIRE(device.trace == Trace(
+      "s"
+      " kDK kDK kdK kDK kdK kdK kdK kdK"
+      " kdK kdK kdK kdK kdK kdK kdK kdK"
+      " S"));
+}
+
+TEST_CASE("SoftSpi reads a burst")
+{
+   FakeBme280 device;
+   device.AttachSpi(CS, MOSI, MISO, SCK);
+   device.SetRaw(0x655AC, 0x7EED0, 0x6978);
+   SoftSpi spi(CS, MOSI, MISO, SCK);
+   spi.begin();
+
+   uint8_t data[8];
+   spi.select();
+   spi.transfer(0xF7);
+   spi.transfer(NULL, data, sizeof(data));
+   spi.deselect();
+
+   const uint8_t expected[] = { 0x65, 0x5A, 0xC0, 0x7E, 0xED, 0x00, 0x69, 0x78 };
+   REQUIRE(memcmp(data, expected, sizeof(data)) == 0);
+}
+
+TEST_CASE("BME280SpiSw runs over the pins")
+{
+   FakeBme280 device;
+   device.AttachSpi(CS, MOSI, MISO, SCK);
+   const FakeBme280::Trim trim = {
+      27504, 26435, -1000,
+      36477, -10685, 3024, 2855, 140, -7, 15500, -14600, 6000,
+      75, 362, 0, 313, 50, 30
+   };
+   device.SetTrim(trim);
+   device.SetRaw(415148, 519888, 27000);
+   BME280SpiSw bme(BME280SpiSw::Settings(CS, MOSI, MISO, SCK));
+
+   REQUIRE(bme.begin());
+   REQUIRE(bme.chipModel() == BME280::ChipModel_BME280);
+
+   uint32_t pressure, humidity;
+   int32_t temperature;
+   REQUIRE(bme.readFixed(pressure, temperature, humidity));
+   REQUIRE(temperature == 2508);
+   // Temperature and pressure x1, forced mode
+   REQUIRE(device.registers[0xF4] == 0x25);
+}
@@ -0,0 +1,70 @@
+#include "config_snapshot.h"
+
+#include <catch.hpp>
+#include <string>
+#include <thread>
+
+static void StoreAll(ConfigSnapshot& snapshot, const std::string& value)
+{
+  const char* values[ConfigSnapshot::FieldsCount];
+  for (const char*& v : values)
+    v = value.c_str();
+  snapshot.Store(values);
+}
+
+TEST_CASE("ConfigSnapshot")
+{
+  ConfigSnapshot snapshot;
+  ConfigSnapshot::Values values;
+
+  SECTION("Starts empty")
+  {
+    REQUIRE(snapshot.Load(values));
+    REQUIRE(std::string(values[0]) == "");
+  }
+
+  SECTION("Keeps each field")
+  {
+    const char* stored[ConfigSnapshot::FieldsCount] = {"ap", "secret", "192.168.0.3", "1883", "Moscow,ru", "20"};
+    snapshot.Store(stored);
+    REQUIRE(snapshot.Load(values));
+    for (size_t i = 0; i < ConfigSnapshot::FieldsCount; ++i)
+      REQUIRE(std::string(values[i]) == stored[i]);
+  }
+
+  SECTION("Truncates long values")
+  {
+    StoreAll(snapshot, std::string(100, 'x'));
+    REQUIRE(snapshot.Load(values));
+    REQUIRE(std::string(values[1]) == std::string(ConfigSnapshot::ValueSize - 1, 'x'));
+  }
+}
+
+TEST_CASE("ConfigSnapshot read by a web thread while the main loop writes")
+{
+  static ConfigSnapshot snapshot;
+  StoreAll(snapshot, "0");
+  const int stores = 20000;
+
+  //Every field of one Store() has the same value, a mix means a torn read.
+  //Catch is not thread safe, the result is checked after the join.
+  bool isConsistent = true;
+  std::thread web([&] {
+    ConfigSnapshot::Values values;
+    int loads = 0;
+    while (loads < stores)
+    {
+      if (!snapshot.Load(values, 1000))
+        continue;
+      ++loads;
+      for (size_t i = 1; i < ConfigSnapshot::FieldsCount; ++i)
+        isConsistent = isConsistent && strcmp(values[i], values[0]) == 0;
+    }
+  });
+
+  for (int i = 1; i <= stores; ++i)
+    StoreAll(snapshot, std::to_string(i) + std::string(static_cast<size_t>(i % 50), '.'));
+  web.join();
+
+  REQUIRE(isConsistent);
+}
@@ -0,0 +1,124 @@
+#include "events.h"
+#include "spsc_queue.h"
+
+#include <catch.hpp>
+#include <thread>
+
+TEST_CASE("SpscQueue")
+{
+  SpscQueue<int, 4> queue;
+  int item = 0;
+
+  SECTION("Empty")
+  {
+    REQUIRE(queue.IsEmpty());
+    REQUIRE_FALSE(queue.Pop(item));
+  }
+
+  SECTION("First in, first out")
+  {
+    REQUIRE(queue.Push(1));
+    REQUIRE(queue.Push(2));
+    REQUIRE(queue.Pop(item));
+    REQUIRE(item == 1);
+    REQUIRE(queue.Pop(item));
+    REQUIRE(item == 2);
+    REQUIRE(queue.IsEmpty());
+  }
+
+  SECTION("Drops when full")
+  {
+    for (int i = 0; i < 4; ++i)
+      REQUIRE(queue.Push(i));
+    REQUIRE_FALSE(queue.Push(4));
+    REQUIRE(queue.GetDropped() == 1);
+    REQUIRE(queue.Pop(item));
+    REQUIRE(queue.Push(5));
+  }
+}
+
+TEST_CASE("SpscQueue with a producer and a consumer thread")
+{
+  //Items carry their index and a checksum, so a torn or reordered copy shows up
+  struct Item
+  {
+    uint32_t index;
+    uint32_t check;
+    uint8_t padding[40];
+  };
+  static SpscQueue<Item, 8> queue;
+  const uint32_t count = 200000;
+
+  std::thread producer([&] {
+    for (uint32_t i = 0; i < count; ++i)
+    {
+      Item item{};
+      item.index = i;
+      item.check = ~i;
+      for (uint8_t& byte : item.padding)
+        byte = static_cast<uint8_t>(i);
+      while (!queue.Push(item))
+        std::this_thread::yield();
+    }
+  });
+
+  uint32_t expected = 0;
+  bool isOrdered = true;
+  while (expected < count)
+  {
+    Item item;
+    if (!queue.Pop(item))
+    {
+      std::this_thread::yield();
+      continue;
+    }
+    bool isIntact = item.index == expected && item.check == ~expected;
+    for (uint8_t byte : item.padding)
+      isIntact = isIntact && byte == static_cast<uint8_t>(expected);
+    isOrdered = isOrdered && isIntact;
+    ++expected;
+  }
+  producer.join();
+
+  REQUIRE(isOrdered);
+  REQUIRE(queue.IsEmpty());
+}
+
+TEST_CASE("EventQueue with a web producer thread")
+{
+  static EventQueue queue;
+  const int count = 20000;
+  uint32_t refused = 0;
+
+  std::thread web([&] {
+    for (int i = 0; i < count; ++i)
+    {
+      char value[16];
+      snprintf(value, sizeof(value), "%d", i);
+      while (!queue.Push(Event::MakeConfigChange(ConfigField::MqttPort, value)))
+      {
+        ++refused;
+        std::this_thread::yield();
+      }
+    }
+  });
+
+  int received = 0;
+  bool isOrdered = true;
+  while (received < count)
+  {
+    Event event;
+    if (!queue.Pop(event))
+    {
+      std::this_thread::yield();
+      continue;
+    }
+    isOrdered = isOrdered && event.type == EventType::ConfigChange && atoi(event.config.value) == received;
+    ++received;
+  }
+  web.join();
+
+  REQUIRE(isOrdered);
+  //every refused push is counted as dropped, retried or not
+  REQUIRE(queue.GetDropped() == refused);
+}
@@ -0,0 +1,143 @@
+#include "device_registry.h"
+
+#include <catch.hpp>
+#include <cstring>
+
+//Catch takes the operands by reference, which needs a definition
+static constexpr uint8_t NotFound = DeviceRegistry::NotFound;
+static constexpr size_t MaxDevices = DeviceRegistry::MaxDevices;
+
+static uint8_t Add(DeviceRegistry& registry, const char* name)
+{
+  return registry.Add(name, strlen(name));
+}
+
+static uint8_t Find(const DeviceRegistry& registry, const char* name)
+{
+  return registry.Find(name, strlen(name));
+}
+
+TEST_CASE("DeviceRegistry starts empty")
+{
+  DeviceRegistry registry;
+  REQUIRE(registry.GetCount() == 0);
+  REQUIRE(Find(registry, "device1") == NotFound);
+}
+
+TEST_CASE("DeviceRegistry keeps the devices in the order they are added")
+{
+  DeviceRegistry registry;
+  REQUIRE(Add(registry, "device3") == 0);
+  REQUIRE(Add(registry, "device1") == 1);
+  REQUIRE(Add(registry, "device3") == 0);
+  REQUIRE(registry.GetCount() == 2);
+  REQUIRE(strcmp(registry.GetName(0), "device3") == 0);
+  REQUIRE(strcmp(registry.GetName(1), "device1") == 0);
+}
+
+TEST_CASE("DeviceRegistry finds names that share a bucket")
+{
+  //device1 and device9 hash to the last bucket, device6 wraps to the first
+  DeviceRegistry registry;
+  REQUIRE(Add(registry, "device1") == 0);
+  REQUIRE(Add(registry, "device9") == 1);
+  REQUIRE(Add(registry, "device6") == 2);
+  REQUIRE(Add(registry, "device3") == 3);
+
+  REQUIRE(Find(registry, "device1") == 0);
+  REQUIRE(Find(registry, "device9") == 1);
+  REQUIRE(Find(registry, "device6") == 2);
+  REQUIRE(Find(registry, "device3") == 3);
+  REQUIRE(Find(registry, "device2") == NotFound);
+}
+
+TEST_CASE("DeviceRegistry compares the whole name")
+{
+  DeviceRegistry registry;
+  Add(registry, "device1");
+  REQUIRE(Find(registry, "device") == NotFound);
+  REQUIRE(Find(registry, "device12") == NotFound);
+  //A topic level is not terminated
+  REQUIRE(registry.Find("device1/sample", 7) == 0);
+}
+
+TEST_CASE("DeviceRegistry refuses a device it can not keep")
+{
+  DeviceRegistry registry;
+
+  SECTION("full")
+  {
+    for (size_t i = 0; i < DeviceRegistry::MaxDevices; ++i)
+    {
+      char name[] = "deviceN";
+      name[6] = '1' + i;
+      REQUIRE(Add(registry, name) == i);
+    }
+    REQUIRE(Add(registry, "device9") == NotFound);
+    REQUIRE(registry.GetCount() == MaxDevices);
+  }
+
+  SECTION("overlong name")
+  {
+    REQUIRE(Add(registry, "a_very_long_device_name") == NotFound);
+    REQUIRE(registry.GetCount() == 0);
+  }
+
+  SECTION("empty name")
+  {
+    REQUIRE(Add(registry, "") == NotFound);
+  }
+}
+
+TEST_CASE("DeviceRegistry discovers devices from sample topics")
+{
+  DeviceRegistry registry;
+  uint8_t device = DeviceRegistry::NotFound;
+
+  REQUIRE(registry.ParseDeviceTopic("unit1/device1/sample", device));
+  REQUIRE(device == 0);
+  REQUIRE(registry.ParseDeviceTopic("unit1/device4/sample", device));
+  REQUIRE(device == 1);
+  REQUIRE(registry.ParseDeviceTopic("unit1/device1/sample", device));
+  REQUIRE(device == 0);
+
+  REQUIRE_FALSE(registry.ParseDeviceTopic("unit1", device));
+  REQUIRE_FALSE(registry.ParseDeviceTopic("unit1/device5", device));
+  REQUIRE_FALSE(registry.ParseDeviceTopic("unit1//sample", device));
+  REQUIRE(registry.GetCount() == 2);
+}
+
+TEST_CASE("DeviceRegistry discovers devices from status topics")
+{
+  DeviceRegistry registry;
+  uint8_t device = DeviceRegistry::NotFound;
+  SensorChannel channel = SensorChannel::Count;
+
+  SECTION("sensor channels")
+  {
+    REQUIRE(registry.ParseStatusTopic("unit1/device1/sensor1/status", device, channel));
+    REQUIRE(device == 0);
+    REQUIRE(channel == SensorChannel::Temperature);
+    REQUIRE(registry.ParseStatusTopic("unit1/device1/sensor2/status", device, channel));
+    REQUIRE(channel == SensorChannel::Humidity);
+    REQUIRE(registry.ParseStatusTopic("unit1/device3/sensor3/status", device, channel));
+    REQUIRE(device == 1);
+    REQUIRE(channel == SensorChannel::Pressure);
+  }
+
+  SECTION("error")
+  {
+    REQUIRE(registry.ParseStatusTopic("unit1/device1/error/status", device, channel));
+    REQUIRE(channel == SensorChannel::Error);
+  }
+
+  SECTION("other levels do not add a device")
+  {
+    REQUIRE_FALSE(registry.ParseStatusTopic("unit1/device1/hello/status", device, channel));
+    REQUIRE_FALSE(registry.ParseStatusTopic("unit1/device1/sensor4/status", device, channel));
+    REQUIRE_FALSE(registry.ParseStatusTopic("unit1/device1/sensor12/status", device, channel));
+    REQUIRE_FALSE(registry.ParseStatusTopic("unit1/device1/sensor", device, channel));
+    REQUIRE_FALSE(registry.ParseStatusTopic("unit1/device1", device, channel));
+    REQUIRE(registry.GetCount() == 0);
+  }
+}
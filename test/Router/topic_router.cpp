@@ -0,0 +1,217 @@
+#include "topic_router.h"
+
+#include <catch.hpp>
+#include <cmath>
+#include <cstring>
+#include <string>
+
+//Records which route got the message
+static std::string dispatched;
+
+static void Record(void* context, uint8_t id, const char* topic, const uint8_t*, uint32_t)
+{
+  *static_cast<int*>(context) += 1;
+  dispatched = std::to_string(id) + ":" + topic;
+}
+
+static bool Dispatch(const TopicRouter& router, const char* topic)
+{
+  dispatched.clear();
+  return router.Dispatch(topic, nullptr, 0);
+}
+
+static bool Parse(const char* text, float& value)
+{
+  return ParsePayloadFloat(reinterpret_cast<const uint8_t*>(text), strlen(text), value);
+}
+
+TEST_CASE("TopicRouter::Matches follows the MQTT wildcards")
+{
+  SECTION("single level")
+  {
+    REQUIRE(TopicRouter::Matches("home/+/temp", "home/device1/temp"));
+    REQUIRE(TopicRouter::Matches("home/+/temp", "home//temp"));
+    REQUIRE(TopicRouter::Matches("home/+", "home/device1"));
+    REQUIRE_FALSE(TopicRouter::Matches("home/+", "home/device1/temp"));
+    REQUIRE_FALSE(TopicRouter::Matches("home/+/temp", "home/device1/hum"));
+    REQUIRE_FALSE(TopicRouter::Matches("home/+/temp", "home/temp"));
+  }
+
+  SECTION("multi level")
+  {
+    REQUIRE(TopicRouter::Matches("#", "home/device1/temp"));
+    REQUIRE(TopicRouter::Matches("home/#", "home/device1/temp"));
+    REQUIRE(TopicRouter::Matches("home/#", "home/device1"));
+    //The parent level matches too
+    REQUIRE(TopicRouter::Matches("home/#", "home"));
+    REQUIRE_FALSE(TopicRouter::Matches("home/#", "homes/device1"));
+    REQUIRE_FALSE(TopicRouter::Matches("home/#", "office/device1"));
+  }
+
+  SECTION("both")
+  {
+    REQUIRE(TopicRouter::Matches("+/device1/#", "home/device1/temp/raw"));
+    REQUIRE_FALSE(TopicRouter::Matches("+/device1/#", "home/device2/temp"));
+  }
+
+  SECTION("no wildcard")
+  {
+    REQUIRE(TopicRouter::Matches("home/temp", "home/temp"));
+    REQUIRE_FALSE(TopicRouter::Matches("home/temp", "home/temp/raw"));
+    REQUIRE_FALSE(TopicRouter::Matches("home/temp/raw", "home/temp"));
+  }
+}
+
+TEST_CASE("TopicRouter prefers an exact route over a wildcard")
+{
+  static const TopicRouter::Route routes[] =
+  {
+    {"home/+/temp", Record, 1},
+    {"home/device1/temp", Record, 2},
+    {"home/#", Record, 3},
+  };
+  int calls = 0;
+  TopicRouter router(routes, 3, &calls);
+
+  REQUIRE(Dispatch(router, "home/device1/temp"));
+  REQUIRE(dispatched == "2:home/device1/temp");
+  REQUIRE(Dispatch(router, "home/device2/temp"));
+  REQUIRE(dispatched == "1:home/device2/temp");
+  REQUIRE(Dispatch(router, "home/device2/hum"));
+  REQUIRE(dispatched == "3:home/device2/hum");
+  REQUIRE(calls == 3);
+}
+
+TEST_CASE("TopicRouter ignores an unmatched topic")
+{
+  static const TopicRouter::Route routes[] =
+  {
+    {"home/device1/temp", Record, 1},
+    {"home/+/hum", Record, 2},
+  };
+  int calls = 0;
+  TopicRouter router(routes, 2, &calls);
+
+  REQUIRE_FALSE(Dispatch(router, "home/device1/tem"));
+  REQUIRE_FALSE(Dispatch(router, "home/device1/temp/raw"));
+  REQUIRE_FALSE(Dispatch(router, "office/device1/hum"));
+  REQUIRE_FALSE(Dispatch(router, ""));
+  REQUIRE(calls == 0);
+}
+
+TEST_CASE("TopicRouter compares the text of routes whose hashes collide")
+{
+  //Same length and the same FNV-1a hash
+  size_t length1 = 0;
+  size_t length2 = 0;
+  REQUIRE(TopicRouter::Hash("home/ixfrw", length1) == TopicRouter::Hash("home/skexa", length2));
+  REQUIRE(length1 == length2);
+
+  static const TopicRouter::Route routes[] =
+  {
+    {"home/ixfrw", Record, 1},
+    {"home/skexa", Record, 2},
+  };
+  int calls = 0;
+  TopicRouter router(routes, 2, &calls);
+
+  REQUIRE(Dispatch(router, "home/skexa"));
+  REQUIRE(dispatched == "2:home/skexa");
+  REQUIRE(Dispatch(router, "home/ixfrw"));
+  REQUIRE(dispatched == "1:home/ixfrw");
+}
+
+TEST_CASE("TopicRouter::Hash can be computed in pieces")
+{
+  size_t length = 0;
+  uint32_t whole = TopicRouter::Hash("home/device1/temp", length);
+  REQUIRE(length == 17);
+
+  size_t prefixLength = 0;
+  uint32_t hash = TopicRouter::Hash("home/", prefixLength);
+  REQUIRE(TopicRouter::Hash("device1/temp", 12, hash) == whole);
+}
+
+TEST_CASE("ParsePayloadFloat reads plain numbers")
+{
+  float value = 0;
+
+  SECTION("integer")
+  {
+    REQUIRE(Parse("21", value));
+    REQUIRE(value == 21.0f);
+  }
+
+  SECTION("fraction")
+  {
+    REQUIRE(Parse("21.25", value));
+    REQUIRE(value == 21.25f);
+    REQUIRE(Parse(".5", value));
+    REQUIRE(value == 0.5f);
+    REQUIRE(Parse("5.", value));
+    REQUIRE(value == 5.0f);
+  }
+
+  SECTION("signs")
+  {
+    REQUIRE(Parse("-12.5", value));
+    REQUIRE(value == -12.5f);
+    REQUIRE(Parse("+12.5", value));
+    REQUIRE(value == 12.5f);
+    REQUIRE(Parse("-0", value));
+    REQUIRE(value == 0.0f);
+  }
+
+  SECTION("padding")
+  {
+    REQUIRE(Parse("  748.3 ", value));
+    REQUIRE(value == Approx(748.3f));
+    //Some publishers count the terminating zero
+    REQUIRE(ParsePayloadFloat(reinterpret_cast<const uint8_t*>("45.5"), 5, value));
+    REQUIRE(value == 45.5f);
+  }
+}
+
+TEST_CASE("ParsePayloadFloat reads exponents")
+{
+  float value = 0;
+  REQUIRE(Parse("1e3", value));
+  REQUIRE(value == 1000.0f);
+  REQUIRE(Parse("2.5E-2", value));
+  REQUIRE(value == Approx(0.025f));
+  REQUIRE(Parse("-7.5e+1", value));
+  REQUIRE(value == -75.0f);
+  REQUIRE(Parse("1e-60", value));
+  REQUIRE(value == 0.0f);
+  REQUIRE(Parse("0e999999", value));
+  REQUIRE(value == 0.0f);
+
+  SECTION("out of the float range")
+  {
+    REQUIRE_FALSE(Parse("1e39", value));
+    REQUIRE_FALSE(Parse("1e999999", value));
+  }
+}
+
+TEST_CASE("ParsePayloadFloat keeps the leading digits of a long mantissa")
+{
+  float value = 0;
+  REQUIRE(Parse("123456789012", value));
+  REQUIRE(value == Approx(123456789012.0f));
+  REQUIRE(Parse("0.000000000123456789012", value));
+  REQUIRE(value == Approx(1.23456789012e-10f));
+  REQUIRE(Parse("99999999999999999999.5", value));
+  REQUIRE(value == Approx(1e20f));
+}
+
+TEST_CASE("ParsePayloadFloat rejects junk")
+{
+  float value = 42;
+  const char* junk[] = {"", " ", "-", "+", ".", "-.", "e3", "1e", "1e+", "12a", "1.2.3", "nan", "1 2", "--1", "0x10"};
+  for (const char* text : junk)
+  {
+    INFO(text);
+    REQUIRE_FALSE(Parse(text, value));
+  }
+  REQUIRE(value == 42);
+}
@@ -0,0 +1,136 @@
+#include "scheduler.h"
+
+#include <catch.hpp>
+#include <string>
+
+//millis() is 32 bits on the ESP8266, so the fake clock wraps like it
+static uint32_t now = 0;
+
+static unsigned long FakeMillis()
+{
+  return now;
+}
+
+TEST_CASE("Scheduler runs the tasks by deadline")
+{
+  now = 1000;
+  Scheduler scheduler(FakeMillis);
+  std::string order;
+  Task a([&] { order += 'a'; }, 0);
+  Task b([&] { order += 'b'; }, 0);
+  Task c([&] { order += 'c'; }, 0);
+  Task d([&] { order += 'd'; }, 0);
+
+  REQUIRE(scheduler.Add(c, 30));
+  REQUIRE(scheduler.Add(a, 10));
+  REQUIRE(scheduler.Add(d, 40));
+  REQUIRE(scheduler.Add(b, 20));
+  REQUIRE(scheduler.GetTimeToNextMs() == 10);
+
+  now += 25;
+  scheduler.loop();
+  REQUIRE(order == "ab");
+  REQUIRE(scheduler.GetTasksCount() == 2);
+
+  now += 100;
+  scheduler.loop();
+  REQUIRE(order == "abcd");
+  REQUIRE(scheduler.GetTasksCount() == 0);
+}
+
+TEST_CASE("Scheduler keeps the heap ordered when tasks are moved or removed")
+{
+  now = 0;
+  Scheduler scheduler(FakeMillis);
+  std::string order;
+  Task* tasks[Scheduler::MaxTasks];
+  for (size_t i = 0; i < Scheduler::MaxTasks; ++i)
+  {
+    char name = static_cast<char>('a' + i);
+    tasks[i] = new Task([&order, name] { order += name; }, 0);
+    //deadlines 150, 140, ... 0: inserted in reverse order
+    REQUIRE(scheduler.Add(*tasks[i], 10 * (Scheduler::MaxTasks - 1 - i)));
+  }
+
+  Task extra([] {}, 0);
+  REQUIRE_FALSE(scheduler.Add(extra));
+
+  scheduler.Remove(*tasks[10]);         //k, deadline 50
+  REQUIRE(scheduler.Add(*tasks[0], 5)); //150 -> 5, rescheduling doesn't need room
+  now = 1000;
+  scheduler.loop();
+  REQUIRE(order == "paonmljihgfedcb");
+
+  for (Task* task : tasks)
+    delete task;
+}
+
+TEST_CASE("Scheduler reschedules periodic tasks")
+{
+  now = 0;
+  Scheduler scheduler(FakeMillis);
+  int runs = 0;
+  Task task([&] { ++runs; }, 100);
+  scheduler.Add(task);
+
+  for (now = 0; now < 1000; now += 10)
+    scheduler.loop();
+  REQUIRE(runs == 10);
+  REQUIRE(task.GetMaxJitterMs() == 0);
+
+  SECTION("Late runs don't pile up")
+  {
+    now += 1000;
+    scheduler.loop();
+    REQUIRE(runs == 11);
+    REQUIRE(scheduler.GetTimeToNextMs() == 100);
+  }
+
+  SECTION("A task can remove itself")
+  {
+    Task once([&] { scheduler.Remove(task); }, 100);
+    scheduler.Add(once);
+    scheduler.loop();
+    REQUIRE_FALSE(task.IsScheduled());
+    REQUIRE(once.IsScheduled());
+  }
+}
+
+TEST_CASE("Scheduler handles the millis() wrap")
+{
+  now = 0xFFFFFF00;
+  Scheduler scheduler(FakeMillis);
+  std::string order;
+  Task beforeWrap([&] { order += 'b'; }, 0);
+  Task afterWrap([&] { order += 'a'; }, 0);
+
+  scheduler.Add(afterWrap, 0x200); //0x00000100
+  scheduler.Add(beforeWrap, 0xF0); //0xFFFFFFF0
+  REQUIRE(scheduler.GetTimeToNextMs() == 0xF0);
+
+  now = 0xFFFFFFF8;
+  scheduler.loop();
+  REQUIRE(order == "b");
+  REQUIRE(scheduler.GetTimeToNextMs() == 0x108);
+
+  now = 0x00000080;
+  scheduler.loop();
+  REQUIRE(order == "b");
+  REQUIRE(scheduler.GetTimeToNextMs() == 0x80);
+
+  now = 0x00000100;
+  scheduler.loop();
+  REQUIRE(order == "ba");
+}
+
+TEST_CASE("Scheduler counts the overruns")
+{
+  now = 0;
+  Scheduler scheduler(FakeMillis);
+  Task slow([] { now += 30; }, 100, 20);
+  scheduler.Add(slow);
+  scheduler.loop();
+  REQUIRE(slow.GetRuns() == 1);
+  REQUIRE(slow.GetOverruns() == 1);
+  REQUIRE(slow.GetMaxDurationMs() == 30);
+}
@@ -0,0 +1,53 @@
+#include "backoff.h"
+
+#include <catch.hpp>
+
+TEST_CASE("Backoff lets the first attempt through")
+{
+  Backoff backoff(1000, 60 * 1000);
+  REQUIRE(backoff.IsDue(0));
+  REQUIRE(backoff.GetIntervalMs() == 1000);
+  REQUIRE(backoff.GetFailures() == 0);
+}
+
+TEST_CASE("Backoff doubles the interval after each failure up to the maximum")
+{
+  Backoff backoff(1000, 60 * 1000);
+  uint32_t now = 0;
+  const uint32_t expected[] = {1000, 2000, 4000, 8000, 16000, 32000, 60000, 60000};
+  for (uint32_t interval : expected)
+  {
+    backoff.OnFailed(now);
+    REQUIRE(backoff.GetIntervalMs() == interval);
+    REQUIRE_FALSE(backoff.IsDue(now + interval - 1));
+    REQUIRE(backoff.IsDue(now + interval));
+    now += interval;
+  }
+  REQUIRE(backoff.GetFailures() == 8);
+}
+
+TEST_CASE("Backoff counts the interval across the millis() wrap")
+{
+  Backoff backoff(1000, 60 * 1000);
+  uint32_t now = UINT32_MAX - 100;
+  backoff.OnFailed(now);
+  REQUIRE_FALSE(backoff.IsDue(now + 999));
+  REQUIRE(backoff.IsDue(now + 1000));
+}
+
+TEST_CASE("Backoff starts over from the minimum after a success")
+{
+  Backoff backoff(1000, 60 * 1000);
+  for (uint32_t now = 0; now < 5; ++now)
+    backoff.OnFailed(now);
+  REQUIRE(backoff.GetIntervalMs() == 16000);
+
+  backoff.Reset();
+  REQUIRE(backoff.GetFailures() == 0);
+  REQUIRE(backoff.GetIntervalMs() == 1000);
+  REQUIRE(backoff.IsDue(5));
+
+  backoff.OnFailed(10);
+  REQUIRE(backoff.GetIntervalMs() == 1000);
+  REQUIRE(backoff.IsDue(1010));
+}
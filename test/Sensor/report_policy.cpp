@@ -0,0 +1,150 @@
+#include "report_policy.h"
+
+#include <catch.hpp>
+#include <cmath>
+
+namespace
+{
+  constexpr ReportConfig Config{{0.2f, 1.0f, 0.3f}, 60 * 1000, 1000};
+
+  //Reports the first sample, then starts a new window at the given time
+  void Start(ReportPolicy& policy, const float* values, uint32_t now)
+  {
+    REQUIRE(policy.AddSample(values, now));
+    policy.OnReported(values, now);
+  }
+}
+
+TEST_CASE("ReportPolicy reports the first sample")
+{
+  ReportPolicy policy(Config);
+  float values[] = {20.0f, 50.0f, 750.0f};
+  REQUIRE(policy.AddSample(values, 0));
+}
+
+TEST_CASE("ReportPolicy reports a deadband crossing on any channel")
+{
+  ReportPolicy policy(Config);
+  float reported[] = {20.0f, 50.0f, 750.0f};
+  Start(policy, reported, 0);
+
+  float values[] = {20.0f, 50.0f, 750.0f};
+  for (size_t i = 0; i < ReportPolicy::ChannelsCount; ++i)
+  {
+    values[i] = reported[i] + Config.deadband[i] * 0.5f;
+    REQUIRE_FALSE(policy.AddSample(values, 2000));
+    values[i] = reported[i] - Config.deadband[i] * 1.5f;
+    REQUIRE(policy.AddSample(values, 2000));
+    values[i] = reported[i];
+  }
+}
+
+TEST_CASE("ReportPolicy holds an exception back for the minimum interval")
+{
+  ReportPolicy policy(Config);
+  float values[] = {20.0f, 50.0f, 750.0f};
+  Start(policy, values, 0);
+
+  values[0] += 1.0f;
+  REQUIRE_FALSE(policy.AddSample(values, Config.minIntervalMs - 1));
+  REQUIRE(policy.AddSample(values, Config.minIntervalMs));
+}
+
+TEST_CASE("ReportPolicy reports an unchanged value when the heartbeat expires")
+{
+  ReportPolicy policy(Config);
+  float values[] = {20.0f, 50.0f, 750.0f};
+  Start(policy, values, 1000);
+
+  REQUIRE_FALSE(policy.AddSample(values, 1000 + Config.heartbeatMs - 1));
+  REQUIRE(policy.AddSample(values, 1000 + Config.heartbeatMs));
+
+  SECTION("across the millis() wrap")
+  {
+    uint32_t start = UINT32_MAX - 100;
+    policy.OnReported(values, start);
+    REQUIRE_FALSE(policy.AddSample(values, start + Config.heartbeatMs - 1));
+    REQUIRE(policy.AddSample(values, start + Config.heartbeatMs));
+  }
+}
+
+TEST_CASE("ReportPolicy keeps min, mean and max of the window")
+{
+  ReportPolicy policy(Config);
+  float first[] = {20.0f, 50.0f, 750.0f};
+  Start(policy, first, 0);
+
+  float samples[][ReportPolicy::ChannelsCount] = {
+    {21.0f, 40.0f, 751.0f},
+    {19.0f, 60.0f, 749.0f},
+    {20.0f, 50.0f, 750.0f},
+  };
+  for (size_t i = 0; i < 3; ++i)
+    policy.AddSample(samples[i], 100 * (i + 1));
+
+  const ChannelStats& stats = policy.GetStats(0);
+  REQUIRE(stats.count == 3);
+  REQUIRE(stats.min == 19.0f);
+  REQUIRE(stats.max == 21.0f);
+  REQUIRE(stats.GetMean() == Approx(20.0f));
+  REQUIRE(policy.GetStats(1).min == 40.0f);
+  REQUIRE(policy.GetStats(1).max == 60.0f);
+  //The window opens with its first sample
+  REQUIRE(policy.GetWindowMs(300) == 200);
+
+  SECTION("OnReported() starts a new window")
+  {
+    policy.OnReported(samples[2], 300);
+    for (size_t i = 0; i < ReportPolicy::ChannelsCount; ++i)
+    {
+      REQUIRE(policy.GetStats(i).count == 0);
+      REQUIRE(std::isnan(policy.GetStats(i).GetMean()));
+    }
+    REQUIRE(policy.GetWindowMs(300) == 0);
+
+    float next[] = {22.0f, 55.0f, 752.0f};
+    policy.AddSample(next, 400);
+    REQUIRE(policy.GetStats(0).min == 22.0f);
+    REQUIRE(policy.GetStats(0).max == 22.0f);
+    REQUIRE(policy.GetStats(0).GetMean() == 22.0f);
+    REQUIRE(policy.GetWindowMs(500) == 100);
+  }
+}
+
+TEST_CASE("ReportPolicy leaves NaN samples out of the window")
+{
+  ReportPolicy policy(Config);
+  float values[] = {20.0f, NAN, 750.0f};
+  REQUIRE(policy.AddSample(values, 0));
+
+  REQUIRE(policy.GetStats(0).count == 1);
+  REQUIRE(policy.GetStats(1).count == 0);
+  REQUIRE(std::isnan(policy.GetStats(1).GetMean()));
+}
+
+TEST_CASE("ReportPolicy treats a channel going to or from NaN as an exception")
+{
+  ReportPolicy policy(Config);
+  float values[] = {20.0f, 50.0f, 750.0f};
+  Start(policy, values, 0);
+
+  SECTION("sensor error")
+  {
+    float error[] = {NAN, NAN, NAN};
+    REQUIRE(policy.AddSample(error, 2000));
+  }
+
+  SECTION("recovery")
+  {
+    float error[] = {NAN, NAN, NAN};
+    policy.OnReported(error, 0);
+    REQUIRE(policy.AddSample(values, 2000));
+  }
+
+  SECTION("still failing")
+  {
+    float error[] = {NAN, NAN, NAN};
+    policy.OnReported(error, 0);
+    REQUIRE_FALSE(policy.AddSample(error, 2000));
+  }
+}
@@ -0,0 +1,235 @@
+#include "rtc_batch.h"
+#include "crc32.h"
+
+#include <catch.hpp>
+#include <cstring>
+
+//The image is read back from RTC memory by the next boot, possibly of an
+//older or newer firmware, so its layout is part of the format
+static_assert(offsetof(RtcState, magic) == 0, "RtcState layout changed");
+static_assert(offsetof(RtcState, crc) == 4, "RtcState layout changed");
+static_assert(offsetof(RtcState, totalWakes) == 8, "RtcState layout changed");
+static_assert(offsetof(RtcState, dropped) == 32, "RtcState layout changed");
+static_assert(offsetof(RtcState, head) == 36, "RtcState layout changed");
+static_assert(offsetof(RtcState, count) == 37, "RtcState layout changed");
+static_assert(offsetof(RtcState, sensorErrors) == 38, "RtcState layout changed");
+static_assert(offsetof(RtcState, entries) == 40, "RtcState layout changed");
+static_assert(sizeof(RtcState) == 40 + 12 * RtcState::Capacity, "RtcState layout changed");
+
+static SampleRecord MakeRecord(float temperature)
+{
+  SampleRecord record;
+  record.SetTemperature(temperature);
+  record.SetHumidity(50);
+  record.SetPressure(750);
+  return record;
+}
+
+//What the RTC memory holds after a power-on reset, or after a wake that
+//did not finish
+static void Scramble(RtcState& state)
+{
+  memset(&state, 0xa5, sizeof(state));
+}
+
+TEST_CASE("Crc32 matches the standard check value")
+{
+  const char* text = "123456789";
+  REQUIRE(Crc32(reinterpret_cast<const uint8_t*>(text), strlen(text)) == 0xCBF43926);
+}
+
+TEST_CASE("Crc32 can be computed in pieces")
+{
+  const char* text = "123456789";
+  const uint8_t* data = reinterpret_cast<const uint8_t*>(text);
+  REQUIRE(Crc32(data + 4, 5, Crc32(data, 4)) == 0xCBF43926);
+}
+
+TEST_CASE("SampleBatch starts over from invalid RTC memory")
+{
+  RtcState state;
+  Scramble(state);
+  SampleBatch batch(state);
+
+  REQUIRE_FALSE(batch.Restore());
+  REQUIRE(batch.GetCount() == 0);
+  REQUIRE(batch.GetTotalWakes() == 0);
+  REQUIRE(batch.GetUptimeMs() == 0);
+}
+
+TEST_CASE("SampleBatch restores a sealed image")
+{
+  RtcState state;
+  Scramble(state);
+  SampleBatch batch(state);
+  batch.Restore();
+  SampleRecord record = MakeRecord(21.5f);
+  batch.Append(record);
+  batch.OnSleep(120);
+  batch.Seal();
+
+  RtcState copy;
+  memcpy(&copy, &state, sizeof(state));
+  SampleBatch restored(copy);
+  REQUIRE(restored.Restore());
+  REQUIRE(restored.GetCount() == 1);
+  REQUIRE(restored.Get(0, 1).GetTemperature() == Approx(21.5f));
+}
+
+TEST_CASE("SampleBatch rejects a corrupted image")
+{
+  RtcState state;
+  Scramble(state);
+  SampleBatch batch(state);
+  batch.Restore();
+  SampleRecord record = MakeRecord(21.5f);
+  batch.Append(record);
+  batch.Seal();
+
+  SECTION("in a counter")
+  {
+    ++state.totalWakes;
+  }
+  SECTION("in an entry")
+  {
+    state.entries[0].temperature ^= 1;
+  }
+  SECTION("in the last byte")
+  {
+    reinterpret_cast<uint8_t*>(&state)[sizeof(state) - 1] ^= 0x80;
+  }
+  SECTION("in the magic")
+  {
+    state.magic = 0;
+  }
+
+  REQUIRE_FALSE(batch.Restore());
+  REQUIRE(batch.GetCount() == 0);
+}
+
+TEST_CASE("SampleBatch rejects a sealed image with an impossible count")
+{
+  RtcState state;
+  Scramble(state);
+  SampleBatch batch(state);
+  batch.Restore();
+  state.count = RtcState::Capacity + 1;
+  batch.Seal();
+
+  REQUIRE_FALSE(batch.Restore());
+}
+
+TEST_CASE("SampleBatch accounts the wakes")
+{
+  RtcState state;
+  Scramble(state);
+  SampleBatch batch(state);
+  batch.Restore();
+
+  //First boot: nothing slept yet, awake for 200 ms
+  batch.OnSleep(200);
+  batch.OnWake(60000);
+  REQUIRE(batch.GetTotalWakes() == 1);
+  REQUIRE(batch.GetUptimeMs() == 60200);
+
+  batch.OnSleep(150);
+  batch.OnWake(60000);
+  REQUIRE(batch.GetTotalWakes() == 2);
+  REQUIRE(batch.GetUptimeMs() == 120350);
+
+  SECTION("timestamps samples with the uptime")
+  {
+    SampleRecord record = MakeRecord(20);
+    batch.Append(record);
+    REQUIRE(record.timestamp == 120350);
+    REQUIRE(batch.Get(0, 1).timestamp == 120350);
+  }
+}
+
+TEST_CASE("SampleBatch counts the sensor errors")
+{
+  RtcState state;
+  Scramble(state);
+  SampleBatch batch(state);
+  batch.Restore();
+
+  batch.OnSensorError();
+  batch.OnSensorError();
+  REQUIRE(batch.GetSensorErrors() == 2);
+
+  state.sensorErrors = UINT16_MAX;
+  batch.OnSensorError();
+  REQUIRE(batch.GetSensorErrors() == UINT16_MAX);
+}
+
+TEST_CASE("SampleBatch is due for publishing every N wakes")
+{
+  RtcState state;
+  Scramble(state);
+  SampleBatch batch(state);
+  batch.Restore();
+  const uint32_t everyWakes = 3;
+
+  //Same order as a duty cycle: wake, sample, decide, then pick the radio
+  //mode for the next wake
+  for (uint32_t wake = 1; wake <= everyWakes; ++wake)
+  {
+    batch.OnWake(1000);
+    SampleRecord record = MakeRecord(20);
+    batch.Append(record);
+    REQUIRE(batch.IsPublishDue(everyWakes) == (wake == everyWakes));
+    if (wake < everyWakes)
+      REQUIRE(batch.IsPublishDueOnNextWake(everyWakes) == (wake + 1 == everyWakes));
+  }
+
+  batch.OnPublished(batch.GetCount());
+  REQUIRE(batch.GetCount() == 0);
+  REQUIRE_FALSE(batch.IsPublishDue(everyWakes));
+}
+
+TEST_CASE("SampleBatch keeps the unpublished tail after a partial publish")
+{
+  RtcState state;
+  Scramble(state);
+  SampleBatch batch(state);
+  batch.Restore();
+  for (int i = 0; i < 5; ++i)
+  {
+    batch.OnWake(1000);
+    SampleRecord record = MakeRecord(static_cast<float>(i));
+    batch.Append(record);
+  }
+
+  batch.OnPublished(2);
+  batch.OnPublishFailed();
+
+  REQUIRE(batch.GetCount() == 3);
+  REQUIRE(batch.GetFailedPublishes() == 1);
+  REQUIRE(batch.IsPublishDue(5));
+  REQUIRE(batch.Get(0, 1).GetTemperature() == Approx(2));
+  REQUIRE(batch.Get(0, 1).sequence == 3);
+  REQUIRE(batch.Get(2, 1).sequence == 5);
+}
+
+TEST_CASE("SampleBatch drops the oldest samples when full")
+{
+  RtcState state;
+  Scramble(state);
+  SampleBatch batch(state);
+  batch.Restore();
+  //Catch takes the operands by reference
+  const size_t capacity = RtcState::Capacity;
+  const size_t extra = 3;
+  for (size_t i = 0; i < capacity + extra; ++i)
+  {
+    SampleRecord record = MakeRecord(static_cast<float>(i));
+    batch.Append(record);
+  }
+
+  REQUIRE(batch.GetCount() == capacity);
+  REQUIRE(batch.GetDropped() == extra);
+  REQUIRE(batch.IsPublishDue(1000));
+  REQUIRE(batch.Get(0, 1).sequence == extra + 1);
+  REQUIRE(batch.Get(0, 1).GetTemperature() == Approx(extra));
+  REQUIRE(batch.Get(capacity - 1, 1).sequence == capacity + extra);
+}
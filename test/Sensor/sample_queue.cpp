@@ -0,0 +1,236 @@
+#include "sample_queue.h"
+
+#include <catch.hpp>
+#include <vector>
+
+//Spill file kept in memory, survives a "reset" as long as the object lives
+class MemoryStorage: public SpillStorage
+{
+public:
+  bool Append(const uint8_t* data, size_t length) override
+  {
+    bytes.insert(bytes.end(), data, data + length);
+    return true;
+  }
+
+  bool Read(size_t offset, uint8_t* data, size_t length) override
+  {
+    if (offset + length > bytes.size())
+      return false;
+    std::copy(bytes.begin() + offset, bytes.begin() + offset + length, data);
+    return true;
+  }
+
+  size_t GetSize() override { return bytes.size(); }
+
+  bool Truncate(size_t size) override
+  {
+    bytes.resize(size);
+    return true;
+  }
+
+  void Clear() override
+  {
+    bytes.clear();
+    readOffset = 0;
+  }
+
+  size_t GetReadOffset() override { return readOffset; }
+
+  bool SetReadOffset(size_t offset) override
+  {
+    readOffset = offset;
+    ++readOffsetWrites;
+    return true;
+  }
+
+  std::vector<uint8_t> bytes;
+  size_t readOffset = 0;
+  size_t readOffsetWrites = 0;
+};
+
+//Stands in for the MQTT broker, Replay() in the sketch pops only what it accepted
+class FakeBroker
+{
+public:
+  bool isUp = true;
+  std::vector<uint32_t> received;
+
+  void Replay(SampleQueue& queue, size_t batchSize = 4)
+  {
+    SampleRecord records[SampleQueue::MaxPeek];
+    size_t count = queue.Peek(records, batchSize);
+    if (count == 0 || !isUp)
+      return;
+    for (size_t i = 0; i < count; ++i)
+      received.push_back(records[i].sequence);
+    queue.Pop(count);
+  }
+
+  void Drain(SampleQueue& queue)
+  {
+    for (size_t guard = 0; queue.GetCount() != 0 && guard < 10000; ++guard)
+      Replay(queue);
+  }
+};
+
+static SampleRecord MakeRecord(uint32_t sequence)
+{
+  SampleRecord record;
+  record.sequence = sequence;
+  record.SetTemperature(20);
+  return record;
+}
+
+static void PushRange(SampleQueue& queue, uint32_t first, uint32_t last)
+{
+  for (uint32_t sequence = first; sequence <= last; ++sequence)
+    queue.Push(MakeRecord(sequence));
+}
+
+static std::vector<uint32_t> Range(uint32_t first, uint32_t last)
+{
+  std::vector<uint32_t> result;
+  for (uint32_t sequence = first; sequence <= last; ++sequence)
+    result.push_back(sequence);
+  return result;
+}
+
+TEST_CASE("SampleQueue delivers in order across RAM and spill")
+{
+  MemoryStorage storage;
+  SampleQueue queue(&storage, 100);
+  queue.begin();
+  FakeBroker broker;
+
+  broker.isUp = false;
+  PushRange(queue, 1, 50);
+  broker.Replay(queue);
+  REQUIRE(queue.GetSpilledCount() == 50 - SampleQueue::RamCapacity);
+
+  broker.isUp = true;
+  broker.Drain(queue);
+  REQUIRE(broker.received == Range(1, 50));
+  REQUIRE(storage.GetSize() == 0);
+  REQUIRE(queue.GetDropped() == 0);
+}
+
+TEST_CASE("SampleQueue drops once the spill storage is full")
+{
+  MemoryStorage storage;
+  SampleQueue queue(&storage, 10);
+  queue.begin();
+
+  PushRange(queue, 1, SampleQueue::RamCapacity + 15);
+  REQUIRE(queue.GetSpilledCount() == 10);
+  REQUIRE(queue.GetDropped() == 5);
+}
+
+TEST_CASE("SampleQueue replays only the records acknowledged since the last persisted offset")
+{
+  MemoryStorage storage;
+  FakeBroker broker;
+  {
+    SampleQueue queue(&storage, 100);
+    queue.begin();
+    broker.isUp = false;
+    PushRange(queue, 1, SampleQueue::RamCapacity + 40);
+    broker.isUp = true;
+    //The RAM part and 20 spilled records get through before the reset
+    while (queue.GetSpilledCount() > 20)
+      broker.Replay(queue);
+  }
+  REQUIRE(storage.readOffsetWrites == 1);
+
+  SampleQueue queue(&storage, 100);
+  queue.begin();
+  REQUIRE(queue.GetSpilledCount() == 40 - SampleQueue::PersistEveryRecords);
+  broker.Drain(queue);
+  std::vector<uint32_t> expected = Range(1, SampleQueue::RamCapacity + 20);
+  std::vector<uint32_t> replayed = Range(SampleQueue::RamCapacity + SampleQueue::PersistEveryRecords + 1, SampleQueue::RamCapacity + 40);
+  expected.insert(expected.end(), replayed.begin(), replayed.end());
+  REQUIRE(broker.received == expected);
+}
+
+TEST_CASE("SampleQueue writes the read offset once per PersistEveryRecords records")
+{
+  MemoryStorage storage;
+  SampleQueue queue(&storage, 1000);
+  queue.begin();
+  FakeBroker broker;
+  PushRange(queue, 1, SampleQueue::RamCapacity + 100);
+  broker.Drain(queue);
+
+  REQUIRE(broker.received == Range(1, SampleQueue::RamCapacity + 100));
+  //The last batch clears the storage instead
+  REQUIRE(storage.readOffsetWrites == 100 / SampleQueue::PersistEveryRecords);
+  REQUIRE(storage.GetSize() == 0);
+}
+
+TEST_CASE("SampleQueue drops a partial record left by a reset")
+{
+  MemoryStorage storage;
+  {
+    SampleQueue queue(&storage, 100);
+    queue.begin();
+    PushRange(queue, 1, SampleQueue::RamCapacity + 3);
+  }
+  //Power lost in the middle of appending the next record
+  storage.bytes.insert(storage.bytes.end(), 7, 0x55);
+
+  SampleQueue queue(&storage, 100);
+  queue.begin();
+  REQUIRE(storage.GetSize() == 3 * SampleRecord::Size);
+  REQUIRE(queue.GetSpilledCount() == 3);
+  REQUIRE(queue.GetDropped() == 1);
+
+  //Records pushed after the reset stay aligned
+  PushRange(queue, 100, 101);
+  FakeBroker broker;
+  broker.Drain(queue);
+  std::vector<uint32_t> expected = Range(SampleQueue::RamCapacity + 1, SampleQueue::RamCapacity + 3);
+  expected.push_back(100);
+  expected.push_back(101);
+  REQUIRE(broker.received == expected);
+}
+
+TEST_CASE("SampleQueue skips records that do not decode")
+{
+  MemoryStorage storage;
+  SampleQueue queue(&storage, 100);
+  queue.begin();
+  FakeBroker broker;
+  broker.isUp = false;
+  PushRange(queue, 1, SampleQueue::RamCapacity + 10);
+  //Corrupt the version byte of the 1st and the length of the 5th spilled records
+  storage.bytes[0] = 0;
+  storage.bytes[4 * SampleRecord::Size + 3] = 0xff;
+
+  broker.isUp = true;
+  broker.Drain(queue);
+
+  std::vector<uint32_t> expected = Range(1, SampleQueue::RamCapacity);
+  for (uint32_t sequence = SampleQueue::RamCapacity + 2; sequence <= SampleQueue::RamCapacity + 10; ++sequence)
+  {
+    if (sequence != SampleQueue::RamCapacity + 5)
+      expected.push_back(sequence);
+  }
+  REQUIRE(broker.received == expected);
+  REQUIRE(queue.GetDropped() == 2);
+  REQUIRE(queue.GetCount() == 0);
+}
+
+TEST_CASE("SampleQueue ignores a read offset past the end of the spill")
+{
+  MemoryStorage storage;
+  {
+    SampleQueue queue(&storage, 100);
+    queue.begin();
+    PushRange(queue, 1, SampleQueue::RamCapacity + 2);
+  }
+  storage.readOffset = 10 * SampleRecord::Size;
+
+  SampleQueue queue(&storage, 100);
+  queue.begin();
+  REQUIRE(queue.GetSpilledCount() == 2);
+}
@@ -0,0 +1,129 @@
+#include "sample_record.h"
+
+#include <catch.hpp>
+#include <vector>
+
+//Catch takes the operands by reference, which needs a definition
+static constexpr size_t RecordSize = SampleRecord::Size;
+
+static SampleRecord MakeRecord(uint32_t sequence)
+{
+  SampleRecord record;
+  record.sequence = sequence;
+  record.timestamp = 1000 * sequence;
+  record.SetTemperature(21.5f);
+  record.SetHumidity(45);
+  record.SetPressure(748.3f);
+  return record;
+}
+
+static void Append(std::vector<uint8_t>& message, const SampleRecord& record)
+{
+  uint8_t buffer[SampleRecord::Size];
+  size_t length = EncodeSampleRecord(record, buffer, sizeof(buffer));
+  message.insert(message.end(), buffer, buffer + length);
+}
+
+TEST_CASE("SampleRecord round trips and carries its length")
+{
+  uint8_t buffer[SampleRecord::Size];
+  REQUIRE(EncodeSampleRecord(MakeRecord(7), buffer, sizeof(buffer)) == RecordSize);
+  REQUIRE(buffer[3] == RecordSize);
+
+  SampleRecord record;
+  REQUIRE(DecodeSampleRecord(buffer, sizeof(buffer), record));
+  REQUIRE(record.sequence == 7);
+  REQUIRE(record.timestamp == 7000);
+  REQUIRE(record.GetTemperature() == Approx(21.5f));
+  REQUIRE(record.GetHumidity() == Approx(45.0f));
+  REQUIRE(record.GetPressure() == Approx(748.3f));
+}
+
+TEST_CASE("SampleRecord decodes a record of the first senders without a length")
+{
+  uint8_t buffer[SampleRecord::Size];
+  EncodeSampleRecord(MakeRecord(7), buffer, sizeof(buffer));
+  buffer[3] = 0;
+
+  SampleRecord record;
+  REQUIRE(GetSampleRecordLength(buffer, sizeof(buffer)) == RecordSize);
+  REQUIRE(DecodeSampleRecord(buffer, sizeof(buffer), record));
+  REQUIRE(record.sequence == 7);
+}
+
+TEST_CASE("SampleRecord rejects a record that does not fit")
+{
+  uint8_t buffer[SampleRecord::Size + 4] = {};
+  EncodeSampleRecord(MakeRecord(7), buffer, sizeof(buffer));
+  SampleRecord record;
+
+  SECTION("truncated")
+  {
+    REQUIRE(GetSampleRecordLength(buffer, SampleRecord::Size - 1) == 0);
+    REQUIRE_FALSE(DecodeSampleRecord(buffer, SampleRecord::Size - 1, record));
+  }
+
+  SECTION("length shorter than the known fields")
+  {
+    buffer[3] = SampleRecord::Size - 1;
+    REQUIRE_FALSE(DecodeSampleRecord(buffer, sizeof(buffer), record));
+  }
+
+  SECTION("length past the end")
+  {
+    buffer[3] = SampleRecord::Size + 5;
+    REQUIRE_FALSE(DecodeSampleRecord(buffer, sizeof(buffer), record));
+  }
+
+  SECTION("version 0")
+  {
+    buffer[0] = 0;
+    REQUIRE_FALSE(DecodeSampleRecord(buffer, sizeof(buffer), record));
+  }
+}
+
+TEST_CASE("SampleRecord steps over the fields of a newer version")
+{
+  std::vector<uint8_t> message;
+  Append(message, MakeRecord(1));
+  //A newer record with four more bytes
+  Append(message, MakeRecord(2));
+  message[SampleRecord::Size] = SampleRecord::Version + 1;
+  message[SampleRecord::Size + 3] = SampleRecord::Size + 4;
+  message.insert(message.end(), 4, 0xee);
+  Append(message, MakeRecord(3));
+
+  SampleRecord record;
+  REQUIRE(GetSampleRecordLength(&message[SampleRecord::Size], message.size() - SampleRecord::Size) == SampleRecord::Size + 4);
+  REQUIRE(DecodeSampleRecord(&message[SampleRecord::Size], SampleRecord::Size + 4, record));
+  REQUIRE(record.sequence == 2);
+  REQUIRE(DecodeNewestSampleRecord(message.data(), message.size(), record));
+  REQUIRE(record.sequence == 3);
+}
+
+TEST_CASE("SampleRecord decodes the newest record of a message")
+{
+  std::vector<uint8_t> message;
+  SampleRecord record;
+
+  SECTION("empty")
+  {
+    REQUIRE_FALSE(DecodeNewestSampleRecord(message.data(), message.size(), record));
+  }
+
+  SECTION("several records")
+  {
+    for (uint32_t sequence = 1; sequence <= 4; ++sequence)
+      Append(message, MakeRecord(sequence));
+    REQUIRE(DecodeNewestSampleRecord(message.data(), message.size(), record));
+    REQUIRE(record.sequence == 4);
+  }
+
+  SECTION("trailing junk")
+  {
+    Append(message, MakeRecord(1));
+    message.insert(message.end(), 5, 0x55);
+    REQUIRE(DecodeNewestSampleRecord(message.data(), message.size(), record));
+    REQUIRE(record.sequence == 1);
+  }
+}
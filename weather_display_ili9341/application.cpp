@@ -5,9 +5,10 @@
 constexpr const char* Error PROGMEM = "Error reading config!";
 
 Application::Application()
-  : m_network(m_configuration, m_display, this, &m_remoteSensors)
-  , m_localSensors(m_configuration, m_display)
-  , m_remoteSensors(m_configuration, m_display)
+  : m_scheduler(millis)
+  , m_network(m_configuration, m_display, this, m_devices, m_asyncEvents, m_loopEvents)
+  , m_localSensors(m_configuration, m_display, m_scheduler)
+  , m_remoteSensors(m_configuration, m_display, m_scheduler, m_devices)
 {
 }
 
@@ -23,7 +24,8 @@ void Application::begin()
   m_network.begin();
   m_localSensors.begin();
   
-  if (m_network.IsWiFiAccessPointMode())
+  m_isAccessPointMode = m_network.IsWiFiAccessPointMode();
+  if (m_isAccessPointMode)
     return;
   m_remoteSensors.begin();
 }
@@ -31,13 +33,49 @@ void Application::begin()
 void Application::loop()
 {
   m_network.loop();
+  ProcessEvents();
 
   if (IsStopped())
     return;
-  m_localSensors.loop();
+  //The remote sensors are stopped once, when the network falls back to AP mode
+  if (!m_isAccessPointMode && m_network.IsWiFiAccessPointMode())
+  {
+    m_isAccessPointMode = true;
+    m_remoteSensors.end();
+  }
+  m_scheduler.loop();
+}
 
-  if (IsStopped() || m_network.IsWiFiAccessPointMode())
-    return;
-  m_remoteSensors.loop();
+
+void Application::ProcessEvents()
+{
+  Event event;
+  while (m_asyncEvents.Pop(event))
+    ProcessEvent(event);
+  while (m_loopEvents.Pop(event))
+    ProcessEvent(event);
 }
 
+void Application::ProcessEvent(const Event& event)
+{
+  switch (event.type)
+  {
+  case EventType::ConfigChange:
+    m_configuration.Set(event.config.field, event.config.value);
+    m_network.OnConfigChanged();
+    break;
+  case EventType::ConfigSave:
+    m_configuration.Write();
+    m_network.Restart();
+    break;
+  case EventType::SensorSample:
+    m_remoteSensors.OnSample(event.sample.device, event.sample.channel, event.sample.value);
+    break;
+  case EventType::SensorRecord:
+    m_remoteSensors.OnRecord(event.record.device, event.record.record);
+    break;
+  case EventType::OtaStart:
+    m_network.OnUpdateStarted();
+    break;
+  }
+}
@@ -5,6 +5,9 @@
 #include "display.h"
 #include "local_sensors.h"
 #include "remote_sensors.h"
+#include "scheduler.h"
+#include "events.h"
+#include "device_registry.h"
 
 class Application: public RunState
 {
@@ -15,12 +18,21 @@ public:
   void loop();
 
 private:
+  void ProcessEvents();
+  void ProcessEvent(const Event& event);
+
+private:
+  DeviceRegistry m_devices;
+  EventQueue m_asyncEvents;
+  EventQueue m_loopEvents;
+  Scheduler m_scheduler;
   Configuration m_configuration;
   Network m_network;
   Display m_display;
   LocalSensors m_localSensors;
   RemoteSensors m_remoteSensors;
   bool m_isRun = true;
+  bool m_isAccessPointMode = false;
 };
 
 
@@ -0,0 +1,66 @@
+#pragma once
+
+#include "events.h"
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+
+//Copy of the configuration strings for the web server context, which must not
+//read Configuration while the main loop changes it. The main loop is the only
+//writer. A reader retries while the sequence number is odd or has moved
+//(seqlock). The text is kept in atomic words, so the racing reads are well
+//defined, and their release/acquire orders replace the fences.
+class ConfigSnapshot
+{
+public:
+  static constexpr size_t FieldsCount = static_cast<size_t>(ConfigField::LcdLedBrightnessSetpoint) + 1;
+  static constexpr size_t ValueSize = ConfigChangeEvent::ValueSize;
+  using Values = char[FieldsCount][ValueSize];
+
+  //values are indexed by ConfigField, longer ones are truncated
+  void Store(const char* const* values)
+  {
+    Values text{};
+    for (size_t i = 0; i < FieldsCount; ++i)
+      strncpy(text[i], values[i], ValueSize - 1);
+
+    uint32_t sequence = m_sequence.load(std::memory_order_relaxed);
+    m_sequence.store(sequence + 1, std::memory_order_relaxed);
+    //a reader that sees any of these words also sees the odd sequence
+    for (size_t i = 0; i < WordsCount; ++i)
+    {
+      uint32_t word;
+      memcpy(&word, &text[0][0] + i * sizeof(word), sizeof(word));
+      m_words[i].store(word, std::memory_order_release);
+    }
+    m_sequence.store(sequence + 2, std::memory_order_release);
+  }
+
+  //Returns false if every attempt overlapped a Store()
+  bool Load(Values& values, size_t attempts = 4) const
+  {
+    for (size_t attempt = 0; attempt < attempts; ++attempt)
+    {
+      uint32_t sequence = m_sequence.load(std::memory_order_acquire);
+      if (sequence & 1)
+        continue;
+      for (size_t i = 0; i < WordsCount; ++i)
+      {
+        uint32_t word = m_words[i].load(std::memory_order_acquire);
+        memcpy(&values[0][0] + i * sizeof(word), &word, sizeof(word));
+      }
+      if (m_sequence.load(std::memory_order_relaxed) == sequence)
+        return true;
+    }
+    return false;
+  }
+
+private:
+  static constexpr size_t WordsCount = sizeof(Values) / sizeof(uint32_t);
+  static_assert(sizeof(Values) % sizeof(uint32_t) == 0, "Values must be made of whole words");
+
+  std::atomic<uint32_t> m_sequence{0};
+  std::atomic<uint32_t> m_words[WordsCount]{};
+};
@@ -21,6 +21,61 @@ constexpr const char* ApiLocation PROGMEM = "ApiLocation";
 constexpr const char* LcdLedBrightnessSetpoint PROGMEM = "LcdLedBrightnessSetpoint";
 }
 
+//The file is decoded straight into fixed size fields, without building a JsonObject.
+//Each field has room for one char more than the longest accepted value, so a value
+//that fills it was too long and is skipped.
+struct ConfigFile
+{
+  char apName[32 + 2];
+  char passw[ConfigChangeEvent::ValueSize + 1];
+  char mqttServer[ConfigChangeEvent::ValueSize + 1];
+  char mqttPort[5 + 2];
+  char apiLocation[ConfigChangeEvent::ValueSize + 1];
+  char lcdLedBrightnessSetpoint[5 + 2];
+};
+
+const JsonField ConfigFileFields[] =
+{
+  JSON_FIELD(ConfigFile, apName, keys::ApName),
+  JSON_FIELD(ConfigFile, passw, keys::Passw),
+  JSON_FIELD(ConfigFile, mqttServer, keys::MqttServer),
+  JSON_FIELD(ConfigFile, mqttPort, keys::MqttPort),
+  JSON_FIELD(ConfigFile, apiLocation, keys::ApiLocation),
+  JSON_FIELD(ConfigFile, lcdLedBrightnessSetpoint, keys::LcdLedBrightnessSetpoint),
+};
+
+constexpr size_t Length(const char* text)
+{
+  return *text ? 1 + Length(text + 1) : 0;
+}
+
+constexpr size_t Max(size_t a, size_t b)
+{
+  return a > b ? a : b;
+}
+
+constexpr size_t LongestField = Max(Max(Max(sizeof(ConfigFile::apName), sizeof(ConfigFile::passw)),
+  Max(sizeof(ConfigFile::mqttServer), sizeof(ConfigFile::mqttPort))),
+  Max(sizeof(ConfigFile::apiLocation), sizeof(ConfigFile::lcdLedBrightnessSetpoint)));
+
+constexpr size_t LongestKey = Max(Max(Max(Length(keys::ApName), Length(keys::Passw)),
+  Max(Length(keys::MqttServer), Length(keys::MqttPort))),
+  Max(Length(keys::ApiLocation), Length(keys::LcdLedBrightnessSetpoint)));
+
+//The parser keeps one key or value at a time in the buffer. The extra room lets
+//a value longer than its field be parsed and skipped instead of failing the file.
+constexpr size_t ConfigBufferSize = LongestField + LongestKey + 1;
+
+//A value that fills its field was too long, it keeps the current setting
+template <size_t N>
+bool Apply(Configuration& configuration, ConfigField field, const char (&value)[N])
+{
+  if (strlen(value) == N - 1)
+    return false;
+  configuration.Set(field, value);
+  return true;
+}
+
 Configuration::Configuration()
   : m_mqttServer(DefaultMqttServer)
   , m_mqttPortStr(DefaultMqttPort)
@@ -41,23 +96,23 @@ bool Configuration::Read()
   if (!configFile) 
     return false;
 
-  size_t size = configFile.size();
-  std::unique_ptr<char[]> buf(new char[size]);
-
-  configFile.readBytes(buf.get(), size);
-  DynamicJsonBuffer jsonBuffer;
-  JsonObject& json = jsonBuffer.parseObject(buf.get());
-
-  if (!json.success()) 
+  //Missing keys are read as empty strings
+  ConfigFile config{};
+  JsonStructReader reader(&config, ConfigFileFields);
+  StaticJsonBuffer<ConfigBufferSize> jsonBuffer;
+  bool ok = jsonBuffer.parseEvents(configFile, reader);
+  configFile.close();
+  if (!ok)
     return false;
 
-  SetApName(static_cast<const char*>(json[keys::ApName]));
-  SetPassw(static_cast<const char*>(json[keys::Passw]));
-  SetMqttServer(static_cast<const char*>(json[keys::MqttServer]));
-  SetMqttPortStr(static_cast<const char*>(json[keys::MqttPort]));
-  SetApiLocation(static_cast<const char*>(json[keys::ApiLocation]));
-  SetLcdLedBrightnessSetpointStr(static_cast<const char*>(json[keys::LcdLedBrightnessSetpoint]));
-  return true;
+  //Every field is applied, so a skipped one does not lose the others
+  bool complete = Apply(*this, ConfigField::ApName, config.apName);
+  complete = Apply(*this, ConfigField::Passw, config.passw) && complete;
+  complete = Apply(*this, ConfigField::MqttServer, config.mqttServer) && complete;
+  complete = Apply(*this, ConfigField::MqttPort, config.mqttPort) && complete;
+  complete = Apply(*this, ConfigField::ApiLocation, config.apiLocation) && complete;
+  complete = Apply(*this, ConfigField::LcdLedBrightnessSetpoint, config.lcdLedBrightnessSetpoint) && complete;
+  return complete;
 }
 
 bool Configuration::Write()
@@ -75,9 +130,56 @@ bool Configuration::Write()
   if (!configFile)
     return false;
 
-  json.printTo(configFile);
+  //One SPIFFS write per block instead of one per char
+  char block[128];
+  bool ok = json.printTo(configFile, block) != 0;
   configFile.close();
-  return true;
+  return ok;
 }
 
 
+
+void Configuration::Set(ConfigField field, const char* text)
+{
+  switch (field)
+  {
+  case ConfigField::ApName:
+    SetApName(text);
+    break;
+  case ConfigField::Passw:
+    SetPassw(text);
+    break;
+  case ConfigField::MqttServer:
+    SetMqttServer(text);
+    break;
+  case ConfigField::MqttPort:
+    SetMqttPortStr(text);
+    break;
+  case ConfigField::ApiLocation:
+    SetApiLocation(text);
+    break;
+  case ConfigField::LcdLedBrightnessSetpoint:
+    SetLcdLedBrightnessSetpointStr(text);
+    break;
+  }
+}
+
+const char* Configuration::Get(ConfigField field) const
+{
+  switch (field)
+  {
+  case ConfigField::ApName:
+    return GetApName();
+  case ConfigField::Passw:
+    return GetPassw();
+  case ConfigField::MqttServer:
+    return GetMqttServer();
+  case ConfigField::MqttPort:
+    return GetMqttPortStr();
+  case ConfigField::ApiLocation:
+    return GetApiLocation();
+  case ConfigField::LcdLedBrightnessSetpoint:
+    return GetLcdLedBrightnessSetpointStr();
+  }
+  return "";
+}
@@ -1,5 +1,7 @@
 #pragma once
 
+#include "events.h"
+
 #include <Arduino.h>
 
 #include <pgmspace.h>
@@ -11,6 +13,8 @@ public:
 
   bool Read();
   bool Write();
+  void Set(ConfigField field, const char* text);
+  const char* Get(ConfigField field) const;
 
   const char* GetApName() const { return m_apName.c_str(); }
   void SetApName(const char* text) { m_apName = text; }
@@ -4,8 +4,6 @@
 
 constexpr const char *prefix PROGMEM = "unit1";
 constexpr const char *deviceId PROGMEM = "unit1_device2";
-constexpr const char *Device1Sensor1 PROGMEM = "unit1/device1/sensor1/status";
-constexpr const char *Device1Sensor2 PROGMEM = "unit1/device1/sensor2/status";
-constexpr const char *Device1Sensor3 PROGMEM = "unit1/device1/sensor3/status";
-constexpr const char *Device1Error PROGMEM = "unit1/device1/error/status";
+constexpr const char *SensorsStatus PROGMEM = "unit1/+/+/status";
+constexpr const char *SensorsSample PROGMEM = "unit1/+/sample";
 constexpr const char *Device1Hello PROGMEM = "unit1/device1/hello/status";
@@ -0,0 +1,6 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+uint32_t Crc32(const uint8_t* data, size_t length, uint32_t crc = 0);
@@ -0,0 +1,96 @@
+#include "device_registry.h"
+#include "topic_router.h"
+
+#include <cstring>
+
+constexpr uint32_t HashSeed = 2166136261u;
+constexpr const char* SensorLevel = "sensor";
+constexpr const char* ErrorLevel = "error";
+
+DeviceRegistry::DeviceRegistry()
+{
+  memset(m_buckets, NotFound, sizeof(m_buckets));
+}
+
+size_t DeviceRegistry::GetBucket(const char* name, size_t length)
+{
+  return TopicRouter::Hash(name, length, HashSeed) & (BucketsCount - 1);
+}
+
+uint8_t DeviceRegistry::Find(const char* name, size_t length) const
+{
+  size_t bucket = GetBucket(name, length);
+  for (size_t probe = 0; probe < BucketsCount; ++probe)
+  {
+    uint8_t index = m_buckets[bucket];
+    if (index == NotFound)
+      return NotFound;
+    if (strncmp(m_names[index], name, length) == 0 && m_names[index][length] == 0)
+      return index;
+    bucket = (bucket + 1) & (BucketsCount - 1);
+  }
+  return NotFound;
+}
+
+uint8_t DeviceRegistry::Add(const char* name, size_t length)
+{
+  uint8_t index = Find(name, length);
+  if (index != NotFound)
+    return index;
+  if (m_count == MaxDevices || length == 0 || length > MaxNameLength)
+    return NotFound;
+
+  index = m_count++;
+  memcpy(m_names[index], name, length);
+  m_names[index][length] = 0;
+  //Half the buckets stay empty, so the probe always ends
+  size_t bucket = GetBucket(name, length);
+  while (m_buckets[bucket] != NotFound)
+    bucket = (bucket + 1) & (BucketsCount - 1);
+  m_buckets[bucket] = index;
+  return index;
+}
+
+bool DeviceRegistry::ParseDeviceTopic(const char* topic, uint8_t& device)
+{
+  //<prefix>/<device>/...
+  const char* deviceLevel = strchr(topic, '/');
+  if (!deviceLevel)
+    return false;
+  ++deviceLevel;
+  const char* deviceEnd = strchr(deviceLevel, '/');
+  if (!deviceEnd)
+    return false;
+
+  device = Add(deviceLevel, deviceEnd - deviceLevel);
+  return device != NotFound;
+}
+
+bool DeviceRegistry::ParseStatusTopic(const char* topic, uint8_t& device, SensorChannel& channel)
+{
+  //<prefix>/<device>/<sensor>/status
+  const char* deviceLevel = strchr(topic, '/');
+  if (!deviceLevel)
+    return false;
+  ++deviceLevel;
+  const char* sensorLevel = strchr(deviceLevel, '/');
+  if (!sensorLevel)
+    return false;
+  ++sensorLevel;
+  const char* sensorEnd = strchr(sensorLevel, '/');
+  if (!sensorEnd)
+    return false;
+
+  size_t sensorLength = sensorEnd - sensorLevel;
+  const size_t sensorPrefixLength = strlen(SensorLevel);
+  if (sensorLength == sensorPrefixLength + 1 && strncmp(sensorLevel, SensorLevel, sensorPrefixLength) == 0 &&
+      sensorLevel[sensorPrefixLength] >= '1' && sensorLevel[sensorPrefixLength] <= '3')
+    channel = static_cast<SensorChannel>(sensorLevel[sensorPrefixLength] - '1');
+  else if (sensorLength == strlen(ErrorLevel) && strncmp(sensorLevel, ErrorLevel, sensorLength) == 0)
+    channel = SensorChannel::Error;
+  else
+    return false;
+
+  device = Add(deviceLevel, sensorLevel - 1 - deviceLevel);
+  return device != NotFound;
+}
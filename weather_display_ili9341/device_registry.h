@@ -0,0 +1,38 @@
+#pragma once
+
+#include "events.h"
+
+#include <cstddef>
+#include <cstdint>
+
+//Outer sensor devices, discovered from the topics of the wildcard
+//subscriptions in the order they first report
+class DeviceRegistry
+{
+public:
+  static constexpr size_t MaxDevices = 4;
+  static constexpr size_t MaxNameLength = 15;
+  static constexpr uint8_t NotFound = 0xff;
+
+  DeviceRegistry();
+
+  size_t GetCount() const { return m_count; }
+  const char* GetName(size_t index) const { return m_names[index]; }
+
+  uint8_t Find(const char* name, size_t length) const;
+  //Returns NotFound once the registry is full or for an overlong name
+  uint8_t Add(const char* name, size_t length);
+
+  //An unknown device in a well formed topic is added
+  bool ParseDeviceTopic(const char* topic, uint8_t& device);
+  bool ParseStatusTopic(const char* topic, uint8_t& device, SensorChannel& channel);
+
+private:
+  static constexpr size_t BucketsCount = 2 * MaxDevices;
+
+  static size_t GetBucket(const char* name, size_t length);
+
+  char m_names[MaxDevices][MaxNameLength + 1]{};
+  size_t m_count = 0;
+  uint8_t m_buckets[BucketsCount];
+};
@@ -79,6 +79,11 @@ void Display::DrawArrow(float value, float valueR, int x, int y)
     DrawStable(m_tft, x, y);
 }
 
+void Display::ClearArrow(int x, int y)
+{
+  DrawStable(m_tft, x, y);
+}
+
 int CalcY(float value, float valueMin, float valueMax)
 {
   double yPos = ChartBottom - (ChartBottom - ChartTop) / (valueMax - valueMin) * (value - valueMin);
@@ -105,6 +110,13 @@ void Display::DrawChart(float valueMin, float valueMax, const History& history,
   m_tft.setColor(VGA_WHITE);
 }
 
+void Display::ClearChart()
+{
+  m_tft.setColor(BackColor);
+  m_tft.fillRect(ChartLeft, ChartTop, ChartRight, ChartBottom);
+  m_tft.setColor(VGA_WHITE);
+}
+
 void Display::DrawNumber(float number, int x, int y, bool withPlus, int precision)
 {
   String text(number, precision);
@@ -116,6 +128,25 @@ void Display::DrawNumber(float number, int x, int y, bool withPlus, int precisio
   m_tft.print(text.c_str(), x, y);
 }
 
+void Display::DrawText(const char* text, int x, int y)
+{
+  m_tft.print(text, x, y);
+}
+
+//Pads the text with spaces up to width characters, so a shorter text
+//overwrites a longer one printed before at the same place
+void Display::DrawField(const char* text, int x, int y, size_t width)
+{
+  char field[32];
+  if (width >= sizeof(field))
+    width = sizeof(field) - 1;
+  size_t length = strnlen(text, width);
+  memcpy(field, text, length);
+  memset(field + length, ' ', width - length);
+  field[width] = '\0';
+  m_tft.print(field, x, y);
+}
+
 void Display::PrintError(const char* msg, word color)
 {
   SetSmallFont();
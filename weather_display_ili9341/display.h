@@ -12,13 +12,17 @@ public:
   void begin();
 
   void DrawNumber(float number, int x, int y, bool withPlus, int precision = 0);
+  void DrawText(const char* text, int x, int y);
+  void DrawField(const char* text, int x, int y, size_t width);
   void DrawArrow(float value, float valueR, int x, int y);
+  void ClearArrow(int x, int y);
   void PrintError(const char* msg, word color = VGA_RED);
   void SetSmallFont();
   void SetBigFont();
   void PrintLastUpdated(int x, int y, uint32_t deltaTime);
   void DrawWind(float windDir, int x, int y);
   void DrawChart(float valueMin, float valueMax, const History& history, int historyIndex);
+  void ClearChart();
   void TurnLcdLedOnOff(bool onOff);
 
 private:
@@ -0,0 +1,119 @@
+#pragma once
+
+#include "spsc_queue.h"
+#include "sample_record.h"
+
+#include <cstdint>
+#include <cstring>
+
+enum class ConfigField : uint8_t
+{
+  ApName,
+  Passw,
+  MqttServer,
+  MqttPort,
+  ApiLocation,
+  LcdLedBrightnessSetpoint
+};
+
+enum class SensorChannel : uint8_t
+{
+  Temperature,
+  Humidity,
+  Pressure,
+  Error,
+  Count
+};
+
+enum class EventType : uint8_t
+{
+  ConfigChange,
+  ConfigSave,
+  SensorSample,
+  SensorRecord,
+  OtaStart
+};
+
+struct ConfigChangeEvent
+{
+  static constexpr size_t ValueSize = 64;
+
+  ConfigField field;
+  char value[ValueSize];
+};
+
+struct SensorSampleEvent
+{
+  uint8_t device;
+  SensorChannel channel;
+  float value;
+};
+
+struct SensorRecordEvent
+{
+  uint8_t device;
+  SampleRecord record;
+};
+
+struct Event
+{
+  EventType type;
+  union
+  {
+    ConfigChangeEvent config;
+    SensorSampleEvent sample;
+    SensorRecordEvent record;
+  };
+
+  //SampleRecord has default member values, so the union has no implicit
+  //default constructor
+  Event()
+    : type(EventType::ConfigChange)
+    , config()
+  {
+  }
+
+  static Event MakeConfigChange(ConfigField field, const char* value)
+  {
+    Event event{};
+    event.type = EventType::ConfigChange;
+    event.config.field = field;
+    strncpy(event.config.value, value, ConfigChangeEvent::ValueSize - 1);
+    return event;
+  }
+
+  static Event MakeConfigSave()
+  {
+    Event event{};
+    event.type = EventType::ConfigSave;
+    return event;
+  }
+
+  static Event MakeSensorSample(uint8_t device, SensorChannel channel, float value)
+  {
+    Event event{};
+    event.type = EventType::SensorSample;
+    event.sample.device = device;
+    event.sample.channel = channel;
+    event.sample.value = value;
+    return event;
+  }
+
+  static Event MakeSensorRecord(uint8_t device, const SampleRecord& record)
+  {
+    Event event{};
+    event.type = EventType::SensorRecord;
+    event.record.device = device;
+    event.record.record = record;
+    return event;
+  }
+
+  static Event MakeOtaStart()
+  {
+    Event event{};
+    event.type = EventType::OtaStart;
+    return event;
+  }
+};
+
+using EventQueue = SpscQueue<Event, 16>;
@@ -2,6 +2,7 @@
 #include "configuration.h"
 #include "display.h"
 #include "consts.h"
+#include "device_registry.h"
 #include "pass.h"
 
 #include <ArduinoOTA.h>
@@ -14,6 +15,10 @@ constexpr const char* Connecting PROGMEM ="Connecting to Wi-Fi...";
 constexpr const char* ConnectedStr PROGMEM ="IP: ";
 constexpr const char* UpdatingFirmwareStr PROGMEM ="Updating firmware...";
 constexpr const char* WiFiConnectionError PROGMEM = "WiFi connection error!";
+constexpr const char* ConnectTimeStr PROGMEM = " ms";
+constexpr uint32_t WiFiJoinRtcOffset PROGMEM = 0;
+constexpr uint32_t FastJoinTimeoutMs PROGMEM = 3000;
+constexpr uint32_t WiFiConnectTimeoutMs PROGMEM = 15000;
 
 namespace web
 {
@@ -83,24 +88,61 @@ constexpr const char* pathRoot PROGMEM = "/";
 constexpr const char* pathHeap PROGMEM = "/heap";
 constexpr const char* pathSave PROGMEM = "/save";
 constexpr const char* PageNotFound PROGMEM = "Page Not Found!\n\n";
+constexpr const char* PageBusy PROGMEM = "Busy, try again.\n";
 constexpr const char* PageSaved PROGMEM = "<p>Saved.</p>\n<p>Trying to connect to Wi-Fi network...</p>\n";
 }
 
 constexpr uint8_t DNS_PORT PROGMEM = 53;
-  
-static bool UpdateStarted = false;
+
+const TopicRouter::Route Network::MqttRoutes[] =
+{
+  {SensorsStatus, &Network::OnMqttSensorStatus, 0},
+  {SensorsSample, &Network::OnMqttSensorSample, 0},
+};
+
+void Network::OnMqttSensorStatus(void* context, uint8_t, const char* topic, const uint8_t* payload, uint32_t length)
+{
+  auto* network = static_cast<Network*>(context);
+  uint8_t device = DeviceRegistry::NotFound;
+  SensorChannel channel = SensorChannel::Count;
+  float value = NAN;
+  if (network->m_devices.ParseStatusTopic(topic, device, channel) && ParsePayloadFloat(payload, length, value))
+    network->m_loopEvents.Push(Event::MakeSensorSample(device, channel, value));
+}
+
+void Network::OnMqttSensorSample(void* context, uint8_t, const char* topic, const uint8_t* payload, uint32_t length)
+{
+  auto* network = static_cast<Network*>(context);
+  uint8_t device = DeviceRegistry::NotFound;
+  if (!network->m_devices.ParseDeviceTopic(topic, device))
+    return;
+  //A replayed backlog is history, only the newest record is the current value
+  SampleRecord record;
+  if (DecodeNewestSampleRecord(payload, length, record) && !(record.flags & SampleRecord::Backlog))
+    network->m_loopEvents.Push(Event::MakeSensorRecord(device, record));
+}
 
 void Network::OnMqttMessageArrived(char* topic, uint8_t* payload, unsigned int length)
 {
-  m_mqttConsumer->OnDataArrived(topic, payload, length);
+  m_topicRouter.Dispatch(topic, payload, length);
 }
 
-Network::Network(Configuration& configuration, Display& display, RunState* runState, IMqttConsumer* mqttConsumer)
+//The display never deep sleeps, the cached lease is aged within one boot
+uint32_t GetUptimeSec()
+{
+  return millis() / 1000;
+}
+
+Network::Network(Configuration& configuration, Display& display, RunState* runState, DeviceRegistry& devices, EventQueue& asyncEvents, EventQueue& loopEvents)
   : m_configuration(configuration)
   , m_display(display)
   , m_runState(runState)
-  , m_mqttConsumer(mqttConsumer)
+  , m_devices(devices)
+  , m_asyncEvents(asyncEvents)
+  , m_loopEvents(loopEvents)
+  , m_topicRouter(MqttRoutes, sizeof(MqttRoutes) / sizeof(MqttRoutes[0]), this)
   , m_mqttClient(m_wifiClient)
+  , m_wifiJoin(WiFiJoinRtcOffset, GetUptimeSec)
   , m_webServer(80)
 {
 }
@@ -111,6 +153,7 @@ Network::~Network()
 
 void Network::begin()
 {
+  OnConfigChanged();
   Connect();
 
   m_mqttClient.setServer(m_configuration.GetMqttServer(), m_configuration.GetMqttPort());
@@ -134,12 +177,6 @@ void Network::loop()
   if (!Connected())
     Connect();
   ArduinoOTA.handle();
-  if (UpdateStarted)
-  {
-    UpdateStarted = false;
-    m_runState->Pause();
-    m_display.PrintError(UpdatingFirmwareStr, VGA_LIME);
-  }
 
   if (m_runState->IsStopped())
     return;
@@ -167,6 +204,26 @@ void Network::loop()
   }
 }
 
+void Network::Restart()
+{
+  m_isReset = true;
+}
+
+void Network::OnUpdateStarted()
+{
+  m_runState->Pause();
+  m_display.PrintError(UpdatingFirmwareStr, VGA_LIME);
+}
+
+//Called by the main loop each time the configuration changes
+void Network::OnConfigChanged()
+{
+  const char* values[ConfigSnapshot::FieldsCount];
+  for (size_t i = 0; i < ConfigSnapshot::FieldsCount; ++i)
+    values[i] = m_configuration.Get(static_cast<ConfigField>(i));
+  m_configSnapshot.Store(values);
+}
+
 bool Network::Connected()
 {
   return (m_wifiMode == WiFiMode::AccessPointMode ? true : WiFi.waitForConnectResult() == WL_CONNECTED);
@@ -176,15 +233,15 @@ bool Network::Connected()
 Network::WiFiMode Network::ConnectToWiFi()
 {
   m_display.PrintError(Connecting, VGA_LIME);
-  WiFi.disconnect(true);
   WiFi.enableAP(false);
-  WiFi.mode(WIFI_STA);
 
-  WiFi.begin(m_configuration.GetApName(), m_configuration.GetPassw());
   String s = ConnectedStr;
-  if (Connected())
+  if (m_wifiJoin.Connect(m_configuration.GetApName(), m_configuration.GetPassw(), FastJoinTimeoutMs, WiFiConnectTimeoutMs))
   {
     s += WiFi.localIP().toString();
+    s += ' ';
+    s += m_wifiJoin.GetTimeToConnectMs();
+    s += ConnectTimeStr;
     m_display.PrintError(s.c_str(), VGA_LIME);
     m_wifiMode = WiFiMode::ClientMode;
     return m_wifiMode;
@@ -214,7 +271,7 @@ void Network::Connect()
   ArduinoOTA.setHostname(HostName);
   
   ArduinoOTA.onStart([this](){
-    UpdateStarted = true;
+    m_loopEvents.Push(Event::MakeOtaStart());
   });
   ArduinoOTA.begin();
 }
@@ -222,23 +279,29 @@ void Network::Connect()
 bool Network::MqttConnect()
 {
   if (!m_mqttClient.connect(deviceId) ||
-      !m_mqttClient.subscribe(Device1Sensor1) || 
-      !m_mqttClient.subscribe(Device1Sensor2) ||
-      !m_mqttClient.subscribe(Device1Sensor3) ||
-      !m_mqttClient.subscribe(Device1Error))
+      !m_mqttClient.subscribe(SensorsStatus) ||
+      !m_mqttClient.subscribe(SensorsSample))
     return false;
   return m_mqttClient.connected();
 }
 
+//Runs in the web server context: reads the snapshot, never Configuration
 void Network::SetWebIsRoot(AsyncWebServerRequest* request)
 {
+  if (!m_configSnapshot.Load(m_webConfigValues))
+  {
+    request->send(503, web::text_plain, web::PageBusy);
+    return;
+  }
+  auto value = [this](ConfigField field) { return m_webConfigValues[static_cast<size_t>(field)]; };
+
   String s(web::HtmlPostForm);
-  s.replace(String(web::percent) + web::ap_name + String(web::percent), m_configuration.GetApName());
-  s.replace(String(web::percent) + web::passw + String(web::percent), m_configuration.GetPassw());
-  s.replace(String(web::percent) + web::mqtt_server + String(web::percent), m_configuration.GetMqttServer());
-  s.replace(String(web::percent) + web::mqtt_port + String(web::percent), m_configuration.GetMqttPortStr());
-  s.replace(String(web::percent) + web::location + String(web::percent), m_configuration.GetApiLocation());
-  s.replace(String(web::percent) + web::lcd_led_brightness_setpoint + String(web::percent), m_configuration.GetLcdLedBrightnessSetpointStr());
+  s.replace(String(web::percent) + web::ap_name + String(web::percent), value(ConfigField::ApName));
+  s.replace(String(web::percent) + web::passw + String(web::percent), value(ConfigField::Passw));
+  s.replace(String(web::percent) + web::mqtt_server + String(web::percent), value(ConfigField::MqttServer));
+  s.replace(String(web::percent) + web::mqtt_port + String(web::percent), value(ConfigField::MqttPort));
+  s.replace(String(web::percent) + web::location + String(web::percent), value(ConfigField::ApiLocation));
+  s.replace(String(web::percent) + web::lcd_led_brightness_setpoint + String(web::percent), value(ConfigField::LcdLedBrightnessSetpoint));
   request->send(200, web::text_html, String(web::HtmlHeader) + s + String(web::HtmlFooter));
 }
 
@@ -250,20 +313,19 @@ void Network::SetWebIsNotFound(AsyncWebServerRequest *request)
 void Network::SetWebIsSave(AsyncWebServerRequest *request)
 {
   if (request->hasArg(web::ap_name))
-    m_configuration.SetApName(request->arg(web::ap_name));
+    m_asyncEvents.Push(Event::MakeConfigChange(ConfigField::ApName, request->arg(web::ap_name).c_str()));
   if (request->hasArg(web::passw))
-    m_configuration.SetPassw(request->arg(web::passw));
+    m_asyncEvents.Push(Event::MakeConfigChange(ConfigField::Passw, request->arg(web::passw).c_str()));
   if (request->hasArg(web::mqtt_server))
-    m_configuration.SetMqttServer(request->arg(web::mqtt_server));
+    m_asyncEvents.Push(Event::MakeConfigChange(ConfigField::MqttServer, request->arg(web::mqtt_server).c_str()));
   if (request->hasArg(web::mqtt_port))
-    m_configuration.SetMqttPortStr(request->arg(web::mqtt_port));
+    m_asyncEvents.Push(Event::MakeConfigChange(ConfigField::MqttPort, request->arg(web::mqtt_port).c_str()));
   if (request->hasArg(web::location))
-    m_configuration.SetApiLocation(request->arg(web::location));
+    m_asyncEvents.Push(Event::MakeConfigChange(ConfigField::ApiLocation, request->arg(web::location).c_str()));
   if (request->hasArg(web::lcd_led_brightness_setpoint))
-    m_configuration.SetLcdLedBrightnessSetpointStr(request->arg(web::lcd_led_brightness_setpoint));
+    m_asyncEvents.Push(Event::MakeConfigChange(ConfigField::LcdLedBrightnessSetpoint, request->arg(web::lcd_led_brightness_setpoint).c_str()));
+  m_asyncEvents.Push(Event::MakeConfigSave());
 
-  m_configuration.Write();
-  m_isReset = true;
   request->send(200, web::text_html, String(web::HtmlHeader) + web::PageSaved + String(web::HtmlFooter));
 }
 
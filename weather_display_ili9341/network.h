@@ -1,6 +1,10 @@
 #pragma once
 
 #include "run_state.h"
+#include "config_snapshot.h"
+#include "events.h"
+#include "topic_router.h"
+#include "wifi_join.h"
 
 #include <ESP8266WiFi.h>
 
@@ -16,22 +20,20 @@
 class Configuration;
 class Display;
 class DNSServer;
-
-class IMqttConsumer
-{
-public:
-  virtual void OnDataArrived(const char* topic, const uint8_t* payload, uint32_t length) = 0;
-};
+class DeviceRegistry;
 
 class Network
 {
 public:
-  Network(Configuration& configuration, Display& display, RunState* runState, IMqttConsumer* mqttConsumer);
+  Network(Configuration& configuration, Display& display, RunState* runState, DeviceRegistry& devices, EventQueue& asyncEvents, EventQueue& loopEvents);
   ~Network();
 
   void begin();
   void loop();
   bool Connected();
+  void Restart();
+  void OnUpdateStarted();
+  void OnConfigChanged();
 
 public:
   enum class WiFiMode
@@ -41,32 +43,45 @@ public:
   };
 
 public:
-  bool IsWiFiAccessPointMode() const { m_wifiMode == WiFiMode::AccessPointMode; }
+  bool IsWiFiAccessPointMode() const { return m_wifiMode == WiFiMode::AccessPointMode; }
+  uint32_t GetTimeToConnectMs() const { return m_wifiJoin.GetTimeToConnectMs(); }
   
 private:
   WiFiMode ConnectToWiFi();
   void Connect();
   bool MqttConnect();
   void OnMqttMessageArrived(char* topic, uint8_t* payload, unsigned int length);
+  static void OnMqttSensorStatus(void* context, uint8_t id, const char* topic, const uint8_t* payload, uint32_t length);
+  static void OnMqttSensorSample(void* context, uint8_t id, const char* topic, const uint8_t* payload, uint32_t length);
 
   void SetWebIsRoot(AsyncWebServerRequest* request);
   void SetWebIsNotFound(AsyncWebServerRequest* request);
   void SetWebIsSave(AsyncWebServerRequest* request);
 
 private:
+  static const TopicRouter::Route MqttRoutes[];
+
   Configuration& m_configuration;
   Display& m_display;
   RunState* m_runState;
-  IMqttConsumer* m_mqttConsumer;
+  DeviceRegistry& m_devices;
+  EventQueue& m_asyncEvents;
+  EventQueue& m_loopEvents;
+  TopicRouter m_topicRouter;
   
   WiFiClient m_wifiClient;
   PubSubClient m_mqttClient;
+  WiFiJoin m_wifiJoin;
 
   WiFiMode m_wifiMode = WiFiMode::ClientMode;
 
   AsyncWebServer m_webServer;
   bool m_isReset = false;
 
+  ConfigSnapshot m_configSnapshot;
+  //Only used by the web server context
+  ConfigSnapshot::Values m_webConfigValues{};
+
   std::unique_ptr<DNSServer> m_dnsServer;
 };
 
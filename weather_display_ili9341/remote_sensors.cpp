@@ -15,8 +15,22 @@ constexpr const char *ApiOpenWeatherMapOrgForecast2 PROGMEM = "&units=metric&cnt
 constexpr const char *ApiOpenWeatherMapOrgCurrent1 PROGMEM = "/data/2.5/weather?q=";
 constexpr const char *ApiOpenWeatherMapOrgCurrent2 PROGMEM = "&units=metric&APPID=";
 
+constexpr const char *HeaderDate PROGMEM = "Date";
+constexpr const char *HeaderETag PROGMEM = "ETag";
+constexpr const char *HeaderLastModified PROGMEM = "Last-Modified";
+constexpr const char *HeaderCacheControl PROGMEM = "Cache-Control";
+constexpr const char *HeaderIfNoneMatch PROGMEM = "If-None-Match";
+constexpr const char *HeaderIfModifiedSince PROGMEM = "If-Modified-Since";
+
 constexpr uint32_t historyTimeStep PROGMEM = 12*60*60*1000 / HistoryDepth;
 
+constexpr const char *NoValue PROGMEM = "--";
+constexpr const char *SensorError PROGMEM = "Sensor error";
+constexpr size_t DeviceNameWidth PROGMEM = 8;
+constexpr size_t TemperatureWidth PROGMEM = 4;
+constexpr size_t HumidityWidth PROGMEM = 3;
+constexpr size_t PressureWidth PROGMEM = 3;
+
 namespace keys
 {
   constexpr const char * List PROGMEM = "list";
@@ -30,83 +44,133 @@ namespace keys
   constexpr const char * Wind PROGMEM = "wind";
   constexpr const char * Speed PROGMEM = "speed";
   constexpr const char * Deg PROGMEM = "deg";
+  constexpr const char * Dt PROGMEM = "dt";
 }
 
-RemoteSensors::RemoteSensors(Configuration& configuration, Display& display)
+RemoteSensors::RemoteSensors(Configuration& configuration, Display& display, Scheduler& scheduler, const DeviceRegistry& devices)
   : m_configuration(configuration)
   , m_display(display)
-  , m_timerForReadOuterSensors(1000, TimerState::Stopped)
-  , m_timerForReadForecast(15*60*1000, TimerState::Started)
-  , m_timerForReadCurrentWeather(60*1000, TimerState::Started)
+  , m_scheduler(scheduler)
+  , m_devices(devices)
+  , m_taskUpdateOuterSensors([this](){ UpdateOuterSensors(); }, 1000, 100)
+  , m_taskShowNextDevice([this](){ ShowNextDevice(); }, 10*1000, 100)
+  , m_taskReadForecast([this](){ ReadForecast(); }, 0, 3000)
+  , m_taskReadCurrentWeather([this](){ ReadCurrentWeather(); }, 0, 3000)
+  , m_forecastRefresh(5*60*1000, 3*60*60*1000, 30*1000, 30*60*1000)
+  , m_currentWeatherRefresh(60*1000, 60*1000, 10*1000, 10*60*1000)
 {
 }
 
 void RemoteSensors::begin()
 {
-  m_timerForReadOuterSensors.Start();
-  m_timerForReadForecast.Start();
-  m_timerForReadCurrentWeather.Start();
+  m_scheduler.Add(m_taskUpdateOuterSensors, 1000);
+  m_scheduler.Add(m_taskShowNextDevice, 10*1000);
+  m_scheduler.Add(m_taskReadForecast, 1000);
+  m_scheduler.Add(m_taskReadCurrentWeather, 1000);
 }
 
-void RemoteSensors::loop()
+void RemoteSensors::end()
 {
-  auto current = millis();
-  
-  if (m_timerForReadOuterSensors.IsElapsed())
+  m_scheduler.Remove(m_taskUpdateOuterSensors);
+  m_scheduler.Remove(m_taskShowNextDevice);
+  m_scheduler.Remove(m_taskReadForecast);
+  m_scheduler.Remove(m_taskReadCurrentWeather);
+}
+
+void RemoteSensors::UpdateOuterSensors()
+{
+  for (size_t i = 0; i < m_devices.GetCount(); ++i)
   {
-    if (m_outerSensorsReady[0] || m_outerSensorsReady[1] || m_outerSensorsReady[2])
-    {
-      m_outerSensorsReady[0] = false;
-      m_outerSensorsReady[1] = false;
-      m_outerSensorsReady[2] = false;
-      m_timeForReadOuterSensors = current;
-      ParseMqttData();
-    }
-  
-    if (m_timerForReadForecast.IsElapsed())
-    {
-      m_timeForReadForecast = current;
-      if (ReadWeather(WeatherType::Forecast))
-        m_forecastWeatherReady = true;
-      else
-        m_timerForReadForecast.Reset(TimerState::Started);
-    }
-  
-    if (m_timerForReadCurrentWeather.IsElapsed())
+    if (m_outerDevices[i].pendingMask != 0)
+      ApplyOuterSensors(m_outerDevices[i]);
+  }
+
+  Print();
+}
+
+void RemoteSensors::ShowNextDevice()
+{
+  size_t count = m_devices.GetCount();
+  for (size_t i = 1; i <= count; ++i)
+  {
+    size_t next = (m_currentDevice + i) % count;
+    if (m_outerDevices[next].lastSeen != 0)
     {
-      m_timeForReadCurrentWeather = current;
-      if (ReadWeather(WeatherType::Current))
-        m_currentWeatherReady = true;
-      else
-        m_timerForReadCurrentWeather.Reset(TimerState::Started);
+      m_currentDevice = next;
+      break;
     }
-  
-    Print();
   }
 }
 
+void RemoteSensors::ReadForecast()
+{
+  m_timeForReadForecast = millis();
+  if (ReadWeather(WeatherType::Forecast))
+    m_forecastWeatherReady = true;
+  m_scheduler.Add(m_taskReadForecast, m_forecastRefresh.GetNextIntervalMs());
+}
+
+void RemoteSensors::ReadCurrentWeather()
+{
+  m_timeForReadCurrentWeather = millis();
+  if (ReadWeather(WeatherType::Current))
+    m_currentWeatherReady = true;
+  m_scheduler.Add(m_taskReadCurrentWeather, m_currentWeatherRefresh.GetNextIntervalMs());
+}
+
 bool RemoteSensors::Print()
 {
+  const OuterDevice& device = m_outerDevices[m_currentDevice];
+
+  if (m_devices.GetCount() > 1)
+  {
+    m_display.SetSmallFont();
+    m_display.DrawField(m_devices.GetName(m_currentDevice), 170, 298 - 16, DeviceNameWidth);
+  }
+
+  //The carousel shares one set of fields, so blank whatever this device
+  //has not reported instead of leaving the previous device's values
   m_display.SetBigFont();
-  if (m_outerTemperature.isGood)
+  if (device.temperature.isGood)
   {
-    m_display.DrawNumber(m_outerTemperature.value, 24, 14, true);
-    m_display.DrawArrow(m_outerTemperature.value, m_outerTemperature.r, 100, 19);
+    m_display.DrawNumber(device.temperature.value, 24, 14, true);
+    m_display.DrawArrow(device.temperature.value, device.temperature.r, 100, 19);
+  }
+  else
+  {
+    m_display.DrawField(NoValue, 24, 14, TemperatureWidth);
+    m_display.ClearArrow(100, 19);
   }
 
-  if (m_outerHumidity.isGood)
+  if (device.humidity.isGood)
+  {
+    m_display.DrawNumber(device.humidity.value, 160, 14, false);
+    m_display.DrawArrow(device.humidity.value, device.humidity.r, 216, 19);
+  }
+  else
   {
-    m_display.DrawNumber(m_outerHumidity.value, 160, 14, false);
-    m_display.DrawArrow(m_outerHumidity.value, m_outerHumidity.r, 216, 19);
+    m_display.DrawField(NoValue, 160, 14, HumidityWidth);
+    m_display.ClearArrow(216, 19);
   }
 
-  if (m_outerPressure.isGood)
+  if (device.pressure.isGood)
+  {
+    m_display.DrawNumber(device.pressure.value, 46, 80, false);
+    m_display.DrawArrow(device.pressure.value, device.pressure.r, 104, 93);
+  }
+  else
   {
-    m_display.DrawNumber(m_outerPressure.value, 46, 80, false);
-    m_display.DrawArrow(m_outerPressure.value, m_outerPressure.r, 104, 93);
-    m_display.DrawChart(m_outerPressureMin, m_outerPressureMax, m_pressureHistory, m_historyIndex);
+    m_display.DrawField(NoValue, 46, 80, PressureWidth);
+    m_display.ClearArrow(104, 93);
   }
 
+  if (device.isError)
+    m_display.PrintError(SensorError);
+  else if (device.pressure.isGood)
+    m_display.DrawChart(device.pressureMin, device.pressureMax, device.pressureHistory, device.historyIndex);
+  else
+    m_display.ClearChart();
+
   if (m_forecastWeatherReady)
   {
     m_forecastWeatherReady = false;
@@ -120,7 +184,7 @@ bool RemoteSensors::Print()
   }
 
   auto current = millis();
-  uint32_t dt = (current - m_timeForReadOuterSensors) / 1000;
+  uint32_t dt = (device.lastSeen != 0 ? (current - device.lastSeen) / 1000 : UINT32_MAX);
   m_display.PrintLastUpdated(114, 298, dt);
 
   dt = (current - m_timeForReadCurrentWeather) / 1000;
@@ -131,6 +195,22 @@ bool RemoteSensors::Print()
   return true;
 }
 
+uint32_t ForecastNextSlotTime(const JsonObject& root, int linesCount, uint32_t currentDateTime)
+{
+  uint32_t nextSlot = 0;
+  for (int i = 0; i < linesCount; ++i)
+  {
+    auto& line = root[keys::List][i];
+    if (!line)
+      break;
+
+    uint32_t dt = line[keys::Dt];
+    if (dt > currentDateTime && (nextSlot == 0 || dt < nextSlot))
+      nextSlot = dt;
+  }
+  return nextSlot;
+}
+
 void GetForecastJsonParams(const JsonObject& root, int lineNumber, SensorValue& t, SensorValue& clouds, SensorValue& rain, SensorValue& windSpeed, SensorValue& windDirection)
 {
   auto& line = root[keys::List][lineNumber];
@@ -222,133 +302,167 @@ void RemoteSensors::PrintCurrentWeather()
   }
 }
 
+RefreshPolicy& RemoteSensors::GetRefreshPolicy(WeatherType weatherType)
+{
+  return (weatherType == WeatherType::Forecast ? m_forecastRefresh : m_currentWeatherRefresh);
+}
+
 bool RemoteSensors::ReadWeather(WeatherType weatherType)
 {
   bool ok = false;
   HTTPClient http;
+  RefreshPolicy& refresh = GetRefreshPolicy(weatherType);
 
   if (weatherType == WeatherType::Forecast)
     http.begin(ApiOpenWeatherMapOrgHost, 80, String(ApiOpenWeatherMapOrgForecast1) + String(m_configuration.GetApiLocation()) + String(ApiOpenWeatherMapOrgForecast2) + String(MyApiAppID));
   else
     http.begin(ApiOpenWeatherMapOrgHost, 80, String(ApiOpenWeatherMapOrgCurrent1) + String(m_configuration.GetApiLocation()) + String(ApiOpenWeatherMapOrgCurrent2) + String(MyApiAppID));
+
+  const char* headerKeys[] = {HeaderDate, HeaderETag, HeaderLastModified, HeaderCacheControl};
+  http.collectHeaders(headerKeys, sizeof(headerKeys) / sizeof(headerKeys[0]));
+  if (refresh.GetETag().length() != 0)
+    http.addHeader(HeaderIfNoneMatch, refresh.GetETag());
+  if (refresh.GetLastModified().length() != 0)
+    http.addHeader(HeaderIfModifiedSince, refresh.GetLastModified());
   
+  //HTTP/1.0 has no chunked encoding, so the body can be parsed straight from the socket
+  http.useHTTP10(true);
   int httpCode = http.GET();
+
+  if (httpCode == HTTP_CODE_NOT_MODIFIED)
+  {
+    refresh.OnNotModified(ParseMaxAge(http.header(HeaderCacheControl)));
+    http.end();
+    return false;
+  }
   
-  if (httpCode > 0) 
+  if (httpCode == HTTP_CODE_OK) 
   {
-    if (httpCode == HTTP_CODE_OK) 
+    uint32_t serverTime = ParseHttpDate(http.header(HeaderDate));
+    uint32_t maxAge = ParseMaxAge(http.header(HeaderCacheControl));
+
+    //The forecast repeats the same keys in every line, keep one copy of each
+    JsonInternTable<64> jsonKeys;
+    DynamicJsonBuffer jsonBuffer(4096);
+    jsonBuffer.setInternTable(&jsonKeys);
+    JsonObject& root = jsonBuffer.parseObject(http.getStream());
+    if (root.success())
     {
-      DynamicJsonBuffer jsonBuffer(4096);
-      auto response = http.getString();
-      JsonObject& root = jsonBuffer.parseObject(response);
-      if (root.success())
+      if (weatherType == WeatherType::Forecast)
       {
-        if (weatherType == WeatherType::Forecast)
-        {
-          int cnt = root["cnt"];
-          if (cnt == 10)
-          {
-            GetForecastJsonParams(root, 4, forecast12h_T, forecast12h_Clouds, forecast12h_Rain, forecast12h_WindSpeed, forecast12h_WindDirection);
-            GetForecastJsonParams(root, 9, forecast24h_T, forecast24h_Clouds, forecast24h_Rain, forecast24h_WindSpeed, forecast24h_WindDirection);
-            ok = true;
-          }
-        }
-        else
+        int cnt = root["cnt"];
+        if (cnt == 10)
         {
-           GetCurrentWeatherJsonParams(root, current_Rain, current_WindSpeed, current_WindDirection);
-           ok = true;
+          GetForecastJsonParams(root, 4, forecast12h_T, forecast12h_Clouds, forecast12h_Rain, forecast12h_WindSpeed, forecast12h_WindDirection);
+          GetForecastJsonParams(root, 9, forecast24h_T, forecast24h_Clouds, forecast24h_Rain, forecast24h_WindSpeed, forecast24h_WindDirection);
+          refresh.OnUpdated(serverTime, ForecastNextSlotTime(root, cnt, serverTime), maxAge);
+          ok = true;
         }
       }
+      else
+      {
+         GetCurrentWeatherJsonParams(root, current_Rain, current_WindSpeed, current_WindDirection);
+         refresh.OnUpdated(serverTime, 0, maxAge);
+         ok = true;
+      }
     }
   } 
+
+  if (ok)
+  {
+    refresh.SetETag(http.header(HeaderETag));
+    refresh.SetLastModified(http.header(HeaderLastModified));
+  }
+  else
+  {
+    refresh.OnFailed();
+  }
   
   http.end();
   return ok;
 }
 
-bool StrEq(const char* s1, const char* s2)
+void RemoteSensors::OnSample(uint8_t device, SensorChannel channel, float value)
 {
-  if (strlen(s1) != strlen(s2))
-    return false;
-  return strcmp(s1, s2) == 0;
+  size_t index = static_cast<size_t>(channel);
+  if (device >= m_devices.GetCount() || index >= ChannelsCount)
+    return;
+  OuterDevice& outerDevice = m_outerDevices[device];
+  outerDevice.pending[index] = value;
+  outerDevice.pendingMask |= 1 << index;
+  outerDevice.lastSeen = millis();
 }
 
-void RemoteSensors::OnDataArrived(const char* topic, const uint8_t* payload, uint32_t length)
+void ApplySample(SensorValue& sensorValue, float value)
 {
-  static char buffer[1024];
-  if (length > 1023)
-    length = 1023;
-  buffer[length] = 0;
-  memcpy(buffer, payload, length);
-  String text(buffer);
+  if (sensorValue.isGood)
+    sensorValue.pred = sensorValue.value;
+  sensorValue.value = value;
+  sensorValue.isGood = !isnan(value);
+  CalcAvarage(sensorValue);
+}
 
-  if (StrEq(topic, Device1Sensor1))
-  {
-    m_payloadMqttSensor1 = text;
-    m_outerSensorsReady[0] = true;
-  }
-  else if (StrEq(topic, Device1Sensor2))
-  {
-    m_payloadMqttSensor2 = text;
-    m_outerSensorsReady[1] = true;
-  }
-  else if (StrEq(topic, Device1Sensor3))
+void RemoteSensors::OnRecord(uint8_t device, const SampleRecord& record)
+{
+  if (device >= m_devices.GetCount())
+    return;
+  OuterDevice& outerDevice = m_outerDevices[device];
+  if (outerDevice.hasRecord && outerDevice.lastSequence == record.sequence)
+    return;
+  outerDevice.hasRecord = true;
+  outerDevice.lastSequence = record.sequence;
+  outerDevice.lastSeen = millis();
+
+  outerDevice.isError = (record.flags & SampleRecord::SensorError) != 0;
+  if (record.flags & SampleRecord::TemperatureValid)
+    ApplySample(outerDevice.temperature, record.GetTemperature());
+  if (record.flags & SampleRecord::HumidityValid)
+    ApplySample(outerDevice.humidity, record.GetHumidity());
+  if (record.flags & SampleRecord::PressureValid)
   {
-    m_payloadMqttSensor3 = text;
-    m_outerSensorsReady[2] = true;
+    ApplySample(outerDevice.pressure, record.GetPressure());
+    AddToHistory(outerDevice);
   }
 }
 
-void RemoteSensors::ParseMqttData()
+void RemoteSensors::ApplyOuterSensors(OuterDevice& device)
 {
-  if (m_payloadMqttSensor1.length() != 0)
-  {
-    if (m_outerTemperature.isGood)
-      m_outerTemperature.pred = m_outerTemperature.value;
-    m_outerTemperature.value = m_payloadMqttSensor1.toFloat();
-    m_payloadMqttSensor1.remove(0);
-    m_outerTemperature.isGood = m_outerTemperature.value != NAN;
-    CalcAvarage(m_outerTemperature);
-  }
-  if (m_payloadMqttSensor2.length() != 0)
-  {
-    if (m_outerHumidity.isGood)
-      m_outerHumidity.pred = m_outerHumidity.value;
-    m_outerHumidity.value = m_payloadMqttSensor2.toFloat();
-    m_payloadMqttSensor2.remove(0);
-    m_outerHumidity.isGood = m_outerHumidity.value != NAN;
-    CalcAvarage(m_outerHumidity);
-  }
-  if (m_payloadMqttSensor3.length() != 0)
-  {
-    if (m_outerPressure.isGood)
-      m_outerPressure.pred = m_outerPressure.value;
-    m_outerPressure.value = m_payloadMqttSensor3.toFloat();
-    m_payloadMqttSensor3.remove(0);
-    m_outerPressure.isGood = m_outerPressure.value != NAN;
-    CalcAvarage(m_outerPressure);
-    AddToHistory();
+  constexpr size_t Temperature = static_cast<size_t>(SensorChannel::Temperature);
+  constexpr size_t Humidity = static_cast<size_t>(SensorChannel::Humidity);
+  constexpr size_t Pressure = static_cast<size_t>(SensorChannel::Pressure);
+  constexpr size_t Error = static_cast<size_t>(SensorChannel::Error);
+
+  if (device.pendingMask & (1 << Temperature))
+    ApplySample(device.temperature, device.pending[Temperature]);
+  if (device.pendingMask & (1 << Humidity))
+    ApplySample(device.humidity, device.pending[Humidity]);
+  if (device.pendingMask & (1 << Pressure))
+  {
+    ApplySample(device.pressure, device.pending[Pressure]);
+    AddToHistory(device);
   }
+  if (device.pendingMask & (1 << Error))
+    device.isError = device.pending[Error] != 0;
+  device.pendingMask = 0;
 }
 
-void RemoteSensors::AddToHistory()
+void RemoteSensors::AddToHistory(OuterDevice& device)
 {
   auto current = millis();
 
-  if (current - m_historyTimeLastAdded > historyTimeStep || m_historyTimeLastAdded == 0)
+  if (current - device.historyTimeLastAdded > historyTimeStep || device.historyTimeLastAdded == 0)
   {
-    m_historyTimeLastAdded = current;
-    if (m_historyIndex >= HistoryDepth)
+    device.historyTimeLastAdded = current;
+    if (device.historyIndex >= HistoryDepth)
     {
-      memcpy(&m_pressureHistory[0], &m_pressureHistory[1], (HistoryDepth - 1) * sizeof(float));
-      m_historyIndex = HistoryDepth - 1;
+      memcpy(&device.pressureHistory[0], &device.pressureHistory[1], (HistoryDepth - 1) * sizeof(float));
+      device.historyIndex = HistoryDepth - 1;
     }
-    if (m_outerPressure.value < m_outerPressureMin)
-      m_outerPressureMin = m_outerPressure.value;
-    if (m_outerPressure.value > m_outerPressureMax)
-      m_outerPressureMax = m_outerPressure.value;
-    m_pressureHistory[m_historyIndex] = m_outerPressure.value;
-    ++m_historyIndex;
+    if (device.pressure.value < device.pressureMin)
+      device.pressureMin = device.pressure.value;
+    if (device.pressure.value > device.pressureMax)
+      device.pressureMax = device.pressure.value;
+    device.pressureHistory[device.historyIndex] = device.pressure.value;
+    ++device.historyIndex;
   }
 }
-
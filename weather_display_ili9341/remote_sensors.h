@@ -1,22 +1,26 @@
 #pragma once
 
 #include "sensor_value.h"
-#include "timer.h"
+#include "scheduler.h"
 #include "network.h"
 #include "chart.h"
+#include "refresh_policy.h"
+#include "events.h"
+#include "device_registry.h"
 
 class Display;
 class Configuration;
 
-class RemoteSensors: public IMqttConsumer
+class RemoteSensors
 {
 public:
-  RemoteSensors(Configuration& configuration, Display& display);
+  RemoteSensors(Configuration& configuration, Display& display, Scheduler& scheduler, const DeviceRegistry& devices);
 
   void begin();
-  void loop();
+  void end();
 
-  void OnDataArrived(const char* topic, const uint8_t* payload, uint32_t length) final;
+  void OnSample(uint8_t device, SensorChannel channel, float value);
+  void OnRecord(uint8_t device, const SampleRecord& record);
 
 private:
   enum WeatherType
@@ -25,22 +29,49 @@ private:
     Current
   };
 
+  static constexpr size_t ChannelsCount = static_cast<size_t>(SensorChannel::Count);
+
+  struct OuterDevice
+  {
+    SensorValue temperature;
+    SensorValue humidity;
+    SensorValue pressure;
+    float pressureMin = 730.0;
+    float pressureMax = 750.0;
+    bool isError = false;
+
+    float pending[ChannelsCount]{};
+    uint8_t pendingMask = 0;
+    uint32_t lastSeen = 0;
+    uint32_t lastSequence = 0;
+    bool hasRecord = false;
+
+    History pressureHistory{};
+    uint32_t historyTimeLastAdded = 0;
+    uint32_t historyIndex = 0;
+  };
+
 private:
+  void UpdateOuterSensors();
+  void ShowNextDevice();
+  void ReadForecast();
+  void ReadCurrentWeather();
   bool Print();
   void PrintForecastWeather();
   void PrintCurrentWeather();
   bool ReadWeather(WeatherType weatherType);
-  void AddToHistory();
-  void ParseMqttData();
+  RefreshPolicy& GetRefreshPolicy(WeatherType weatherType);
+  void AddToHistory(OuterDevice& device);
+  void ApplyOuterSensors(OuterDevice& device);
 
 private:
   Configuration& m_configuration;
   Display& m_display;
-  SensorValue m_outerTemperature;
-  SensorValue m_outerHumidity;
-  SensorValue m_outerPressure;
-  float m_outerPressureMin = 730.0;
-  float m_outerPressureMax = 750.0;
+  Scheduler& m_scheduler;
+  const DeviceRegistry& m_devices;
+
+  OuterDevice m_outerDevices[DeviceRegistry::MaxDevices];
+  size_t m_currentDevice = 0;
 
   SensorValue forecast12h_T;
   SensorValue forecast24h_T;
@@ -56,24 +87,18 @@ private:
   SensorValue current_WindSpeed;
   SensorValue current_WindDirection;
   
-  bool m_outerSensorsReady[3]{};
   bool m_forecastWeatherReady = false;
   bool m_currentWeatherReady = false;
 
-  Timer m_timerForReadOuterSensors;
-  Timer m_timerForReadForecast;
-  Timer m_timerForReadCurrentWeather;
+  Task m_taskUpdateOuterSensors;
+  Task m_taskShowNextDevice;
+  Task m_taskReadForecast;
+  Task m_taskReadCurrentWeather;
+
+  RefreshPolicy m_forecastRefresh;
+  RefreshPolicy m_currentWeatherRefresh;
   
-  uint32_t m_timeForReadOuterSensors = 0;
   uint32_t m_timeForReadForecast = 0;
   uint32_t m_timeForReadCurrentWeather = 0;
-
-  History m_pressureHistory{};
-  uint32_t m_historyTimeLastAdded = 0;
-  uint32_t m_historyIndex = 0;
-
-  String m_payloadMqttSensor1;
-  String m_payloadMqttSensor2;
-  String m_payloadMqttSensor3;
 };
 
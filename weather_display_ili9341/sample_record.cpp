@@ -0,0 +1,135 @@
+#include "sample_record.h"
+
+#include <cmath>
+
+void PutU16(uint8_t* buffer, uint16_t value)
+{
+  buffer[0] = value;
+  buffer[1] = value >> 8;
+}
+
+void PutU32(uint8_t* buffer, uint32_t value)
+{
+  PutU16(buffer, value);
+  PutU16(buffer + 2, value >> 16);
+}
+
+uint16_t GetU16(const uint8_t* buffer)
+{
+  return buffer[0] | (buffer[1] << 8);
+}
+
+uint32_t GetU32(const uint8_t* buffer)
+{
+  return GetU16(buffer) | (static_cast<uint32_t>(GetU16(buffer + 2)) << 16);
+}
+
+int32_t ToFixed(float value, float scale, int32_t minValue, int32_t maxValue)
+{
+  float scaled = roundf(value * scale);
+  if (scaled < minValue)
+    return minValue;
+  if (scaled > maxValue)
+    return maxValue;
+  return static_cast<int32_t>(scaled);
+}
+
+void SampleRecord::SetTemperature(float value)
+{
+  if (std::isnan(value))
+  {
+    flags &= ~TemperatureValid;
+    return;
+  }
+  temperature = ToFixed(value, 100, INT16_MIN, INT16_MAX);
+  flags |= TemperatureValid;
+}
+
+void SampleRecord::SetHumidity(float value)
+{
+  if (std::isnan(value))
+  {
+    flags &= ~HumidityValid;
+    return;
+  }
+  humidity = ToFixed(value, 100, 0, UINT16_MAX);
+  flags |= HumidityValid;
+}
+
+void SampleRecord::SetPressure(float value)
+{
+  if (std::isnan(value))
+  {
+    flags &= ~PressureValid;
+    return;
+  }
+  pressure = ToFixed(value, 10, 0, UINT16_MAX);
+  flags |= PressureValid;
+}
+
+float SampleRecord::GetTemperature() const
+{
+  return (flags & TemperatureValid) ? temperature / 100.0f : NAN;
+}
+
+float SampleRecord::GetHumidity() const
+{
+  return (flags & HumidityValid) ? humidity / 100.0f : NAN;
+}
+
+float SampleRecord::GetPressure() const
+{
+  return (flags & PressureValid) ? pressure / 10.0f : NAN;
+}
+
+size_t EncodeSampleRecord(const SampleRecord& record, uint8_t* buffer, size_t size)
+{
+  if (size < SampleRecord::Size)
+    return 0;
+  buffer[0] = SampleRecord::Version;
+  buffer[1] = record.flags;
+  buffer[2] = record.device;
+  buffer[3] = SampleRecord::Size;
+  PutU32(buffer + 4, record.sequence);
+  PutU32(buffer + 8, record.timestamp);
+  PutU16(buffer + 12, record.temperature);
+  PutU16(buffer + 14, record.humidity);
+  PutU16(buffer + 16, record.pressure);
+  return SampleRecord::Size;
+}
+
+bool DecodeSampleRecord(const uint8_t* buffer, size_t size, SampleRecord& record)
+{
+  if (buffer[0] < SampleRecord::Version || GetSampleRecordLength(buffer, size) == 0)
+    return false;
+  record.flags = buffer[1];
+  record.device = buffer[2];
+  record.sequence = GetU32(buffer + 4);
+  record.timestamp = GetU32(buffer + 8);
+  record.temperature = static_cast<int16_t>(GetU16(buffer + 12));
+  record.humidity = GetU16(buffer + 14);
+  record.pressure = GetU16(buffer + 16);
+  return true;
+}
+
+size_t GetSampleRecordLength(const uint8_t* buffer, size_t size)
+{
+  if (size < SampleRecord::Size)
+    return 0;
+  size_t length = buffer[3] != 0 ? buffer[3] : SampleRecord::Size;
+  if (length < SampleRecord::Size || length > size)
+    return 0;
+  return length;
+}
+
+bool DecodeNewestSampleRecord(const uint8_t* buffer, size_t size, SampleRecord& record)
+{
+  bool isDecoded = false;
+  size_t offset = 0;
+  while (size_t length = GetSampleRecordLength(buffer + offset, size - offset))
+  {
+    isDecoded |= DecodeSampleRecord(buffer + offset, length, record);
+    offset += length;
+  }
+  return isDecoded;
+}
@@ -0,0 +1,52 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+//Binary sample published by the sensor node as a single MQTT message.
+//Little-endian:
+//  0 version, 1 flags, 2 device, 3 record length (0 in the first senders),
+//  4 sequence (u32), 8 timestamp in ms since sender power-on (u32),
+//  12 temperature in 0.01 'C (i16), 14 humidity in 0.01 %RH (u16),
+//  16 pressure in 0.1 mm Hg (u16)
+//A message may carry several records back to back, oldest first. Newer
+//versions only append fields, so a reader decodes the fields it knows and
+//steps over the rest by the record length.
+struct SampleRecord
+{
+  static constexpr uint8_t Version = 1;
+  static constexpr size_t Size = 18;
+
+  enum Flags : uint8_t
+  {
+    SensorError = 0x01,
+    TemperatureValid = 0x02,
+    HumidityValid = 0x04,
+    PressureValid = 0x08,
+    //Newer records are queued behind this one, it is not the current value
+    Backlog = 0x10
+  };
+
+  uint8_t flags = 0;
+  uint8_t device = 0;
+  uint32_t sequence = 0;
+  uint32_t timestamp = 0;
+  int16_t temperature = 0;
+  uint16_t humidity = 0;
+  uint16_t pressure = 0;
+
+  void SetTemperature(float value);
+  void SetHumidity(float value);
+  void SetPressure(float value);
+
+  float GetTemperature() const;
+  float GetHumidity() const;
+  float GetPressure() const;
+};
+
+size_t EncodeSampleRecord(const SampleRecord& record, uint8_t* buffer, size_t size);
+bool DecodeSampleRecord(const uint8_t* buffer, size_t size, SampleRecord& record);
+//Length of the record at the start of the buffer, 0 if it does not fit
+size_t GetSampleRecordLength(const uint8_t* buffer, size_t size);
+//Decodes the newest valid record of a message, false if it has none
+bool DecodeNewestSampleRecord(const uint8_t* buffer, size_t size, SampleRecord& record);
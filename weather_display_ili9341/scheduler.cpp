@@ -0,0 +1,143 @@
+#include "scheduler.h"
+
+Task::Task(Callback callback, uint32_t periodMs, uint32_t budgetMs)
+  : m_callback(callback)
+  , m_periodMs(periodMs)
+  , m_budgetMs(budgetMs)
+{
+}
+
+Scheduler::Scheduler(SchedulerClock clock)
+  : m_clock(clock)
+{
+}
+
+bool Scheduler::Add(Task& task, uint32_t delayMs)
+{
+  if (task.IsScheduled())
+    Erase(task.m_heapIndex);
+  else if (m_size == MaxTasks)
+    return false;
+
+  task.m_deadline = m_clock() + delayMs;
+  Push(task);
+  return true;
+}
+
+void Scheduler::Remove(Task& task)
+{
+  if (task.IsScheduled())
+    Erase(task.m_heapIndex);
+  if (m_running == &task)
+    m_running = nullptr;
+}
+
+void Scheduler::loop()
+{
+  uint32_t now = m_clock();
+  for (size_t n = m_size; n != 0 && m_size != 0; --n)
+  {
+    Task* task = m_heap[0];
+    if (IsBefore(now, task->m_deadline))
+      break;
+    Erase(0);
+    Run(*task, now);
+    now = m_clock();
+  }
+}
+
+uint32_t Scheduler::GetTimeToNextMs() const
+{
+  if (m_size == 0)
+    return UINT32_MAX;
+  uint32_t now = m_clock();
+  if (IsBefore(now, m_heap[0]->m_deadline))
+    return m_heap[0]->m_deadline - now;
+  return 0;
+}
+
+void Scheduler::Run(Task& task, uint32_t now)
+{
+  uint32_t jitter = now - task.m_deadline;
+  if (jitter > task.m_maxJitterMs)
+    task.m_maxJitterMs = jitter;
+
+  m_running = &task;
+  task.m_callback();
+  uint32_t end = m_clock();
+
+  uint32_t duration = end - now;
+  if (duration > task.m_maxDurationMs)
+    task.m_maxDurationMs = duration;
+  if (task.m_budgetMs != 0 && duration > task.m_budgetMs)
+    ++task.m_overruns;
+  ++task.m_runs;
+
+  if (m_running == &task && !task.IsScheduled() && task.m_periodMs != 0)
+  {
+    uint32_t next = task.m_deadline + task.m_periodMs;
+    if (IsBefore(next, end))
+      next = end + task.m_periodMs;
+    task.m_deadline = next;
+    Push(task);
+  }
+  m_running = nullptr;
+}
+
+void Scheduler::Push(Task& task)
+{
+  Place(&task, m_size++);
+  SiftUp(task.m_heapIndex);
+}
+
+void Scheduler::Erase(size_t index)
+{
+  m_heap[index]->m_heapIndex = Task::NotScheduled;
+  --m_size;
+  if (index == m_size)
+    return;
+  Task* moved = m_heap[m_size];
+  Place(moved, index);
+  SiftDown(index);
+  SiftUp(moved->m_heapIndex);
+}
+
+void Scheduler::SiftUp(size_t index)
+{
+  while (index != 0)
+  {
+    size_t parent = (index - 1) / 2;
+    if (!IsBefore(m_heap[index]->m_deadline, m_heap[parent]->m_deadline))
+      break;
+    Task* task = m_heap[index];
+    Place(m_heap[parent], index);
+    Place(task, parent);
+    index = parent;
+  }
+}
+
+void Scheduler::SiftDown(size_t index)
+{
+  for (;;)
+  {
+    size_t smallest = index;
+    size_t left = 2 * index + 1;
+    size_t right = left + 1;
+    if (left < m_size && IsBefore(m_heap[left]->m_deadline, m_heap[smallest]->m_deadline))
+      smallest = left;
+    if (right < m_size && IsBefore(m_heap[right]->m_deadline, m_heap[smallest]->m_deadline))
+      smallest = right;
+    if (smallest == index)
+      return;
+    Task* task = m_heap[index];
+    Place(m_heap[smallest], index);
+    Place(task, smallest);
+    index = smallest;
+  }
+}
+
+void Scheduler::Place(Task* task, size_t index)
+{
+  m_heap[index] = task;
+  task->m_heapIndex = index;
+}
@@ -0,0 +1,45 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+
+//Single producer, single consumer ring. Push is called from one context only
+//(e.g. an LwIP callback), Pop from another one (the main loop).
+template<typename T, size_t Capacity>
+class SpscQueue
+{
+  static_assert(Capacity != 0 && (Capacity & (Capacity - 1)) == 0, "Capacity must be a power of two");
+
+public:
+  bool Push(const T& item)
+  {
+    size_t head = m_head.load(std::memory_order_relaxed);
+    if (head - m_tail.load(std::memory_order_acquire) == Capacity)
+    {
+      m_dropped.fetch_add(1, std::memory_order_relaxed);
+      return false;
+    }
+    m_items[head & (Capacity - 1)] = item;
+    m_head.store(head + 1, std::memory_order_release);
+    return true;
+  }
+
+  bool Pop(T& item)
+  {
+    size_t tail = m_tail.load(std::memory_order_relaxed);
+    if (tail == m_head.load(std::memory_order_acquire))
+      return false;
+    item = m_items[tail & (Capacity - 1)];
+    m_tail.store(tail + 1, std::memory_order_release);
+    return true;
+  }
+
+  bool IsEmpty() const { return m_tail.load(std::memory_order_acquire) == m_head.load(std::memory_order_acquire); }
+  size_t GetDropped() const { return m_dropped.load(std::memory_order_relaxed); }
+
+private:
+  T m_items[Capacity]{};
+  std::atomic<size_t> m_head{0};
+  std::atomic<size_t> m_tail{0};
+  std::atomic<size_t> m_dropped{0};
+};
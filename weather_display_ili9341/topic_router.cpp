@@ -0,0 +1,178 @@
+#include "topic_router.h"
+
+#include <cmath>
+#include <cstring>
+
+TopicRouter::TopicRouter(const Route* routes, size_t count, void* context)
+  : m_routes(routes)
+  , m_count(count < MaxRoutes ? count : MaxRoutes)
+  , m_context(context)
+{
+  for (size_t i = 0; i < m_count; ++i)
+  {
+    size_t length = 0;
+    m_hashes[i] = Hash(m_routes[i].pattern, length);
+    m_lengths[i] = length;
+    m_isWildcard[i] = strpbrk(m_routes[i].pattern, "+#") != nullptr;
+  }
+}
+
+bool TopicRouter::Dispatch(const char* topic, const uint8_t* payload, uint32_t length) const
+{
+  size_t topicLength = 0;
+  uint32_t hash = Hash(topic, topicLength);
+
+  for (size_t i = 0; i < m_count; ++i)
+  {
+    if (m_isWildcard[i])
+      continue;
+    if (m_hashes[i] == hash && m_lengths[i] == topicLength && memcmp(m_routes[i].pattern, topic, topicLength) == 0)
+    {
+      m_routes[i].handler(m_context, m_routes[i].id, topic, payload, length);
+      return true;
+    }
+  }
+
+  for (size_t i = 0; i < m_count; ++i)
+  {
+    if (m_isWildcard[i] && Matches(m_routes[i].pattern, topic))
+    {
+      m_routes[i].handler(m_context, m_routes[i].id, topic, payload, length);
+      return true;
+    }
+  }
+  return false;
+}
+
+bool TopicRouter::Matches(const char* pattern, const char* topic)
+{
+  while (*pattern)
+  {
+    if (*pattern == '#')
+      return true;
+    if (*pattern == '+')
+    {
+      while (*topic && *topic != '/')
+        ++topic;
+      ++pattern;
+      continue;
+    }
+    if (*topic == 0 && pattern[0] == '/' && pattern[1] == '#')
+      return true;
+    if (*pattern != *topic)
+      return false;
+    ++pattern;
+    ++topic;
+  }
+  return *topic == 0;
+}
+
+uint32_t TopicRouter::Hash(const char* text, size_t& length)
+{
+  //FNV-1a
+  uint32_t hash = 2166136261u;
+  const char* p = text;
+  for (; *p; ++p)
+  {
+    hash ^= static_cast<uint8_t>(*p);
+    hash *= 16777619u;
+  }
+  length = p - text;
+  return hash;
+}
+
+uint32_t TopicRouter::Hash(const char* text, size_t length, uint32_t hash)
+{
+  for (size_t i = 0; i < length; ++i)
+  {
+    hash ^= static_cast<uint8_t>(text[i]);
+    hash *= 16777619u;
+  }
+  return hash;
+}
+
+bool ParsePayloadFloat(const uint8_t* payload, uint32_t length, float& value)
+{
+  const uint8_t* p = payload;
+  const uint8_t* end = payload + length;
+  while (p != end && *p == ' ')
+    ++p;
+
+  bool negative = false;
+  if (p != end && (*p == '-' || *p == '+'))
+  {
+    negative = *p == '-';
+    ++p;
+  }
+
+  uint32_t mantissa = 0;
+  int32_t exponent = 0;
+  bool hasDigits = false;
+  for (; p != end && *p >= '0' && *p <= '9'; ++p)
+  {
+    if (mantissa < 100000000)
+      mantissa = mantissa * 10 + (*p - '0');
+    else
+      ++exponent;
+    hasDigits = true;
+  }
+  if (p != end && *p == '.')
+  {
+    for (++p; p != end && *p >= '0' && *p <= '9'; ++p)
+    {
+      if (mantissa < 100000000)
+      {
+        mantissa = mantissa * 10 + (*p - '0');
+        --exponent;
+      }
+      hasDigits = true;
+    }
+  }
+  if (hasDigits && p != end && (*p == 'e' || *p == 'E'))
+  {
+    ++p;
+    bool negativeExponent = false;
+    if (p != end && (*p == '-' || *p == '+'))
+    {
+      negativeExponent = *p == '-';
+      ++p;
+    }
+    int32_t digits = 0;
+    bool hasExponentDigits = false;
+    for (; p != end && *p >= '0' && *p <= '9'; ++p)
+    {
+      //Far out of the float range already, keeps the scaling loops short
+      if (digits < 1000)
+        digits = digits * 10 + (*p - '0');
+      hasExponentDigits = true;
+    }
+    if (!hasExponentDigits)
+      return false;
+    exponent += negativeExponent ? -digits : digits;
+  }
+  while (p != end && (*p == ' ' || *p == 0))
+    ++p;
+  if (!hasDigits || p != end)
+    return false;
+
+  static const float Powers[] = {1e0f, 1e1f, 1e2f, 1e3f, 1e4f, 1e5f, 1e6f, 1e7f, 1e8f};
+  float result = mantissa;
+  while (exponent > 8)
+  {
+    result *= Powers[8];
+    exponent -= 8;
+  }
+  while (exponent < -8)
+  {
+    result /= Powers[8];
+    exponent += 8;
+  }
+  if (exponent > 0)
+    result *= Powers[exponent];
+  else if (exponent < 0)
+    result /= Powers[-exponent];
+  if (std::isinf(result))
+    return false;
+  value = negative ? -result : result;
+  return true;
+}
@@ -0,0 +1,38 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+class TopicRouter
+{
+public:
+  static constexpr size_t MaxRoutes = 16;
+
+  using Handler = void (*)(void* context, uint8_t id, const char* topic, const uint8_t* payload, uint32_t length);
+
+  struct Route
+  {
+    const char* pattern;
+    Handler handler;
+    uint8_t id;
+  };
+
+  TopicRouter(const Route* routes, size_t count, void* context);
+
+  bool Dispatch(const char* topic, const uint8_t* payload, uint32_t length) const;
+
+  static bool Matches(const char* pattern, const char* topic);
+  static uint32_t Hash(const char* text, size_t& length);
+  static uint32_t Hash(const char* text, size_t length, uint32_t hash);
+
+private:
+  const Route* m_routes;
+  size_t m_count;
+  void* m_context;
+
+  uint32_t m_hashes[MaxRoutes]{};
+  uint16_t m_lengths[MaxRoutes]{};
+  bool m_isWildcard[MaxRoutes]{};
+};
+
+bool ParsePayloadFloat(const uint8_t* payload, uint32_t length, float& value);
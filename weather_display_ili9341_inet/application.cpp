@@ -3,9 +3,10 @@
 #include <pgmspace.h>
 
 Application::Application()
-  : m_network(m_display, this)
-  , m_localSensors(m_display)
-  , m_remoteSensors(m_display)
+  : m_scheduler(millis)
+  , m_network(m_display, this)
+  , m_localSensors(m_display, m_scheduler)
+  , m_remoteSensors(m_display, m_network, m_scheduler)
 {
 }
 
@@ -28,10 +29,6 @@ void Application::loop()
 
   if (IsStopped())
     return;
-  m_localSensors.loop();
-
-  if (IsStopped() || !m_network.ConnectedNoWait())
-    return;
-  m_remoteSensors.loop();
+  m_scheduler.loop();
 }
 
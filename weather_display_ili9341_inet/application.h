@@ -5,6 +5,7 @@
 #include "display.h"
 #include "local_sensors.h"
 #include "remote_sensors.h"
+#include "scheduler.h"
 
 class Application: public RunState
 {
@@ -15,6 +16,7 @@ public:
   void loop();
 
 private:
+  Scheduler m_scheduler;
   Network m_network;
   Display m_display;
   LocalSensors m_localSensors;
@@ -5,11 +5,27 @@
 constexpr int GPIO_I2C_DATA PROGMEM = 2;
 constexpr int GPIO_I2C_CLK PROGMEM = 4;
 constexpr int AnalogSensorPin PROGMEM = A0;
+constexpr uint8_t RoomSensorAddress PROGMEM = 0x76;
+constexpr uint8_t SpareSensorAddress PROGMEM = 0x77;
+constexpr uint32_t SensorsPeriodMs PROGMEM = 1000;
+constexpr uint32_t SensorsPollMs PROGMEM = 5;
+constexpr uint32_t SensorStaleMs PROGMEM = 5 * SensorsPeriodMs;
 
-LocalSensors::LocalSensors(Display& display)
+BME280I2C::Settings SensorSettings(uint8_t address)
+{
+  BME280I2C::Settings settings;
+  settings.bme280Addr = address;
+  return settings;
+}
+
+LocalSensors::LocalSensors(Display& display, Scheduler& scheduler)
   : m_display(display)
-  , m_timerForReadSensors(1000, TimerState::Started)
-  , m_timerForReadAnalogue(2000, TimerState::Started)
+  , m_scheduler(scheduler)
+  , m_roomTHSensor(SensorSettings(RoomSensorAddress))
+  , m_spareTHSensor(SensorSettings(SpareSensorAddress))
+  , m_sensors(SensorsPeriodMs)
+  , m_taskReadSensors([this](){ ReadSensors(); }, SensorsPollMs, 10)
+  , m_taskReadAnalogue([this](){ ReadAnalogue(); }, 2000, 5)
 {
 }
 
@@ -19,47 +35,57 @@ void LocalSensors::begin()
   {
     delay(100);
   }
-  m_timerForReadSensors.Start();
-  m_timerForReadAnalogue.Start();
+  m_sensors.add(m_roomTHSensor);
+  //The second sensor is optional and only used while the first one fails
+  if (m_spareTHSensor.begin(GPIO_I2C_DATA, GPIO_I2C_CLK))
+    m_sensors.add(m_spareTHSensor);
+  m_scheduler.Add(m_taskReadSensors);
+  m_scheduler.Add(m_taskReadAnalogue);
 }
 
-void LocalSensors::loop()
+void LocalSensors::ReadSensors()
 {
-  if (m_timerForReadSensors.IsElapsed())
-  {
-    if (Read())
-      Print();
-    else
-      m_timerForReadSensors.Reset(TimerState::Started);
-  }
-  if (m_timerForReadAnalogue.IsElapsed())
+  m_sensors.loop();
+  if (Read())
+    Print();
+}
+
+uint8_t LocalSensors::SelectSensor() const
+{
+  uint32_t now = millis();
+  for (uint8_t i = 0; i < m_sensors.count(); ++i)
   {
-    int sensorValue = 1023 - analogRead(AnalogSensorPin);
-    m_roomLight.value = sensorValue * 100 / 1024;
-    m_roomLight.isGood = true;
-    m_display.TurnLcdLedOnOff(m_roomLight.value > 15);
+    const BME280Manager::Health& health = m_sensors.health(i);
+    if (health.samples != 0 && now - health.lastSample < SensorStaleMs)
+      return i;
   }
+  return 0;
+}
+
+void LocalSensors::ReadAnalogue()
+{
+  int sensorValue = 1023 - analogRead(AnalogSensorPin);
+  m_roomLight.value = sensorValue * 100 / 1024;
+  m_roomLight.isGood = true;
+  m_display.TurnLcdLedOnOff(m_roomLight.value > 15);
 }
 
 bool LocalSensors::Read()
 {
+  float pressure = NAN;
+  float temperature = NAN;
+  float humidity = NAN;
+  if (!m_sensors.fetch(SelectSensor(), pressure, temperature, humidity))
+    return false;
+
   if (m_roomTemperature.isGood)
     m_roomTemperature.pred = m_roomTemperature.value;
   if (m_roomHumidity.isGood)
     m_roomHumidity.pred = m_roomHumidity.value;
-
-  float pressure = NAN;
-  m_roomTemperature.value = NAN;
-  m_roomHumidity.value = NAN;
-  m_roomTHSensor.read(pressure, m_roomTemperature.value, m_roomHumidity.value);
-  if (pressure == NAN && m_roomTemperature.value == NAN && m_roomHumidity.value == NAN)
-  {
-    m_roomTemperature.isGood = false;
-    m_roomHumidity.isGood = false;
-    return false;
-  }
-  m_roomTemperature.isGood = m_roomTemperature.value != NAN;
-  m_roomHumidity.isGood = m_roomHumidity.value != NAN;
+  m_roomTemperature.value = temperature;
+  m_roomHumidity.value = humidity;
+  m_roomTemperature.isGood = !isnan(m_roomTemperature.value);
+  m_roomHumidity.isGood = !isnan(m_roomHumidity.value);
 
   CalcAvarage(m_roomTemperature);
   CalcAvarage(m_roomHumidity);
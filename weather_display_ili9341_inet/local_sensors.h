@@ -1,9 +1,10 @@
 #pragma once
 
 #include "sensor_value.h"
-#include "timer.h"
+#include "scheduler.h"
 
 #include <BME280I2C.h>
+#include <BME280Manager.h>
 
 class Display;
 class Configuration;
@@ -11,25 +12,30 @@ class Configuration;
 class LocalSensors
 {
 public:
-  LocalSensors(Display& display);
+  LocalSensors(Display& display, Scheduler& scheduler);
 
   void begin();
-  void loop();
 
 private:
+  void ReadSensors();
+  void ReadAnalogue();
   bool Read();
+  uint8_t SelectSensor() const;
   void Print();
   
 private:
   Display& m_display;
+  Scheduler& m_scheduler;
 
   BME280I2C m_roomTHSensor;
+  BME280I2C m_spareTHSensor;
+  BME280Manager m_sensors;
   SensorValue m_roomTemperature;
   SensorValue m_roomHumidity;
   SensorValue m_roomLight;
 
-  Timer m_timerForReadSensors;
-  Timer m_timerForReadAnalogue;
+  Task m_taskReadSensors;
+  Task m_taskReadAnalogue;
 };
 
 
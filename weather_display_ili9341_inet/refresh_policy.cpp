@@ -0,0 +1,101 @@
+#include "refresh_policy.h"
+
+#include <pgmspace.h>
+
+constexpr uint32_t SlotMarginSec PROGMEM = 60;
+constexpr uint32_t MaxBackoffShift PROGMEM = 16;
+constexpr const char* Months PROGMEM = "JanFebMarAprMayJunJulAugSepOctNovDec";
+constexpr const char* MaxAgeKey PROGMEM = "max-age=";
+
+RefreshPolicy::RefreshPolicy(uint32_t minIntervalMs, uint32_t maxIntervalMs, uint32_t retryIntervalMs, uint32_t maxRetryIntervalMs)
+  : m_minIntervalMs(minIntervalMs)
+  , m_maxIntervalMs(maxIntervalMs)
+  , m_retryIntervalMs(retryIntervalMs)
+  , m_maxRetryIntervalMs(maxRetryIntervalMs)
+  , m_nextIntervalMs(minIntervalMs)
+{
+}
+
+void RefreshPolicy::OnUpdated(uint32_t serverTime, uint32_t nextSlotTime, uint32_t maxAge)
+{
+  m_failures = 0;
+
+  uint32_t intervalMs = m_maxIntervalMs;
+  if (serverTime != 0 && nextSlotTime > serverTime)
+  {
+    uint32_t delta = nextSlotTime - serverTime + SlotMarginSec;
+    if (delta < m_maxIntervalMs / 1000)
+      intervalMs = delta * 1000;
+  }
+  if (maxAge != 0 && maxAge < m_maxIntervalMs / 1000 && maxAge * 1000 > intervalMs)
+    intervalMs = maxAge * 1000;
+  m_nextIntervalMs = Clamp(intervalMs);
+}
+
+void RefreshPolicy::OnNotModified(uint32_t maxAge)
+{
+  m_failures = 0;
+
+  uint32_t intervalMs = m_minIntervalMs;
+  if (maxAge != 0)
+    intervalMs = (maxAge < m_maxIntervalMs / 1000 ? maxAge * 1000 : m_maxIntervalMs);
+  m_nextIntervalMs = Clamp(intervalMs);
+}
+
+void RefreshPolicy::OnFailed()
+{
+  uint32_t shift = (m_failures < MaxBackoffShift ? m_failures : MaxBackoffShift);
+  uint32_t intervalMs = m_retryIntervalMs << shift;
+  if (intervalMs > m_maxRetryIntervalMs || (intervalMs >> shift) != m_retryIntervalMs)
+    intervalMs = m_maxRetryIntervalMs;
+  m_nextIntervalMs = intervalMs;
+  ++m_failures;
+}
+
+uint32_t RefreshPolicy::Clamp(uint32_t intervalMs) const
+{
+  if (intervalMs < m_minIntervalMs)
+    return m_minIntervalMs;
+  if (intervalMs > m_maxIntervalMs)
+    return m_maxIntervalMs;
+  return intervalMs;
+}
+
+uint32_t DaysFromCivil(int year, int month, int day)
+{
+  year -= month <= 2;
+  int era = year / 400;
+  int yoe = year - era * 400;
+  int doy = (153 * (month + (month > 2 ? -3 : 9)) + 2) / 5 + day - 1;
+  int doe = yoe * 365 + yoe / 4 - yoe / 100 + doy;
+  return era * 146097 + doe - 719468;
+}
+
+uint32_t ParseHttpDate(const String& text)
+{
+  //Sun, 06 Nov 1994 08:49:37 GMT
+  int day = 0;
+  char month[4]{};
+  int year = 0;
+  int hour = 0;
+  int minute = 0;
+  int second = 0;
+  if (sscanf(text.c_str(), "%*3s, %d %3s %d %d:%d:%d", &day, month, &year, &hour, &minute, &second) != 6)
+    return 0;
+
+  const char* found = strstr(Months, month);
+  if (!found || (found - Months) % 3 != 0 || year < 1970)
+    return 0;
+  int monthNumber = (found - Months) / 3 + 1;
+
+  return DaysFromCivil(year, monthNumber, day) * 86400 + hour * 3600 + minute * 60 + second;
+}
+
+uint32_t ParseMaxAge(const String& cacheControl)
+{
+  int pos = cacheControl.indexOf(MaxAgeKey);
+  if (pos < 0)
+    return 0;
+  long maxAge = cacheControl.substring(pos + strlen(MaxAgeKey)).toInt();
+  return (maxAge > 0 ? maxAge : 0);
+}
@@ -0,0 +1,39 @@
+#pragma once
+
+#include <Arduino.h>
+
+class RefreshPolicy
+{
+public:
+  RefreshPolicy(uint32_t minIntervalMs, uint32_t maxIntervalMs, uint32_t retryIntervalMs, uint32_t maxRetryIntervalMs);
+
+  void OnUpdated(uint32_t serverTime, uint32_t nextSlotTime, uint32_t maxAge);
+  void OnNotModified(uint32_t maxAge);
+  void OnFailed();
+
+  uint32_t GetNextIntervalMs() const { return m_nextIntervalMs; }
+  uint32_t GetFailures() const { return m_failures; }
+
+  const String& GetETag() const { return m_eTag; }
+  void SetETag(const String& eTag) { m_eTag = eTag; }
+  const String& GetLastModified() const { return m_lastModified; }
+  void SetLastModified(const String& lastModified) { m_lastModified = lastModified; }
+
+private:
+  uint32_t Clamp(uint32_t intervalMs) const;
+
+private:
+  uint32_t m_minIntervalMs = 0;
+  uint32_t m_maxIntervalMs = 0;
+  uint32_t m_retryIntervalMs = 0;
+  uint32_t m_maxRetryIntervalMs = 0;
+
+  uint32_t m_nextIntervalMs = 0;
+  uint32_t m_failures = 0;
+
+  String m_eTag;
+  String m_lastModified;
+};
+
+uint32_t ParseHttpDate(const String& text);
+uint32_t ParseMaxAge(const String& cacheControl);
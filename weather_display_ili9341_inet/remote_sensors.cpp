@@ -13,6 +13,16 @@ constexpr const char *ApiOpenWeatherMapOrgForecast2 PROGMEM = "&units=metric&cnt
 constexpr const char *ApiOpenWeatherMapOrgCurrent1 PROGMEM = "/data/2.5/weather?q=";
 constexpr const char *ApiOpenWeatherMapOrgCurrent2 PROGMEM = "&units=metric&APPID=";
 
+constexpr const char *HeaderDate PROGMEM = "Date";
+constexpr const char *HeaderETag PROGMEM = "ETag";
+constexpr const char *HeaderLastModified PROGMEM = "Last-Modified";
+constexpr const char *HeaderCacheControl PROGMEM = "Cache-Control";
+constexpr const char *HeaderIfNoneMatch PROGMEM = "If-None-Match";
+constexpr const char *HeaderIfModifiedSince PROGMEM = "If-Modified-Since";
+
+//Without Wi-Fi a request fails and backs the refresh policy off, so it waits
+constexpr uint32_t OfflineRetryMs PROGMEM = 1000;
+
 constexpr uint32_t historyTimeStep PROGMEM = 12 * 60 * 60 * 1000 / HistoryDepth;
 
 namespace keys
@@ -33,46 +43,56 @@ constexpr const char* Humidity PROGMEM = "humidity";
 constexpr const char* Dt PROGMEM = "dt";
 }
 
-RemoteSensors::RemoteSensors(Display& display)
+RemoteSensors::RemoteSensors(Display& display, Network& network, Scheduler& scheduler)
   : m_display(display)
-  , m_timerForReadForecast(15 * 60 * 1000, TimerState::Started)
-  , m_timerForReadCurrentWeather(60 * 1000, TimerState::Started)
+  , m_network(network)
+  , m_scheduler(scheduler)
+  , m_taskPrint([this](){ Print(); }, 1000, 100)
+  , m_taskReadForecast([this](){ ReadForecast(); }, 0, 3000)
+  , m_taskReadCurrentWeather([this](){ ReadCurrentWeather(); }, 0, 3000)
+  , m_forecastRefresh(5 * 60 * 1000, 3 * 60 * 60 * 1000, 30 * 1000, 30 * 60 * 1000)
+  , m_currentWeatherRefresh(60 * 1000, 60 * 1000, 10 * 1000, 10 * 60 * 1000)
 {
 }
 
 void RemoteSensors::begin()
 {
-  m_timerForReadCurrentWeather.Start();
-  m_timerForReadForecast.Start();
+  m_scheduler.Add(m_taskReadCurrentWeather);
+  m_scheduler.Add(m_taskReadForecast);
+  m_scheduler.Add(m_taskPrint);
 }
 
-void RemoteSensors::loop()
+void RemoteSensors::ReadForecast()
 {
-  auto current = millis();
-
-  if (m_timerForReadCurrentWeather.IsElapsed())
+  if (!m_network.ConnectedNoWait())
   {
-    m_timeForReadCurrentWeather = current;
-    if (ReadWeather(WeatherType::Current))
-      m_currentWeatherReady = true;
-    else
-      m_timerForReadCurrentWeather.Reset(TimerState::Started);
+    m_scheduler.Add(m_taskReadForecast, OfflineRetryMs);
+    return;
   }
+  m_timeForReadForecast = millis();
+  if (ReadWeather(WeatherType::Forecast))
+    m_forecastWeatherReady = true;
+  m_scheduler.Add(m_taskReadForecast, m_forecastRefresh.GetNextIntervalMs());
+}
 
-  if (m_timerForReadForecast.IsElapsed())
+void RemoteSensors::ReadCurrentWeather()
+{
+  if (!m_network.ConnectedNoWait())
   {
-    m_timeForReadForecast = current;
-    if (ReadWeather(WeatherType::Forecast))
-      m_forecastWeatherReady = true;
-    else
-      m_timerForReadForecast.Reset(TimerState::Started);
+    m_scheduler.Add(m_taskReadCurrentWeather, OfflineRetryMs);
+    return;
   }
-
-  Print();
+  m_timeForReadCurrentWeather = millis();
+  if (ReadWeather(WeatherType::Current))
+    m_currentWeatherReady = true;
+  m_scheduler.Add(m_taskReadCurrentWeather, m_currentWeatherRefresh.GetNextIntervalMs());
 }
 
 bool RemoteSensors::Print()
 {
+  if (!m_network.ConnectedNoWait())
+    return false;
+
   if (m_forecastWeatherReady)
   {
     m_forecastWeatherReady = false;
@@ -164,6 +184,22 @@ bool ForecastFindDateTime(const JsonObject& root, int linesCount, uint32_t curre
   return found12h && found18h;
 }
     
+uint32_t ForecastNextSlotTime(const JsonObject& root, int linesCount, uint32_t currentDateTime)
+{
+  uint32_t nextSlot = 0;
+  for (int i = 0; i < linesCount; ++i)
+  {
+    auto& line = root[keys::List][i];
+    if (!line)
+      break;
+
+    uint32_t dt = line[keys::Dt];
+    if (dt > currentDateTime && (nextSlot == 0 || dt < nextSlot))
+      nextSlot = dt;
+  }
+  return nextSlot;
+}
+
 void GetForecastJsonParams(const JsonObject& root, int lineNumber, SensorValue& t, SensorValue& clouds, SensorValue& rain, SensorValue& windSpeed, SensorValue& windDirection)
 {
   auto& line = root[keys::List][lineNumber];
@@ -294,47 +330,86 @@ void RemoteSensors::PrintCurrentWeather()
   }
 }
 
+RefreshPolicy& RemoteSensors::GetRefreshPolicy(WeatherType weatherType)
+{
+  return (weatherType == WeatherType::Forecast ? m_forecastRefresh : m_currentWeatherRefresh);
+}
+
 bool RemoteSensors::ReadWeather(WeatherType weatherType)
 {
   bool ok = false;
   HTTPClient http;
+  RefreshPolicy& refresh = GetRefreshPolicy(weatherType);
 
   if (weatherType == WeatherType::Forecast)
     http.begin(ApiOpenWeatherMapOrgHost, 80, String(ApiOpenWeatherMapOrgForecast1) + String(configuration::ApiLocation) + String(ApiOpenWeatherMapOrgForecast2) + String(MyApiAppID));
   else
     http.begin(ApiOpenWeatherMapOrgHost, 80, String(ApiOpenWeatherMapOrgCurrent1) + String(configuration::ApiLocation) + String(ApiOpenWeatherMapOrgCurrent2) + String(MyApiAppID));
 
+  const char* headerKeys[] = {HeaderDate, HeaderETag, HeaderLastModified, HeaderCacheControl};
+  http.collectHeaders(headerKeys, sizeof(headerKeys) / sizeof(headerKeys[0]));
+  if (refresh.GetETag().length() != 0)
+    http.addHeader(HeaderIfNoneMatch, refresh.GetETag());
+  if (refresh.GetLastModified().length() != 0)
+    http.addHeader(HeaderIfModifiedSince, refresh.GetLastModified());
+
+  //HTTP/1.0 has no chunked encoding, so the body can be parsed straight from the socket
+  http.useHTTP10(true);
   int httpCode = http.GET();
 
-  if (httpCode > 0)
+  if (httpCode == HTTP_CODE_NOT_MODIFIED)
   {
-    if (httpCode == HTTP_CODE_OK)
+    refresh.OnNotModified(ParseMaxAge(http.header(HeaderCacheControl)));
+    http.end();
+    return false;
+  }
+
+  if (httpCode == HTTP_CODE_OK)
+  {
+    uint32_t serverTime = ParseHttpDate(http.header(HeaderDate));
+    uint32_t maxAge = ParseMaxAge(http.header(HeaderCacheControl));
+
+    //The forecast repeats the same keys in every line, keep one copy of each
+    JsonInternTable<64> jsonKeys;
+    DynamicJsonBuffer jsonBuffer(4096);
+    jsonBuffer.setInternTable(&jsonKeys);
+    JsonObject& root = jsonBuffer.parseObject(http.getStream());
+    if (root.success())
     {
-      DynamicJsonBuffer jsonBuffer(4096);
-      auto response = http.getString();
-      JsonObject& root = jsonBuffer.parseObject(response);
-      if (root.success())
+      if (weatherType == WeatherType::Forecast)
       {
-        if (weatherType == WeatherType::Forecast)
-        {
-          int line12h = 4;
-          int line18h = 9;
-          if (ForecastFindDateTime(root, root["cnt"], m_currentDateTime, line12h, line18h))
-          {
-            GetForecastJsonParams(root, line12h, forecast12h_T, forecast12h_Clouds, forecast12h_Rain, forecast12h_WindSpeed, forecast12h_WindDirection);
-            GetForecastJsonParams(root, line18h, forecast24h_T, forecast24h_Clouds, forecast24h_Rain, forecast24h_WindSpeed, forecast24h_WindDirection);
-            ok = true;
-          }
-        }
-        else
+        int line12h = 4;
+        int line18h = 9;
+        int linesCount = root["cnt"];
+        if (ForecastFindDateTime(root, linesCount, m_currentDateTime, line12h, line18h))
         {
-          GetCurrentWeatherJsonParams(root, current_Rain, current_WindSpeed, current_WindDirection);
+          GetForecastJsonParams(root, line12h, forecast12h_T, forecast12h_Clouds, forecast12h_Rain, forecast12h_WindSpeed, forecast12h_WindDirection);
+          GetForecastJsonParams(root, line18h, forecast24h_T, forecast24h_Clouds, forecast24h_Rain, forecast24h_WindSpeed, forecast24h_WindDirection);
+          if (!serverTime)
+            serverTime = m_currentDateTime;
+          refresh.OnUpdated(serverTime, ForecastNextSlotTime(root, linesCount, serverTime), maxAge);
           ok = true;
         }
       }
+      else
+      {
+        GetCurrentWeatherJsonParams(root, current_Rain, current_WindSpeed, current_WindDirection);
+        refresh.OnUpdated(serverTime, 0, maxAge);
+        ok = true;
+      }
     }
   }
 
+  if (ok)
+  {
+    refresh.SetETag(http.header(HeaderETag));
+    refresh.SetLastModified(http.header(HeaderLastModified));
+  }
+  else
+  {
+    refresh.OnFailed();
+  }
+
   http.end();
   return ok;
 }
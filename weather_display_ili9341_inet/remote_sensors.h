@@ -1,9 +1,10 @@
 #pragma once
 
 #include "sensor_value.h"
-#include "timer.h"
+#include "scheduler.h"
 #include "network.h"
 #include "chart.h"
+#include "refresh_policy.h"
 
 //https://bblanchon.github.io/ArduinoJson/
 #include <ArduinoJson.h>
@@ -14,10 +15,9 @@ class Configuration;
 class RemoteSensors
 {
 public:
-  RemoteSensors(Display& display);
+  RemoteSensors(Display& display, Network& network, Scheduler& scheduler);
 
   void begin();
-  void loop();
 
 private:
   enum WeatherType
@@ -27,15 +27,20 @@ private:
   };
 
 private:
+  void ReadForecast();
+  void ReadCurrentWeather();
   bool Print();
   void PrintForecastWeather();
   void PrintCurrentWeather();
   bool ReadWeather(WeatherType weatherType);
+  RefreshPolicy& GetRefreshPolicy(WeatherType weatherType);
   void AddToHistory();
   void GetCurrentWeatherJsonParams(const JsonObject& root, SensorValue& rain, SensorValue& windSpeed, SensorValue& windDirection);
 
 private:
   Display& m_display;
+  Network& m_network;
+  Scheduler& m_scheduler;
   SensorValue m_outerTemperature;
   SensorValue m_outerHumidity;
   SensorValue m_outerPressure;
@@ -59,8 +64,12 @@ private:
   bool m_forecastWeatherReady = false;
   bool m_currentWeatherReady = false;
 
-  Timer m_timerForReadForecast;
-  Timer m_timerForReadCurrentWeather;
+  Task m_taskPrint;
+  Task m_taskReadForecast;
+  Task m_taskReadCurrentWeather;
+
+  RefreshPolicy m_forecastRefresh;
+  RefreshPolicy m_currentWeatherRefresh;
   
   uint32_t m_timeForReadForecast = 0;
   uint32_t m_timeForReadCurrentWeather = 0;
@@ -0,0 +1,71 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+
+using SchedulerClock = unsigned long (*)();
+
+class Task
+{
+public:
+  using Callback = std::function<void()>;
+
+  Task(Callback callback, uint32_t periodMs, uint32_t budgetMs = 0);
+
+  uint32_t GetPeriodMs() const { return m_periodMs; }
+  void SetPeriodMs(uint32_t periodMs) { m_periodMs = periodMs; }
+  bool IsScheduled() const { return m_heapIndex != NotScheduled; }
+
+  uint32_t GetRuns() const { return m_runs; }
+  uint32_t GetOverruns() const { return m_overruns; }
+  uint32_t GetMaxJitterMs() const { return m_maxJitterMs; }
+  uint32_t GetMaxDurationMs() const { return m_maxDurationMs; }
+
+private:
+  friend class Scheduler;
+
+  static constexpr size_t NotScheduled = static_cast<size_t>(-1);
+
+  Callback m_callback;
+  uint32_t m_periodMs = 0;
+  uint32_t m_budgetMs = 0;
+  uint32_t m_deadline = 0;
+  size_t m_heapIndex = NotScheduled;
+
+  uint32_t m_runs = 0;
+  uint32_t m_overruns = 0;
+  uint32_t m_maxJitterMs = 0;
+  uint32_t m_maxDurationMs = 0;
+};
+
+class Scheduler
+{
+public:
+  static constexpr size_t MaxTasks = 16;
+
+  explicit Scheduler(SchedulerClock clock);
+
+  bool Add(Task& task, uint32_t delayMs = 0);
+  void Remove(Task& task);
+  void loop();
+
+  uint32_t GetTimeToNextMs() const;
+  uint32_t GetTasksCount() const { return m_size; }
+
+private:
+  static bool IsBefore(uint32_t time1, uint32_t time2) { return static_cast<int32_t>(time1 - time2) < 0; }
+
+  void Push(Task& task);
+  void Erase(size_t index);
+  void SiftUp(size_t index);
+  void SiftDown(size_t index);
+  void Place(Task* task, size_t index);
+  void Run(Task& task, uint32_t now);
+
+private:
+  SchedulerClock m_clock;
+  Task* m_heap[MaxTasks]{};
+  size_t m_size = 0;
+  Task* m_running = nullptr;
+};